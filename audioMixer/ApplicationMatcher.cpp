@@ -0,0 +1,213 @@
+#include "ApplicationMatcher.h"
+#include "StringUtils.h"
+
+#include <algorithm>
+
+namespace {
+	constexpr std::string_view PATH_PREFIX	= "path:";
+	constexpr std::string_view TITLE_PREFIX = "title:";
+
+	bool IsRegex(const std::string_view value) { return value.size() >= 2 && value.front() == '/' && value.back() == '/'; }
+
+	bool HasWildcard(const std::string_view value) { return value.find_first_of("*?") != std::string_view::npos; }
+
+	// Function to find the literal text a regex body anchored with '^' makes every match start with; empty when it is not
+	// anchored, or has an alternative that might not be
+	std::string AnchoredPrefix(const std::string_view body) {
+		if(!body.starts_with('^') || body.find('|') != std::string_view::npos) { return {}; }
+		const size_t end = std::min(body.find_first_of("\\^$.|?*+()[]{}", 1), body.size());
+		std::string	 prefix(body.substr(1, end - 1));
+
+		// A quantifier makes the character before it optional
+		if(end < body.size() && (body[end] == '?' || body[end] == '*' || body[end] == '{') && !prefix.empty()) { prefix.pop_back(); }
+		return ToLowerAscii(prefix);
+	}
+
+	// Function to lower-case a subject (and turn '\' into '/' in paths) the way its patterns were
+	std::string NormalizeText(const std::string_view text, const bool path) {
+		std::string result = ToLowerAscii(text);
+		if(path) { std::ranges::replace(result, '\\', '/'); }
+		return result;
+	}
+
+	// Function to turn the escaped separators ("\\") of a path regex into '/', the separator the paths it runs on have;
+	// other escapes are kept as written
+	std::string NormalizePathRegex(const std::string_view body) {
+		std::string result;
+		result.reserve(body.size());
+		for(size_t i = 0; i < body.size(); ++i) {
+			if(body[i] != '\\' || i + 1 == body.size()) {
+				result += body[i];
+			} else if(body[++i] == '\\') {
+				result += '/';
+			} else {
+				result += '\\';
+				result += body[i];
+			}
+		}
+		return result;
+	}
+} // namespace
+
+std::string ApplicationMatcher::NormalizePattern(const std::string_view pattern) {
+	const bool			   path	 = pattern.starts_with(PATH_PREFIX);
+	const size_t		   start = path ? PATH_PREFIX.size() : pattern.starts_with(TITLE_PREFIX) ? TITLE_PREFIX.size() : 0;
+	const std::string_view value = pattern.substr(start);
+
+	// Case and separators mean something in a regex, so only the field prefix is normalized
+	if(IsRegex(value)) { return ToLowerAscii(pattern.substr(0, start)) + std::string(value); }
+	return ToLowerAscii(pattern.substr(0, start)) + NormalizeText(value, path);
+}
+
+bool ApplicationMatcher::GlobMatches(const std::string_view glob, const std::string_view text) {
+	// Greedy match that backtracks to the last '*' on a mismatch; linear for the globs configs use
+	size_t globPosition = 0;
+	size_t textPosition = 0;
+	size_t starGlob		= std::string_view::npos;
+	size_t starText		= 0;
+	while(textPosition < text.size()) {
+		if(globPosition < glob.size() && (glob[globPosition] == '?' || glob[globPosition] == text[textPosition])) {
+			++globPosition;
+			++textPosition;
+		} else if(globPosition < glob.size() && glob[globPosition] == '*') {
+			starGlob = globPosition++;
+			starText = textPosition;
+		} else if(starGlob != std::string_view::npos) {
+			globPosition = starGlob + 1;
+			textPosition = ++starText;
+		} else {
+			return false;
+		}
+	}
+	while(globPosition < glob.size() && glob[globPosition] == '*') {
+		++globPosition;
+	}
+	return globPosition == glob.size();
+}
+
+bool ApplicationMatcher::AddPattern(const std::string_view pattern, std::string& error) {
+	Field			 field = Field::ProcessName;
+	std::string_view value = pattern;
+	if(pattern.starts_with(PATH_PREFIX)) {
+		field = Field::ProcessPath;
+		value.remove_prefix(PATH_PREFIX.size());
+	} else if(pattern.starts_with(TITLE_PREFIX)) {
+		field = Field::DisplayName;
+		value.remove_prefix(TITLE_PREFIX.size());
+	}
+
+	// The backend finds exact process names without any help
+	if(field == Field::ProcessName && !IsRegex(value) && !HasWildcard(value)) { return true; }
+
+	// The same text twice (two pots on one application) is one pattern
+	const std::string key = NormalizePattern(pattern);
+	if(std::ranges::any_of(patterns, [&key](const Pattern& existing) { return existing.key == key; })) { return true; }
+
+	Pattern compiled;
+	compiled.key   = key;
+	compiled.field = field;
+	if(IsRegex(value)) {
+		try {
+			const std::string_view written = value.substr(1, value.size() - 2);
+			const std::string	   body	   = field == Field::ProcessPath ? NormalizePathRegex(written) : std::string(written);
+			compiled.regex				   = std::make_unique<std::regex>(body, std::regex::ECMAScript | std::regex::icase | std::regex::optimize);
+			compiled.prefix				   = AnchoredPrefix(body);
+		} catch(const std::regex_error& e) {
+			error = e.what();
+			return false;
+		}
+	} else {
+		compiled.glob			  = NormalizeText(value, field == Field::ProcessPath);
+		const size_t lastWildcard = compiled.glob.find_last_of("*?");
+		compiled.prefix			  = compiled.glob.substr(0, compiled.glob.find_first_of("*?"));
+		compiled.suffix			  = lastWildcard == std::string::npos ? std::string() : compiled.glob.substr(lastWildcard + 1);
+	}
+
+	if(field == Field::ProcessPath) { needsProcessPath = true; }
+	patterns.push_back(std::move(compiled));
+	return true;
+}
+
+void ApplicationMatcher::AddToTrie(FieldIndex& index, const uint32_t patternIndex) {
+	const std::string& prefix = patterns[patternIndex].prefix;
+	if(prefix.empty()) {
+		index.unanchored.push_back(patternIndex);
+		return;
+	}
+
+	uint32_t node = 0;
+	for(const char c : prefix) {
+		const auto& children = index.trie[node].children;
+		const auto	child	 = std::ranges::find(children, c, &std::pair<char, uint32_t>::first);
+		if(child != children.end()) {
+			node = child->second;
+		} else {
+			const auto next = static_cast<uint32_t>(index.trie.size());
+			index.trie[node].children.emplace_back(c, next);
+			index.trie.emplace_back();
+			node = next;
+		}
+	}
+	index.trie[node].patterns.push_back(patternIndex);
+}
+
+void ApplicationMatcher::Build() {
+	for(FieldIndex& index : fields) {
+		index = {};
+		index.trie.emplace_back();
+	}
+
+	for(uint32_t patternIndex = 0; patternIndex < patterns.size(); ++patternIndex) {
+		const Pattern& pattern = patterns[patternIndex];
+		FieldIndex&	   index   = fields[static_cast<size_t>(pattern.field)];
+		if(!pattern.regex && !HasWildcard(pattern.glob)) {
+			index.exact[pattern.glob].push_back(patternIndex);
+		} else {
+			AddToTrie(index, patternIndex);
+		}
+	}
+}
+
+void ApplicationMatcher::Clear() {
+	patterns.clear();
+	for(FieldIndex& index : fields) {
+		index = {};
+	}
+	needsProcessPath = false;
+}
+
+bool ApplicationMatcher::PatternMatches(const Pattern& pattern, const std::string_view text) const {
+	if(pattern.regex) { return std::regex_search(text.begin(), text.end(), *pattern.regex); }
+	return text.ends_with(pattern.suffix) && GlobMatches(pattern.glob, text);
+}
+
+void ApplicationMatcher::MatchField(const FieldIndex& index, const std::string_view text, std::vector<uint32_t>& matches) const {
+	if(const auto exact = index.exact.find(std::string(text)); exact != index.exact.end()) {
+		matches.insert(matches.end(), exact->second.begin(), exact->second.end());
+	}
+
+	// Walk the text down the trie; every node on the way holds the patterns whose prefix the text starts with
+	uint32_t node = 0;
+	for(size_t i = 0; !index.trie.empty(); ++i) {
+		for(const uint32_t patternIndex : index.trie[node].patterns) {
+			if(PatternMatches(patterns[patternIndex], text)) { matches.push_back(patternIndex); }
+		}
+		if(i == text.size()) { break; }
+		const auto& children = index.trie[node].children;
+		const auto	child	 = std::ranges::find(children, text[i], &std::pair<char, uint32_t>::first);
+		if(child == children.end()) { break; }
+		node = child->second;
+	}
+
+	for(const uint32_t patternIndex : index.unanchored) {
+		if(PatternMatches(patterns[patternIndex], text)) { matches.push_back(patternIndex); }
+	}
+}
+
+void ApplicationMatcher::Match(const MatchSubject& subject, std::vector<uint32_t>& matches) const {
+	MatchField(fields[static_cast<size_t>(Field::ProcessName)], NormalizeText(subject.processName, false), matches);
+	if(needsProcessPath && !subject.processPath.empty()) {
+		MatchField(fields[static_cast<size_t>(Field::ProcessPath)], NormalizeText(subject.processPath, true), matches);
+	}
+	if(!subject.displayName.empty()) { MatchField(fields[static_cast<size_t>(Field::DisplayName)], NormalizeText(subject.displayName, false), matches); }
+}
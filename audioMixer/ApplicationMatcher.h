@@ -0,0 +1,98 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <regex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// What a session is matched on. The path is only filled in when the matcher has path patterns (NeedsProcessPath).
+struct MatchSubject {
+	std::string_view processName; // e.g. "chrome.exe"
+	std::string_view processPath; // Full executable path
+	std::string_view displayName; // Session display name (WASAPI) or application.name (PulseAudio)
+};
+
+// Application patterns compiled at config load. application_name is one of:
+//   chrome.exe                        an exact process name: not compiled here, the backend indexes sessions by name already
+//   chrome*.exe, app?.exe             a glob on the process name
+//   path:C:\Program Files\Riot*       a glob or exact match on the executable's full path ('\' and '/' are the same)
+//   title:Discord*                    a glob or exact match on the session display name
+//   /^steam(webhelper)?\.exe$/        an ECMAScript regex on the process name; also after "path:" and "title:"
+// In a path regex an escaped separator ("\\") matches either separator too. All of them are case-insensitive. Exact
+// paths and titles are hashed; globs, and regexes anchored with '^', are indexed by their literal prefix in a trie, so
+// a session is only checked against the patterns its own prefix reaches; globs starting with a wildcard are filtered by
+// their literal suffix first and other regexes run on every session. Matching is meant to run once per new session: the
+// backend keeps the result per process and looks targets up by PatternKey().
+class ApplicationMatcher {
+public:
+	// Function to add a pattern; false (with the reason in error) if it is malformed. Exact process names are skipped.
+	bool					 AddPattern(std::string_view pattern, std::string& error);
+
+	// Build the prefix tries; call after the last AddPattern
+	void					 Build();
+
+	void					 Clear();
+
+	bool					 Empty() const { return patterns.empty(); }
+
+	size_t					 PatternCount() const { return patterns.size(); }
+
+	bool					 NeedsProcessPath() const { return needsProcessPath; }
+
+	// Function to append the index of every pattern the subject matches
+	void					 Match(const MatchSubject& subject, std::vector<uint32_t>& matches) const;
+
+	// The key sessions matching a pattern are filed under, the same string NormalizePattern gives for its text
+	const std::string&		 PatternKey(const uint32_t patternIndex) const { return patterns[patternIndex].key; }
+
+	// Function to normalize a target's application_name into the key its sessions are filed under: lower case (regexes
+	// kept as written) with '\' turned into '/' in paths
+	static std::string		 NormalizePattern(std::string_view pattern);
+
+	// Function to match a lower-case glob ('*' any run, '?' any one character) against lower-case text
+	static bool				 GlobMatches(std::string_view glob, std::string_view text);
+
+private:
+	enum class Field : uint8_t {
+		ProcessName,
+		ProcessPath,
+		DisplayName,
+	};
+
+	static constexpr size_t FIELD_COUNT = 3;
+
+	struct Pattern {
+		std::string					key;
+		Field						field = Field::ProcessName;
+		std::string					glob;	// Normalized text without the field prefix; empty for a regex
+		std::string					prefix; // Literal text every match starts with: before a glob's first wildcard, after a regex's '^'
+		std::string					suffix; // Literal text after the last wildcard, checked before an unanchored glob runs
+		std::unique_ptr<std::regex> regex;
+	};
+
+	struct TrieNode {
+		std::vector<std::pair<char, uint32_t>> children; // Next character -> node
+		std::vector<uint32_t>				   patterns; // Patterns whose literal prefix ends here
+	};
+
+	// Everything compiled for one field
+	struct FieldIndex {
+		std::unordered_map<std::string, std::vector<uint32_t>> exact;		// Normalized text -> patterns without wildcards
+		std::vector<TrieNode>								   trie;		// Root first
+		std::vector<uint32_t>								   unanchored;	// Patterns without a literal prefix
+	};
+
+	// Function to file a pattern under its literal prefix, or as unanchored if it has none
+	void					 AddToTrie(FieldIndex& index, uint32_t patternIndex);
+
+	bool					 PatternMatches(const Pattern& pattern, std::string_view text) const;
+
+	void					 MatchField(const FieldIndex& index, std::string_view text, std::vector<uint32_t>& matches) const;
+
+	std::vector<Pattern>	 patterns;
+	FieldIndex				 fields[FIELD_COUNT];
+	bool					 needsProcessPath = false;
+};
@@ -0,0 +1,228 @@
+#include "AudioBackend.h"
+
+#include "Log.h"
+#include "StringUtils.h"
+
+#include <algorithm>
+
+// Function to rebuild the device list; every device's sessions are enumerated again when it is next used
+void AudioBackend::RefreshDevices() {
+	std::vector<AudioDeviceEntry> entries;
+	++deviceEnumerationCount;
+	devices.clear();
+	if(!EnumerateDevices(entries)) {
+		LOG_ERROR("Failed to enumerate audio devices.");
+		devicesDirty = true; // Retry on the next volume change
+		return;
+	}
+
+	devices.reserve(entries.size());
+	for(AudioDeviceEntry& entry : entries) {
+		CachedDevice& device = devices.emplace_back();
+		if(entry.volume) { device.volume.push_back(entry.volume); }
+		device.entry = std::move(entry);
+	}
+}
+
+// Function to rebuild a device's per-application session cache from a single enumeration
+void AudioBackend::RefreshSessions(CachedDevice& device) {
+	std::vector<AudioSessionEntry> sessions;
+	++enumerationCount;
+	device.sessionsByApplication.clear();
+	device.sessionsGeneration = 0;
+	const uint64_t generation = sessionsGeneration;
+	if(!EnumerateSessions(device.entry, sessions)) {
+		LOG_ERROR("Failed to enumerate audio sessions.");
+		return; // Still stale, so retried on the next volume change
+	}
+
+	// Processes that are gone drop out of the match cache with this rebuild
+	std::unordered_map<uint32_t, SessionMatch> previousMatches = std::move(device.matchesByProcess);
+	device.matchesByProcess.clear();
+	for(AudioSessionEntry& entry : sessions) {
+		if(matcher) {
+			for(const uint32_t pattern : MatchSession(entry, previousMatches, device)) {
+				device.sessionsByApplication[matcher->PatternKey(pattern)].push_back(entry.session);
+			}
+		}
+		device.sessionsByApplication[ToLowerAscii(entry.processName)].push_back(std::move(entry.session));
+	}
+	device.sessionsGeneration = generation;
+}
+
+// Function to get the patterns a session matches, only running the matcher for a process it has not seen under this name
+const std::vector<uint32_t>& AudioBackend::MatchSession(const AudioSessionEntry& entry, std::unordered_map<uint32_t, SessionMatch>& previous,
+														CachedDevice& device) {
+	const auto sameSession = [&entry](const SessionMatch& match) { return match.processName == entry.processName && match.displayName == entry.displayName; };
+
+	auto [it, inserted] = device.matchesByProcess.try_emplace(entry.processId);
+	SessionMatch& match = it->second;
+	if(!inserted && sameSession(match)) { return match.patterns; } // Another session of the same process
+	if(inserted) {
+		const auto seen = previous.find(entry.processId);
+		if(seen != previous.end() && sameSession(seen->second)) {
+			match = std::move(seen->second);
+			return match.patterns;
+		}
+	}
+
+	++matchCount;
+	match.processName = entry.processName;
+	match.displayName = entry.displayName;
+	match.patterns.clear();
+	const std::string processPath = matcher->NeedsProcessPath() ? GetProcessPath(entry.processId) : std::string();
+	matcher->Match({entry.processName, processPath, entry.displayName}, match.patterns);
+	return match.patterns;
+}
+
+// Function to find a device by ID, then by friendly name; an empty name is the default output
+AudioBackend::CachedDevice* AudioBackend::FindDevice(const std::string& device) {
+	for(CachedDevice& candidate : devices) {
+		if(device.empty() ? candidate.entry.isDefault : candidate.entry.id == device) { return &candidate; }
+	}
+	for(CachedDevice& candidate : devices) {
+		if(!device.empty() && EqualsIgnoreCaseAscii(candidate.entry.name, device)) { return &candidate; }
+	}
+	return nullptr;
+}
+
+// Function to look up what a target controls, enumerating the device's sessions first if they are stale
+const AudioBackend::SessionList* AudioBackend::FindSessions(const VolumeTarget& target, CachedDevice*& device) {
+	device = FindDevice(target.device);
+	if(!device) {
+		LOG_ERROR("No audio device found for: {}", target.device.empty() ? "default output" : target.device);
+		return nullptr;
+	}
+	if(target.IsEndpoint()) { return &device->volume; }
+
+	if(device->sessionsGeneration != sessionsGeneration) { RefreshSessions(*device); }
+	const auto it = device->sessionsByApplication.find(ApplicationMatcher::NormalizePattern(target.applicationName));
+	if(it == device->sessionsByApplication.end()) {
+		LOG_ERROR("No audio session found for: {}", target.applicationName);
+		return nullptr;
+	}
+	return &it->second;
+}
+
+// Function to mark what a failed call went through stale; called with the lock held
+void AudioBackend::MarkStale(const VolumeTarget& target, CachedDevice& device) {
+	if(target.IsEndpoint()) {
+		// The device most likely went away without us seeing the notification
+		devicesDirty = true;
+	} else {
+		// The session most likely expired without us seeing the notification. The device is only made stale once the
+		// call is done, so the rest of a batch keeps using the sessions it started with.
+		device.sessionsFailed = true;
+	}
+}
+
+// Function to make the devices whose sessions failed during a call stale, so the next call enumerates them; called with the lock held
+void AudioBackend::InvalidateFailedSessions() {
+	for(CachedDevice& device : devices) {
+		if(device.sessionsFailed) {
+			device.sessionsFailed	  = false;
+			device.sessionsGeneration = 0;
+		}
+	}
+}
+
+// Function to set everything a target controls to a volume; called with the lock held
+bool AudioBackend::ApplyVolume(const VolumeTarget& target, float volume) {
+	volume = std::clamp(volume, 0.0f, 1.0f);
+
+	CachedDevice*	   device	= nullptr;
+	const SessionList* sessions = FindSessions(target, device);
+	if(!sessions) { return false; }
+
+	bool volumeSet = false;
+	for(const auto& session : *sessions) {
+		if(session->SetVolume(volume)) {
+			volumeSet = true;
+		} else {
+			MarkStale(target, *device);
+		}
+	}
+
+	const std::string& name = target.IsEndpoint() ? device->entry.name : target.applicationName;
+	if(volumeSet) {
+		LOG_INFO("Set volume for {} to {}%", name, volume * 100);
+	} else {
+		LOG_ERROR("Volume adjustment failed for {}. Process may not have an audio session.", name);
+	}
+	return volumeSet;
+}
+
+void AudioBackend::SetApplicationMatcher(std::shared_ptr<const ApplicationMatcher> newMatcher) {
+	std::lock_guard lock(mutex);
+	matcher = newMatcher && !newMatcher->Empty() ? std::move(newMatcher) : nullptr;
+
+	// Results of the old patterns are meaningless for the new ones; every device is filed again on its next use
+	for(CachedDevice& device : devices) {
+		device.sessionsGeneration = 0;
+		device.matchesByProcess.clear();
+	}
+}
+
+// Function to set a target's volume to a specific value
+bool AudioBackend::SetVolume(const VolumeTarget& target, const float volume) {
+	std::lock_guard lock(mutex);
+	if(devicesDirty.exchange(false)) { RefreshDevices(); }
+	const bool volumeSet = ApplyVolume(target, volume);
+	InvalidateFailedSessions();
+	return volumeSet;
+}
+
+// Function to apply a batch of volumes with one device list check and one lock
+size_t AudioBackend::SetVolumes(const std::span<TargetVolume> updates) {
+	++batchCount;
+	std::lock_guard lock(mutex);
+
+	// A device or session that fails below marks it stale; it is enumerated again for the next batch, not halfway through this one
+	if(devicesDirty.exchange(false)) { RefreshDevices(); }
+
+	size_t appliedCount = 0;
+	for(TargetVolume& update : updates) {
+		update.applied = ApplyVolume(*update.target, update.volume);
+		if(update.applied) { ++appliedCount; }
+	}
+	InvalidateFailedSessions();
+	return appliedCount;
+}
+
+// Function to adjust a target's volume by delta
+bool AudioBackend::AdjustVolume(const VolumeTarget& target, const float delta, float* resultVolume) {
+	std::lock_guard lock(mutex);
+	if(devicesDirty.exchange(false)) { RefreshDevices(); }
+
+	CachedDevice*	   device	= nullptr;
+	const SessionList* sessions = FindSessions(target, device);
+	if(!sessions) { return false; }
+
+	const std::string& name			  = target.IsEndpoint() ? device->entry.name : target.applicationName;
+	bool			   volumeAdjusted = false;
+	for(const auto& session : *sessions) {
+		float currentVolume = 0.0f;
+		if(!session->GetVolume(currentVolume)) {
+			MarkStale(target, *device);
+			continue;
+		}
+
+		const float newVolume = std::clamp(currentVolume + delta, 0.0f, 1.0f);
+		if(resultVolume) {
+			*resultVolume = newVolume;
+			resultVolume  = nullptr;
+		}
+		if(newVolume == currentVolume) { continue; }
+
+		if(session->SetVolume(newVolume)) {
+			LOG_INFO("Adjusted volume for {} to {}%", name, newVolume * 100);
+			volumeAdjusted = true;
+		} else {
+			MarkStale(target, *device);
+		}
+	}
+
+	InvalidateFailedSessions();
+	if(!volumeAdjusted) { LOG_ERROR("Volume adjustment failed for {}. Process may not have an audio session.", name); }
+	return volumeAdjusted;
+}
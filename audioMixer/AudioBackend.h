@@ -0,0 +1,142 @@
+#pragma once
+
+#include "ApplicationMatcher.h"
+#include "VolumeTarget.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// A single controllable volume: an audio session (one ISimpleAudioVolume on Windows) or a device's own volume (one
+// IAudioEndpointVolume)
+class AudioSession {
+public:
+	virtual ~AudioSession() = default;
+
+	virtual bool GetVolume(float& volume) = 0;
+	virtual bool SetVolume(float volume)  = 0;
+};
+
+// Session handle together with the executable name of the process that owns it
+struct AudioSessionEntry {
+	std::string					  processName;
+	uint32_t					  processId = 0;
+	std::shared_ptr<AudioSession> session;
+	std::string					  displayName; // Empty if the session has none; only used by title patterns
+};
+
+enum class AudioDeviceFlow : uint8_t {
+	Render,
+	Capture,
+};
+
+// An active audio device together with the handle of its own volume
+struct AudioDeviceEntry {
+	std::string					  id;				 // Stable endpoint ID
+	std::string					  name;				 // Friendly name, e.g. "Headphones (USB Audio)"
+	AudioDeviceFlow				  flow		= AudioDeviceFlow::Render;
+	bool						  isDefault	= false; // The default output, which targets without a device refer to
+	std::shared_ptr<AudioSession> volume;			 // nullptr if the device has no volume control
+};
+
+// One target's share of a batched volume change; applied is filled in by SetVolumes
+struct TargetVolume {
+	const VolumeTarget*	target	= nullptr;
+	float				volume	= 0.0f;
+	bool				applied	= false; // At least one of the target's sessions took the volume
+};
+
+// Platform-neutral audio backend. The device list and each device's sessions are enumerated once and cached; a device's
+// sessions are only enumerated again after InvalidateSessions() (session created/expired) and the device list after
+// InvalidateDevices() (device added/removed/default changed), so a volume change is one call per session.
+class AudioBackend {
+public:
+	virtual ~AudioBackend() = default;
+
+	// Prepare/release per-thread state (COM on Windows) for a thread that will make volume calls
+	virtual void AttachCurrentThread() {}
+
+	virtual void DetachCurrentThread() {}
+
+	bool		 SetVolume(const VolumeTarget& target, float volume);
+
+	// Set the volumes of several targets (typically every pot of one frame) in one pass: the device list is checked, and
+	// enumerated again if stale, once for the whole batch, and every update is applied under one lock. Returns the number
+	// of updates applied.
+	size_t		 SetVolumes(std::span<TargetVolume> updates);
+
+	// resultVolume, if given, receives the new volume of the target's first session
+	bool		 AdjustVolume(const VolumeTarget& target, float delta, float* resultVolume = nullptr);
+
+	// Use a config's compiled application patterns (nullptr for exact names only). Sessions are filed under every pattern
+	// they match; the result is kept per process, so a pattern runs once per session and not on every volume change.
+	void		 SetApplicationMatcher(std::shared_ptr<const ApplicationMatcher> newMatcher);
+
+	// Mark the cached sessions / devices stale. Safe to call from any thread, including notification callbacks.
+	void		 InvalidateSessions() { ++sessionsGeneration; }
+
+	void		 InvalidateDevices() { devicesDirty = true; }
+
+	uint64_t	 EnumerationCount() const { return enumerationCount; }
+
+	uint64_t	 DeviceEnumerationCount() const { return deviceEnumerationCount; }
+
+	uint64_t	 BatchCount() const { return batchCount; }
+
+	// Sessions run through the application patterns (cache misses)
+	uint64_t	 MatchCount() const { return matchCount; }
+
+protected:
+	// Enumerate every active render and capture device
+	virtual bool EnumerateDevices(std::vector<AudioDeviceEntry>& devices) = 0;
+
+	// Enumerate every live session on a device
+	virtual bool EnumerateSessions(const AudioDeviceEntry& device, std::vector<AudioSessionEntry>& sessions) = 0;
+
+	// Full executable path of a process, for path patterns; only asked for on a session the patterns have not seen
+	virtual std::string GetProcessPath(uint32_t) { return {}; }
+
+private:
+	using SessionList = std::vector<std::shared_ptr<AudioSession>>;
+
+	// The patterns a process's sessions matched, valid while its name and display name stay the same
+	struct SessionMatch {
+		std::string			  processName;
+		std::string			  displayName;
+		std::vector<uint32_t> patterns;
+	};
+
+	struct CachedDevice {
+		AudioDeviceEntry							 entry;
+		SessionList									 volume;					 // The device's own volume, as a list of one
+		uint64_t									 sessionsGeneration = 0;	 // Generation the sessions were enumerated at, 0 if stale
+		bool										 sessionsFailed		= false; // A session call failed; made stale once the call finishes
+		std::unordered_map<std::string, SessionList> sessionsByApplication;		 // Keyed by lower-cased exe name and by pattern key
+		std::unordered_map<uint32_t, SessionMatch>	 matchesByProcess;			 // By PID
+	};
+
+	void						 RefreshDevices();
+	void						 RefreshSessions(CachedDevice& device);
+	const std::vector<uint32_t>& MatchSession(const AudioSessionEntry& entry, std::unordered_map<uint32_t, SessionMatch>& previous, CachedDevice& device);
+	CachedDevice*				 FindDevice(const std::string& device);
+	const SessionList*			 FindSessions(const VolumeTarget& target, CachedDevice*& device);
+	bool						 ApplyVolume(const VolumeTarget& target, float volume);
+	void						 MarkStale(const VolumeTarget& target, CachedDevice& device);
+	void						 InvalidateFailedSessions();
+
+	std::mutex								  mutex;
+	std::atomic<bool>						  devicesDirty			 = true;
+	std::atomic<uint64_t>					  sessionsGeneration	 = 1;
+	std::atomic<uint64_t>					  enumerationCount		 = 0;
+	std::atomic<uint64_t>					  deviceEnumerationCount = 0;
+	std::atomic<uint64_t>					  batchCount			 = 0;
+	std::atomic<uint64_t>					  matchCount			 = 0;
+	std::vector<CachedDevice>				  devices; // Guarded by mutex
+	std::shared_ptr<const ApplicationMatcher> matcher; // Guarded by mutex
+};
@@ -0,0 +1,89 @@
+#include "AudioWorker.h"
+
+void AudioWorker::Start() {
+	if(running.exchange(true)) { return; }
+	thread = std::thread(&AudioWorker::Run, this);
+}
+
+void AudioWorker::Stop() {
+	if(!running.exchange(false)) { return; }
+	wakeSignal.release();
+	if(thread.joinable()) { thread.join(); }
+}
+
+bool AudioWorker::Submit(const VolumeCommand& command) {
+	if(!queue.TryPush(command)) {
+		droppedCount.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+	wakeSignal.release();
+	return true;
+}
+
+size_t AudioWorker::Submit(const std::span<const VolumeCommand> commands) {
+	size_t queued = 0;
+	for(const VolumeCommand& command : commands) {
+		if(queue.TryPush(command)) {
+			++queued;
+		} else {
+			droppedCount.fetch_add(1, std::memory_order_relaxed);
+		}
+	}
+	if(queued > 0) { wakeSignal.release(); }
+	return queued;
+}
+
+// Function to apply the collected batch, timing the backend calls for the commands that carry timestamps
+void AudioWorker::ApplyBatch() {
+	if(batch.empty()) { return; }
+
+	const auto started = std::chrono::steady_clock::now();
+	apply(batch);
+	if(latency) {
+		const auto finished = std::chrono::steady_clock::now();
+		for(const VolumeCommand& command : batch) {
+			latency->RecordApplied(command, started, finished);
+		}
+	}
+	batch.clear();
+}
+
+// Function to start the scheduler over for a new config before the commands queued for it are taken in, so an update
+// pending for an application index is never applied to whatever the new config has at that index
+void AudioWorker::UpdateConfig() {
+	const ConfigInfo current = liveConfig();
+	if(current.generation == configGeneration) { return; }
+	configGeneration = current.generation;
+	scheduler.Reset(current.applicationCount);
+}
+
+void AudioWorker::Run() {
+	backend.AttachCurrentThread();
+
+	VolumeCommand command;
+	while(running) {
+		UpdateConfig();
+		while(queue.TryPop(command)) {
+			scheduler.Submit(command);
+		}
+
+		// Sleep until another command arrives or the next rate-limited update is due
+		const VolumeScheduler::TimePoint nextDue = scheduler.ApplyDue(std::chrono::steady_clock::now(), collect);
+		ApplyBatch();
+		if(nextDue == VolumeScheduler::TimePoint::max()) {
+			wakeSignal.acquire();
+		} else {
+			(void)wakeSignal.try_acquire_until(nextDue);
+		}
+	}
+
+	// Apply what was queued before Stop() without waiting for the rate limit
+	UpdateConfig();
+	while(queue.TryPop(command)) {
+		scheduler.Submit(command);
+	}
+	scheduler.Flush(collect);
+	ApplyBatch();
+
+	backend.DetachCurrentThread();
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "AudioBackend.h"
+#include "MpscQueue.h"
+#include "PipelineLatency.h"
+#include "VolumeCommand.h"
+#include "VolumeScheduler.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <semaphore>
+#include <span>
+#include <thread>
+#include <vector>
+
+// Dedicated thread that drains queued volume commands and applies them through the backend, so callers such as the
+// low-level keyboard hook only pay for an enqueue. Being the only thread that applies volumes, it also orders pot and
+// hotkey changes, and its scheduler coalesces them to at most one backend call per application per interval. Every
+// command that falls due in one wakeup (all the pots of a frame) is handed to apply as one batch. The scheduler only
+// keeps slots for the applications of the live config, and starts over when a new config is published.
+class AudioWorker {
+public:
+	static constexpr size_t QUEUE_CAPACITY = 1024;
+
+	// What the worker needs to know of the live config
+	struct ConfigInfo {
+		uint64_t generation		  = 0;
+		size_t	 applicationCount = 0;
+	};
+
+	using ApplyFunction	 = std::function<void(std::span<const VolumeCommand>)>;
+	using ConfigFunction = std::function<ConfigInfo()>;
+
+	// liveConfig is asked on every wakeup, from the worker thread. latency, if given, receives the queue and backend-call
+	// timings of timed commands.
+	AudioWorker(AudioBackend& backend, ApplyFunction apply, ConfigFunction liveConfig, const std::chrono::nanoseconds minInterval,
+				PipelineLatency* latency = nullptr)
+		: backend(backend)
+		, apply(std::move(apply))
+		, liveConfig(std::move(liveConfig))
+		, collect([this](const VolumeCommand& command) { batch.push_back(command); })
+		, scheduler(minInterval)
+		, latency(latency) {}
+
+	~AudioWorker() { Stop(); }
+
+	void				 Start();
+
+	// Stop the thread after applying everything already queued
+	void				 Stop();
+
+	// Queue a command without blocking; returns false (and counts a drop) when the queue is full
+	bool				 Submit(const VolumeCommand& command);
+
+	// Queue several commands with a single wakeup, so the worker sees them together; returns how many were queued
+	size_t				 Submit(std::span<const VolumeCommand> commands);
+
+	uint64_t			 DroppedCount() const { return droppedCount; }
+
+	VolumeSchedulerStats SchedulerStats() const { return scheduler.Stats(); }
+
+private:
+	void									 Run();
+	void									 ApplyBatch();
+	void									 UpdateConfig();
+
+	AudioBackend&							 backend;
+	ApplyFunction							 apply;
+	ConfigFunction							 liveConfig;
+	VolumeScheduler::ApplyFunction			 collect;	// Adds a command the scheduler releases to batch
+	VolumeScheduler							 scheduler; // Only touched by the worker thread
+	std::vector<VolumeCommand>				 batch;		// Commands due in the current wakeup
+	PipelineLatency*						 latency;
+	MpscQueue<VolumeCommand, QUEUE_CAPACITY> queue;
+	std::counting_semaphore<>				 wakeSignal{0};
+	std::atomic<bool>						 running		  = false;
+	std::atomic<uint64_t>					 droppedCount	  = 0;
+	uint64_t								 configGeneration = 0; // Config the scheduler's slots belong to; worker thread only
+	std::thread								 thread;
+};
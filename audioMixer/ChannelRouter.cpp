@@ -0,0 +1,29 @@
+#include "ChannelRouter.h"
+
+#include <algorithm>
+
+void ChannelRouter::Build(const std::span<const int> targetChannels, const size_t minChannelCount) {
+	size_t channelCount = minChannelCount;
+	for(const int channel : targetChannels) {
+		if(channel >= 0) { channelCount = std::max(channelCount, static_cast<size_t>(channel) + 1); }
+	}
+
+	// Counting sort of targets by channel
+	offsets.assign(channelCount + 1, 0);
+	for(const int channel : targetChannels) {
+		if(channel >= 0) { ++offsets[channel + 1]; }
+	}
+	for(size_t channel = 0; channel < channelCount; ++channel) {
+		offsets[channel + 1] += offsets[channel];
+	}
+
+	targets.assign(offsets[channelCount], 0);
+	std::vector<uint32_t> next(offsets.begin(), offsets.end() - 1);
+	for(size_t target = 0; target < targetChannels.size(); ++target) {
+		if(targetChannels[target] >= 0) { targets[next[targetChannels[target]]++] = static_cast<uint16_t>(target); }
+	}
+
+	lastValues.assign(channelCount, NO_VALUE);
+}
+
+void ChannelRouter::Reset() { std::ranges::fill(lastValues, NO_VALUE); }
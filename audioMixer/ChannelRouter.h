@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// Routing table from pot channel to the targets (application indices) it drives. Targets of a channel are stored
+// contiguously, so routing a channel update is an index lookup plus a walk over exactly the bound targets.
+// The router also remembers each channel's last value and skips channels that did not move.
+class ChannelRouter {
+public:
+	// targetChannels[i] is the channel driving target i, or -1 if it is not bound to a pot. The channel count is the
+	// larger of minChannelCount (from config or frame header) and the highest bound channel + 1.
+	void					  Build(std::span<const int> targetChannels, size_t minChannelCount = 0);
+
+	size_t					  ChannelCount() const { return lastValues.size(); }
+
+	std::span<const uint16_t> Targets(const size_t channel) const {
+		if(channel >= ChannelCount()) { return {}; }
+		return std::span<const uint16_t>(targets.data() + offsets[channel], offsets[channel + 1] - offsets[channel]);
+	}
+
+	// Call onTarget(targetIndex, value) for every target of the channel, unless the value is the one last routed.
+	// Returns whether the channel moved.
+	template <typename Callback> bool Route(const size_t channel, const uint16_t value, Callback&& onTarget) {
+		if(channel >= ChannelCount() || lastValues[channel] == value) { return false; }
+		lastValues[channel] = value;
+		for(const uint16_t target : Targets(channel)) {
+			onTarget(target, value);
+		}
+		return true;
+	}
+
+	// Forget the last routed values so the next update of every channel is applied again
+	void Reset();
+
+private:
+	static constexpr int32_t NO_VALUE = -1;
+
+	std::vector<uint32_t> offsets; // Targets of channel c are targets[offsets[c]..offsets[c + 1])
+	std::vector<uint16_t> targets;
+	std::vector<int32_t>  lastValues;
+};
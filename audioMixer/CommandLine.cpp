@@ -0,0 +1,83 @@
+#include "CommandLine.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <utility>
+
+namespace {
+	void PrintUsage(const char* program) {
+		std::cerr << "Usage: " << program << " [config path] [--record <file>] [--replay <file> [--speed N|max]] [--latency <file>] [--log-file <file>]"
+				  << " [--log-level debug|info|warning|error]" << std::endl;
+	}
+
+	// Function to parse a log level name
+	bool ParseLogLevel(const char* text, LogLevel& level) {
+		constexpr std::pair<const char*, LogLevel> LEVELS[] = {
+			{"debug", LogLevel::Debug},
+			{"info", LogLevel::Info},
+			{"warning", LogLevel::Warning},
+			{"error", LogLevel::Error},
+		};
+		for(const auto& [name, value] : LEVELS) {
+			if(std::strcmp(text, name) == 0) {
+				level = value;
+				return true;
+			}
+		}
+		return false;
+	}
+
+	// Function to parse a replay speed: a positive multiplier or "max"
+	bool ParseSpeed(const char* text, double& speed) {
+		if(std::strcmp(text, "max") == 0) {
+			speed = 0.0;
+			return true;
+		}
+		char* end = nullptr;
+		speed	  = std::strtod(text, &end);
+		return end != text && *end == '\0' && speed > 0.0;
+	}
+} // namespace
+
+// Function to parse the command line
+bool ParseCommandLine(const int argc, const char* const* argv, CommandLineOptions& options) {
+	const char* program = argc > 0 ? argv[0] : "audioMixer";
+	for(int i = 1; i < argc; ++i) {
+		const char* argument = argv[i];
+		const bool	hasValue = i + 1 < argc;
+		if(std::strcmp(argument, "--record") == 0 && hasValue) {
+			options.recordPath = argv[++i];
+		} else if(std::strcmp(argument, "--replay") == 0 && hasValue) {
+			options.replayPath = argv[++i];
+		} else if(std::strcmp(argument, "--speed") == 0 && hasValue) {
+			if(!ParseSpeed(argv[++i], options.replaySpeed)) {
+				std::cerr << "Invalid replay speed: " << argv[i] << std::endl;
+				PrintUsage(program);
+				return false;
+			}
+		} else if(std::strcmp(argument, "--latency") == 0 && hasValue) {
+			options.latencyPath = argv[++i];
+		} else if(std::strcmp(argument, "--log-file") == 0 && hasValue) {
+			options.log.filePath = argv[++i];
+		} else if(std::strcmp(argument, "--log-level") == 0 && hasValue) {
+			if(!ParseLogLevel(argv[++i], options.log.level)) {
+				std::cerr << "Invalid log level: " << argv[i] << std::endl;
+				PrintUsage(program);
+				return false;
+			}
+		} else if(argument[0] != '-' && options.configPath.empty()) {
+			options.configPath = argument;
+		} else {
+			std::cerr << "Unknown argument: " << argument << std::endl;
+			PrintUsage(program);
+			return false;
+		}
+	}
+
+	if(!options.recordPath.empty() && !options.replayPath.empty()) {
+		std::cerr << "--record and --replay cannot be combined." << std::endl;
+		return false;
+	}
+	return true;
+}
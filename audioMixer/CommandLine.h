@@ -0,0 +1,19 @@
+#pragma once
+
+#include "Log.h"
+
+#include <string>
+
+// Options shared by audioMixer and audioMixerReplay
+struct CommandLineOptions {
+	std::string configPath;		   // First positional argument; empty if not given
+	std::string recordPath;		   // --record <file>: also write the serial stream to this log
+	std::string replayPath;		   // --replay <file>: read the serial stream from this log instead of the port
+	double		replaySpeed = 1.0; // --speed N|max: replay pace relative to the recording, 0 for "max" (as fast as possible)
+	std::string latencyPath;	   // --latency <file>: write the pot latency histograms here on exit
+	LogOptions	log;			   // --log-file <file>, --log-level debug|info|warning|error
+};
+
+// Function to parse "[config path] [--record <file>] [--replay <file> [--speed N|max]] [--latency <file>] [--log-file <file>]
+// [--log-level <level>]"; prints the usage and returns false on an unknown or malformed argument
+bool ParseCommandLine(int argc, const char* const* argv, CommandLineOptions& options);
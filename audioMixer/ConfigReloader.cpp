@@ -0,0 +1,50 @@
+#include "ConfigReloader.h"
+#include "Log.h"
+
+namespace {
+	constexpr int WAIT_TIMEOUT_MS = 100; // Upper bound on how long shutdown waits for the watcher
+} // namespace
+
+bool ConfigReloader::Start() {
+	if(running) { return true; }
+	watcher = WatchFile(configFile);
+	if(!watcher) { return false; }
+
+	running = true;
+	thread	= std::thread(&ConfigReloader::Run, this);
+	return true;
+}
+
+void ConfigReloader::Stop() {
+	if(!running.exchange(false)) { return; }
+	if(thread.joinable()) { thread.join(); }
+	watcher.reset();
+}
+
+void ConfigReloader::Run() {
+	while(running) {
+		const FileWatcher::WaitResult result = watcher->WaitForChange(WAIT_TIMEOUT_MS);
+		if(result == FileWatcher::WaitResult::Timeout) { continue; }
+		if(result == FileWatcher::WaitResult::Error) {
+			LOG_ERROR("Error watching config file, hot reload disabled.");
+			break;
+		}
+
+		const auto changedAt = std::chrono::steady_clock::now();
+		while(running && watcher->WaitForChange(DEBOUNCE_MS) == FileWatcher::WaitResult::Changed) {}
+
+		std::unique_ptr<MixerConfig> config = LoadConfig(configFile);
+		if(!config) {
+			LOG_ERROR("Config reload failed, keeping the current config.");
+			continue;
+		}
+
+		const size_t applicationCount = config->applications.size();
+		publish(std::move(config));
+
+		const auto latency	= std::chrono::steady_clock::now() - changedAt;
+		lastReloadLatencyNs = std::chrono::duration_cast<std::chrono::nanoseconds>(latency).count();
+		++reloadCount;
+		LOG_INFO("Config reloaded: {} applications in {}us", applicationCount, std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+	}
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "FileWatcher.h"
+#include "MixerConfig.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+
+// Watches the config file on its own thread and, after each edit, reads and compiles a new MixerConfig and hands it to
+// the publish function. Parsing never happens on the keyboard hook or serial threads, and a config that fails to load
+// leaves the current one in place.
+class ConfigReloader {
+public:
+	using PublishFunction = std::function<void(std::unique_ptr<MixerConfig> config)>;
+
+	static constexpr int DEBOUNCE_MS = 50; // Editors often write a file in several steps; wait until it has been quiet this long
+
+	ConfigReloader(std::string configFile, PublishFunction publish) : configFile(std::move(configFile)), publish(std::move(publish)) {}
+
+	~ConfigReloader() { Stop(); }
+
+	// Returns false if the file cannot be watched
+	bool					 Start();
+	void					 Stop();
+
+	uint64_t				 ReloadCount() const { return reloadCount; }
+
+	// Time from the first change notification to the new config being published, for the last successful reload
+	std::chrono::nanoseconds LastReloadLatency() const { return std::chrono::nanoseconds(lastReloadLatencyNs.load()); }
+
+private:
+	void						 Run();
+
+	std::string					 configFile;
+	PublishFunction				 publish;
+	std::unique_ptr<FileWatcher> watcher;
+	std::atomic<bool>			 running			 = false;
+	std::atomic<uint64_t>		 reloadCount		 = 0;
+	std::atomic<int64_t>		 lastReloadLatencyNs = 0;
+	std::thread					 thread;
+};
@@ -0,0 +1,81 @@
+// Message format between the host and local control clients (the Electron frontend), carried over LocalConnection.
+//
+// Every message starts with a 4-byte header: type u8, payload size u24 little-endian. All fields are little-endian.
+//
+// Client -> host:
+//   SUBSCRIBE   version u8                              - start streaming; the host answers with a snapshot
+//   SET_VOLUME  application u16, volume u16             - set an application's volume (0 to VOLUME_SCALE)
+//
+// Host -> client:
+//   SNAPSHOT    version u8, config generation u32, channel count u16, application count u16,
+//               value u16[channel count]                - last pot value per global channel, NO_VALUE if not moved yet
+//               { channel u16, volume u16, name length u8, name }[application count]
+//                                                       - channel the application is bound to (NO_VALUE if none), last
+//                                                         applied volume (NO_VALUE if unknown), executable name
+//   DELTA       channel entries u16, volume entries u16,
+//               { index u16, value u16 }[channel entries + volume entries]
+//                                                       - channels first, then volumes; only what changed since the
+//                                                         last message, with its latest value
+//   REFUSED     request type u8, reason u8              - a request was not carried out (see RefusedReason); the
+//                                                         connection stays open
+//
+// A snapshot is sent after SUBSCRIBE and again whenever the config is reloaded, since application indices change meaning.
+// A message the host cannot parse closes the connection.
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ControlProtocol {
+	constexpr uint8_t  VERSION			= 1;
+
+	constexpr size_t   HEADER_SIZE		= 4;
+	constexpr size_t   SET_VOLUME_SIZE	= 4;
+	constexpr size_t   DELTA_ENTRY_SIZE = 4;
+	constexpr size_t   MAX_NAME_LENGTH	= 255;
+	constexpr size_t   MAX_INPUT_SIZE	= 64; // Client messages are tiny; anything larger is a protocol error
+
+	constexpr uint16_t NO_VALUE			= 0xFFFF;
+	constexpr uint16_t VOLUME_SCALE		= 10000;
+
+	enum MessageType : uint8_t {
+		SUBSCRIBE  = 0x01,
+		SET_VOLUME = 0x02,
+		SNAPSHOT   = 0x81,
+		DELTA	   = 0x82,
+		REFUSED	   = 0x83,
+	};
+
+	enum RefusedReason : uint8_t {
+		UNKNOWN_APPLICATION = 0x01, // Past the application count of the current config, e.g. sent before a reload's snapshot
+	};
+
+	// Function to append a little-endian integer
+	template <typename T> void Put(std::vector<uint8_t>& out, const T value) {
+		for(size_t i = 0; i < sizeof(T); ++i) {
+			out.push_back(static_cast<uint8_t>(value >> (8 * i)));
+		}
+	}
+
+	// Function to read a little-endian uint16
+	inline uint16_t GetU16(const uint8_t* data) { return static_cast<uint16_t>(data[0] | (data[1] << 8)); }
+
+	// Function to start a message; returns the offset to pass to EndMessage once the payload is appended
+	inline size_t BeginMessage(std::vector<uint8_t>& out, const MessageType type) {
+		const size_t start = out.size();
+		out.insert(out.end(), {type, 0, 0, 0});
+		return start;
+	}
+
+	// Function to fill in the payload size of the message started at start
+	inline void EndMessage(std::vector<uint8_t>& out, const size_t start) {
+		const size_t size = out.size() - start - HEADER_SIZE;
+		out[start + 1]	  = static_cast<uint8_t>(size);
+		out[start + 2]	  = static_cast<uint8_t>(size >> 8);
+		out[start + 3]	  = static_cast<uint8_t>(size >> 16);
+	}
+
+	// Function to read a header; returns the payload size
+	inline size_t PayloadSize(const uint8_t* header) { return header[1] | (header[2] << 8) | (static_cast<size_t>(header[3]) << 16); }
+} // namespace ControlProtocol
@@ -0,0 +1,245 @@
+#include "ControlServer.h"
+#include "ControlProtocol.h"
+#include "Log.h"
+
+#include <algorithm>
+
+bool ControlServer::Start() {
+	listener = ListenLocal(endpoint);
+	if(!listener) { return false; }
+	running = true;
+	thread	= std::thread(&ControlServer::Run, this);
+	return true;
+}
+
+void ControlServer::Stop() {
+	running = false;
+	if(listener) { listener->Wake(); }
+	if(thread.joinable()) { thread.join(); }
+	clients.clear();
+	listener.reset();
+	clientCount = 0;
+}
+
+void ControlServer::Run() {
+	std::vector<LocalConnection*> connections;
+	Clock::time_point			  nextUpdate = Clock::now();
+
+	while(running) {
+		connections.clear();
+		for(const Client& client : clients) {
+			connections.push_back(client.connection.get());
+		}
+
+		// Without a subscriber there is nothing to send, so an idle host sleeps until a client connects or writes
+		const bool idle	   = std::ranges::none_of(clients, [](const Client& client) { return client.subscribed || !client.output.empty(); });
+		const auto timeout = std::chrono::duration_cast<std::chrono::milliseconds>(nextUpdate - Clock::now());
+		listener->Wait(connections, idle ? -1 : static_cast<int>(std::max<int64_t>(timeout.count(), 0)));
+
+		while(auto connection = listener->Accept()) {
+			clients.emplace_back().connection = std::move(connection);
+			LOG_INFO("Control client connected.");
+		}
+
+		for(Client& client : clients) {
+			ReadInput(client);
+		}
+
+		// Deltas go out once per interval, so a fast-moving pot costs one message per client per interval. A new
+		// subscriber's snapshot is taken after collecting, so the changes made while nobody listened are not sent again.
+		const bool snapshotDue = std::ranges::any_of(clients, &Client::needsSnapshot);
+		if(snapshotDue || Clock::now() >= nextUpdate) {
+			CollectChanges();
+			nextUpdate = std::max(nextUpdate + updateInterval, Clock::now());
+		}
+
+		// A snapshot is sent as soon as it is due; Flush also continues messages a client did not take at once
+		for(Client& client : clients) {
+			Flush(client);
+		}
+
+		const size_t previousCount = clients.size();
+		std::erase_if(clients, [](const Client& client) { return client.closed; });
+		if(clients.size() != previousCount) { LOG_INFO("Control client disconnected."); }
+		clientCount = clients.size();
+	}
+}
+
+void ControlServer::ReadInput(Client& client) {
+	uint8_t buffer[256];
+	for(int bytesRead; !client.closed && (bytesRead = client.connection->Read(buffer, sizeof(buffer))) != 0;) {
+		if(bytesRead < 0) {
+			client.closed = true;
+			return;
+		}
+		client.input.insert(client.input.end(), buffer, buffer + bytesRead);
+
+		// Handle every complete message; a partial one stays buffered for the next read
+		size_t offset = 0;
+		while(client.input.size() - offset >= ControlProtocol::HEADER_SIZE) {
+			const uint8_t* header = client.input.data() + offset;
+			const size_t   size	  = ControlProtocol::PayloadSize(header);
+			if(size > ControlProtocol::MAX_INPUT_SIZE) {
+				LOG_ERROR("Error: Control client sent an oversized message.");
+				client.closed = true;
+				return;
+			}
+			if(client.input.size() - offset < ControlProtocol::HEADER_SIZE + size) { break; }
+			if(!HandleMessage(client, header[0], header + ControlProtocol::HEADER_SIZE, size)) {
+				client.closed = true;
+				return;
+			}
+			offset += ControlProtocol::HEADER_SIZE + size;
+		}
+		client.input.erase(client.input.begin(), client.input.begin() + offset);
+	}
+}
+
+bool ControlServer::HandleMessage(Client& client, const uint8_t type, const uint8_t* payload, const size_t size) {
+	switch(type) {
+		case ControlProtocol::SUBSCRIBE:
+			if(size < 1 || payload[0] != ControlProtocol::VERSION) {
+				LOG_ERROR("Error: Control client asked for an unsupported protocol version.");
+				return false;
+			}
+			client.subscribed	 = true;
+			client.needsSnapshot = true;
+			return true;
+
+		case ControlProtocol::SET_VOLUME: {
+			if(size != ControlProtocol::SET_VOLUME_SIZE) { break; }
+			const uint16_t applicationIndex = ControlProtocol::GetU16(payload);
+			const uint16_t volume			= std::min(ControlProtocol::GetU16(payload + 2), ControlProtocol::VOLUME_SCALE);
+
+			// A client may not have seen a reload's snapshot yet, so an unknown index is refused without closing the connection
+			const auto liveConfig = mixer.ReadLiveConfig(MixerController::CONFIG_READER_CONTROL);
+			if(!liveConfig || applicationIndex >= liveConfig->applications.size()) {
+				LOG_WARNING("Control client set the volume of unknown application {}.", applicationIndex);
+				EncodeRefused(client, type, ControlProtocol::UNKNOWN_APPLICATION);
+				return true;
+			}
+
+			// A full queue drops the change like a pot update
+			mixer.SubmitVolume(applicationIndex, static_cast<float>(volume) / ControlProtocol::VOLUME_SCALE);
+			return true;
+		}
+
+		default: break;
+	}
+	LOG_ERROR("Error: Control client sent an invalid message (type {}).", type);
+	return false;
+}
+
+void ControlServer::CollectChanges() {
+	MixerState& state = mixer.State();
+
+	// Application indices change meaning with the config, so every client starts over from a snapshot
+	const uint64_t generation = state.ConfigGeneration();
+	if(generation != configGeneration) {
+		configGeneration = generation;
+		for(Client& client : clients) {
+			client.needsSnapshot = client.subscribed;
+		}
+	}
+
+	// Clients that are not subscribed yet get everything in their snapshot
+	std::bitset<MixerState::MAX_CHANNELS>	  changedChannels;
+	std::bitset<MixerState::MAX_APPLICATIONS> changedVolumes;
+	state.CollectChannels([&](const size_t channel) { changedChannels.set(channel); });
+	state.CollectVolumes([&](const size_t applicationIndex) { changedVolumes.set(applicationIndex); });
+	for(Client& client : clients) {
+		if(!client.subscribed) { continue; }
+		client.dirtyChannels |= changedChannels;
+		client.dirtyVolumes	 |= changedVolumes;
+	}
+}
+
+void ControlServer::Flush(Client& client) {
+	if(client.closed) { return; }
+
+	// Only encode once the previous message is out, from the values current at that point
+	if(client.output.empty()) {
+		if(client.needsSnapshot) {
+			EncodeSnapshot(client);
+		} else if(client.dirtyChannels.any() || client.dirtyVolumes.any()) {
+			EncodeDelta(client);
+		} else {
+			return;
+		}
+	}
+
+	while(client.written < client.output.size()) {
+		const int bytesWritten = client.connection->Write(client.output.data() + client.written, client.output.size() - client.written);
+		if(bytesWritten < 0) {
+			client.closed = true;
+			return;
+		}
+		if(bytesWritten == 0) { return; } // The client is not reading; try again next time round
+		client.written += static_cast<size_t>(bytesWritten);
+	}
+	client.output.clear();
+	client.written = 0;
+}
+
+void ControlServer::EncodeSnapshot(Client& client) {
+	const auto liveConfig = mixer.ReadLiveConfig(MixerController::CONFIG_READER_CONTROL);
+	if(!liveConfig) { return; }
+	const MixerState& state = mixer.State();
+
+	const size_t channelCount	  = std::min(liveConfig->channelRouter.ChannelCount(), MixerState::MAX_CHANNELS);
+	const size_t applicationCount = std::min(liveConfig->applications.size(), MixerState::MAX_APPLICATIONS);
+
+	// The snapshot holds the latest values, so the changes collected before it are already covered
+	client.needsSnapshot = false;
+	client.dirtyChannels.reset();
+	client.dirtyVolumes.reset();
+
+	std::vector<uint8_t>& out	= client.output;
+	const size_t		  start = ControlProtocol::BeginMessage(out, ControlProtocol::SNAPSHOT);
+	ControlProtocol::Put<uint8_t>(out, ControlProtocol::VERSION);
+	ControlProtocol::Put<uint32_t>(out, static_cast<uint32_t>(liveConfig->generation));
+	ControlProtocol::Put<uint16_t>(out, static_cast<uint16_t>(channelCount));
+	ControlProtocol::Put<uint16_t>(out, static_cast<uint16_t>(applicationCount));
+	for(size_t channel = 0; channel < channelCount; ++channel) {
+		ControlProtocol::Put<uint16_t>(out, state.Channel(channel));
+	}
+	for(size_t index = 0; index < applicationCount; ++index) {
+		const ApplicationConfig& application = liveConfig->applications[index];
+		const size_t			 nameLength	 = std::min(application.applicationName.size(), ControlProtocol::MAX_NAME_LENGTH);
+		ControlProtocol::Put<uint16_t>(out, application.potNumber >= 0 ? static_cast<uint16_t>(application.potNumber) : ControlProtocol::NO_VALUE);
+		ControlProtocol::Put<uint16_t>(out, state.Volume(index));
+		ControlProtocol::Put<uint8_t>(out, static_cast<uint8_t>(nameLength));
+		out.insert(out.end(), application.applicationName.begin(), application.applicationName.begin() + nameLength);
+	}
+	ControlProtocol::EndMessage(out, start);
+}
+
+void ControlServer::EncodeDelta(Client& client) {
+	const MixerState&	  state = mixer.State();
+	std::vector<uint8_t>& out	= client.output;
+	const size_t		  start = ControlProtocol::BeginMessage(out, ControlProtocol::DELTA);
+	ControlProtocol::Put<uint16_t>(out, static_cast<uint16_t>(client.dirtyChannels.count()));
+	ControlProtocol::Put<uint16_t>(out, static_cast<uint16_t>(client.dirtyVolumes.count()));
+	for(size_t channel = 0; channel < client.dirtyChannels.size(); ++channel) {
+		if(!client.dirtyChannels.test(channel)) { continue; }
+		ControlProtocol::Put<uint16_t>(out, static_cast<uint16_t>(channel));
+		ControlProtocol::Put<uint16_t>(out, state.Channel(channel));
+	}
+	for(size_t index = 0; index < client.dirtyVolumes.size(); ++index) {
+		if(!client.dirtyVolumes.test(index)) { continue; }
+		ControlProtocol::Put<uint16_t>(out, static_cast<uint16_t>(index));
+		ControlProtocol::Put<uint16_t>(out, state.Volume(index));
+	}
+	ControlProtocol::EndMessage(out, start);
+	client.dirtyChannels.reset();
+	client.dirtyVolumes.reset();
+}
+
+// Function to queue a refusal behind whatever the client is being sent
+void ControlServer::EncodeRefused(Client& client, const uint8_t requestType, const uint8_t reason) {
+	std::vector<uint8_t>& out	= client.output;
+	const size_t		  start = ControlProtocol::BeginMessage(out, ControlProtocol::REFUSED);
+	ControlProtocol::Put<uint8_t>(out, requestType);
+	ControlProtocol::Put<uint8_t>(out, reason);
+	ControlProtocol::EndMessage(out, start);
+}
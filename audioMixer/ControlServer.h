@@ -0,0 +1,69 @@
+#pragma once
+
+#include "LocalSocket.h"
+#include "MixerController.h"
+
+#include <atomic>
+#include <bitset>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Streams the mixer state to local control clients (the Electron frontend) and takes volume changes from them, on its
+// own thread. A subscribed client gets a snapshot, then a delta per update interval with what changed; while no client
+// is subscribed the thread only wakes for connections and input. Each client
+// has its own dirty bits and at most one message in flight: a client that stops reading accumulates dirty bits
+// instead of queued messages, so it catches up with the latest values and never holds up the control path.
+// See ControlProtocol.h for the message format.
+class ControlServer {
+public:
+	ControlServer(MixerController& mixer, std::string endpoint, std::chrono::milliseconds updateInterval = std::chrono::milliseconds(16))
+		: mixer(mixer), endpoint(std::move(endpoint)), updateInterval(updateInterval) {}
+
+	~ControlServer() { Stop(); }
+
+	// Function to listen on the endpoint and start the thread; returns false if the endpoint could not be opened
+	bool   Start();
+
+	void   Stop();
+
+	// Connected clients; safe to read from any thread
+	size_t ClientCount() const { return clientCount; }
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	struct Client {
+		std::unique_ptr<LocalConnection>		  connection;
+		std::vector<uint8_t>					  input;  // Bytes of a message not complete yet
+		std::vector<uint8_t>					  output; // The message being sent; empty when the client is caught up
+		size_t									  written		= 0;
+		std::bitset<MixerState::MAX_CHANNELS>	  dirtyChannels;
+		std::bitset<MixerState::MAX_APPLICATIONS> dirtyVolumes;
+		bool									  subscribed	= false;
+		bool									  needsSnapshot	= false;
+		bool									  closed		= false;
+	};
+
+	void						   Run();
+	void						   ReadInput(Client& client);
+	bool						   HandleMessage(Client& client, uint8_t type, const uint8_t* payload, size_t size);
+	void						   CollectChanges();
+	void						   Flush(Client& client);
+	void						   EncodeSnapshot(Client& client);
+	void						   EncodeDelta(Client& client);
+	void						   EncodeRefused(Client& client, uint8_t requestType, uint8_t reason);
+
+	MixerController&			   mixer;
+	std::string					   endpoint;
+	std::chrono::milliseconds	   updateInterval;
+	std::unique_ptr<LocalListener> listener;
+	std::vector<Client>			   clients; // Only touched by the server thread
+	uint64_t					   configGeneration	= 0;
+	std::atomic<bool>			   running			= false;
+	std::atomic<size_t>			   clientCount		= 0;
+	std::thread					   thread;
+};
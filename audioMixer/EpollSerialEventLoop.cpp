@@ -0,0 +1,70 @@
+#include "SerialEventLoop.h"
+#include "Log.h"
+
+#include <cerrno>
+#include <cstring>
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <unordered_map>
+
+namespace {
+	constexpr int MAX_EVENTS = 16;
+
+	class EpollSerialEventLoop : public SerialEventLoop {
+	public:
+		explicit EpollSerialEventLoop(const int epollFd) : epollFd(epollFd) {}
+
+		~EpollSerialEventLoop() override { close(epollFd); }
+
+		bool Add(SerialPort& port, const size_t key) override {
+			const std::optional<int> fd = port.GetNativeHandle();
+			if(!fd) { return false; }
+
+			// Level-triggered, so a port that was not fully drained is reported again
+			epoll_event event = {};
+			event.events	  = EPOLLIN;
+			event.data.u64	  = key;
+			if(epoll_ctl(epollFd, EPOLL_CTL_ADD, *fd, &event) != 0) {
+				LOG_ERROR("Error: Unable to watch serial port: {}", strerror(errno));
+				return false;
+			}
+			fds[key] = *fd;
+			return true;
+		}
+
+		void Remove(const size_t key) override {
+			const auto it = fds.find(key);
+			if(it == fds.end()) { return; }
+			epoll_ctl(epollFd, EPOLL_CTL_DEL, it->second, nullptr);
+			fds.erase(it);
+		}
+
+		WaitResult Wait(const int timeoutMs, std::vector<Event>& events) override {
+			events.clear();
+
+			epoll_event ready[MAX_EVENTS];
+			const int	count = epoll_wait(epollFd, ready, MAX_EVENTS, timeoutMs);
+			if(count < 0) { return errno == EINTR ? WaitResult::Timeout : WaitResult::Error; }
+			if(count == 0) { return WaitResult::Timeout; }
+
+			for(int i = 0; i < count; ++i) {
+				events.push_back({static_cast<size_t>(ready[i].data.u64), (ready[i].events & (EPOLLHUP | EPOLLERR)) != 0});
+			}
+			return WaitResult::Ready;
+		}
+
+	private:
+		int								epollFd;
+		std::unordered_map<size_t, int>	fds; // Key -> watched descriptor
+	};
+} // namespace
+
+// Function to create an epoll instance for the serial ports
+std::unique_ptr<SerialEventLoop> CreateSerialEventLoop() {
+	const int epollFd = epoll_create1(EPOLL_CLOEXEC);
+	if(epollFd < 0) {
+		LOG_ERROR("Error: Unable to create epoll instance: {}", strerror(errno));
+		return nullptr;
+	}
+	return std::make_unique<EpollSerialEventLoop>(epollFd);
+}
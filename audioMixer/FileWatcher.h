@@ -0,0 +1,19 @@
+#pragma once
+
+#include <memory>
+#include <string>
+
+// Watches one file for modifications (inotify on Linux, ReadDirectoryChangesW on Windows). The containing directory is
+// watched, so editors that save by writing a temporary file and renaming it over the original are seen as well.
+class FileWatcher {
+public:
+	enum class WaitResult { Changed, Timeout, Error };
+
+	virtual ~FileWatcher()							= default;
+
+	// Block until the file changes, the timeout expires or the watch fails
+	virtual WaitResult WaitForChange(int timeoutMs) = 0;
+};
+
+// Function to start watching a file; returns nullptr if its directory cannot be watched
+std::unique_ptr<FileWatcher> WatchFile(const std::string& path);
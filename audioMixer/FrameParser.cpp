@@ -0,0 +1,101 @@
+#include "FrameParser.h"
+
+#include <algorithm>
+#include <cstring>
+
+void FrameParser::Feed(const uint8_t* data, size_t size, const MixerFrame::TimePoint bytesReceivedAt) {
+	receivedAt = bytesReceivedAt;
+	while(size > 0) {
+		// Parse() always leaves less than one frame behind, so there is room for at least MIXER_MAX_FRAME_SIZE bytes
+		const size_t chunk = std::min(size, buffer.size() - bufferSize);
+		std::memcpy(buffer.data() + bufferSize, data, chunk);
+		bufferSize += chunk;
+		data += chunk;
+		size -= chunk;
+		Parse();
+	}
+}
+
+// Function to unpack a validated payload into channel updates (or counters, for a stats frame); returns the number of updates
+size_t FrameParser::Decode(const mixer_frame_type_t type, const uint8_t count, const uint8_t* payload) {
+	if(type == MIXER_FRAME_STATS) {
+		for(uint8_t i = 0; i < count; ++i) {
+			const uint8_t* entry = payload + i * MIXER_STATS_ENTRY_SIZE;
+			decodedStats[i]		 = static_cast<uint32_t>(entry[0] | (entry[1] << 8) | (entry[2] << 16)) | (static_cast<uint32_t>(entry[3]) << 24);
+		}
+		return 0;
+	}
+
+	size_t updateCount = 0;
+	for(uint8_t i = 0; i < count; ++i) {
+		ChannelValue update;
+		if(type == MIXER_FRAME_FULL) {
+			update.channel = i;
+			update.value   = static_cast<uint16_t>(payload[i * MIXER_FULL_ENTRY_SIZE] | (payload[i * MIXER_FULL_ENTRY_SIZE + 1] << 8));
+		} else {
+			update.channel = payload[i * MIXER_DELTA_ENTRY_SIZE];
+			update.value   = static_cast<uint16_t>(payload[i * MIXER_DELTA_ENTRY_SIZE + 1] | (payload[i * MIXER_DELTA_ENTRY_SIZE + 2] << 8));
+			if(update.channel >= MIXER_MAX_CHANNELS) { continue; }
+		}
+		update.value		   = std::min<uint16_t>(update.value, MIXER_VALUE_MAX);
+		decoded[updateCount++] = update;
+	}
+	return updateCount;
+}
+
+void FrameParser::Parse() {
+	size_t pos = 0;
+	while(true) {
+		// Find the next sync marker
+		while(pos + 1 < bufferSize && !(buffer[pos] == MIXER_SYNC_0 && buffer[pos + 1] == MIXER_SYNC_1)) {
+			++pos;
+			++stats.bytesSkipped;
+		}
+		if(pos + 1 == bufferSize && buffer[pos] != MIXER_SYNC_0) {
+			++pos;
+			++stats.bytesSkipped;
+		}
+		if(pos + MIXER_HEADER_SIZE > bufferSize) { break; }
+
+		const uint8_t* frame	   = buffer.data() + pos;
+		const uint8_t  length	   = frame[MIXER_OFFSET_LENGTH];
+		const uint8_t  type		   = frame[MIXER_OFFSET_TYPE];
+		const uint8_t  count	   = frame[MIXER_OFFSET_COUNT];
+		const int	   payloadSize = mixer_payload_size(type, count);
+		if(frame[MIXER_OFFSET_VERSION] != MIXER_PROTOCOL_VERSION || payloadSize < 0 || length != MIXER_LENGTH_HEADER_BYTES + payloadSize) {
+			// Sync marker inside payload data or a damaged header; look for the next marker one byte on
+			++stats.framesCorrupt;
+			++stats.bytesSkipped;
+			++pos;
+			continue;
+		}
+
+		const size_t crcOffset = MIXER_OFFSET_PAYLOAD + static_cast<size_t>(payloadSize);
+		const size_t frameSize = crcOffset + MIXER_CRC_SIZE;
+		if(pos + frameSize > bufferSize) { break; }
+
+		const uint16_t crc = static_cast<uint16_t>(frame[crcOffset] | (frame[crcOffset + 1] << 8));
+		if(crc != mixer_crc16(frame + MIXER_OFFSET_VERSION, crcOffset - MIXER_OFFSET_VERSION)) {
+			++stats.framesCorrupt;
+			++stats.bytesSkipped;
+			++pos;
+			continue;
+		}
+
+		const uint8_t sequence = frame[MIXER_OFFSET_SEQUENCE];
+		if(haveSequence) { stats.framesDropped += static_cast<uint8_t>(sequence - expectedSequence); }
+		haveSequence	 = true;
+		expectedSequence = static_cast<uint8_t>(sequence + 1);
+		++stats.framesReceived;
+
+		const size_t updateCount = Decode(static_cast<mixer_frame_type_t>(type), count, frame + MIXER_OFFSET_PAYLOAD);
+		const size_t statsCount	 = type == MIXER_FRAME_STATS ? count : 0;
+		onFrame(MixerFrame{sequence, static_cast<mixer_frame_type_t>(type), mixer_frame_timestamp(frame), receivedAt, std::chrono::steady_clock::now(),
+						   std::span<const ChannelValue>(decoded.data(), updateCount), std::span<const uint32_t>(decodedStats.data(), statsCount)});
+		pos += frameSize;
+	}
+
+	// Keep the unparsed tail (at most one partial frame) at the start of the buffer
+	std::memmove(buffer.data(), buffer.data() + pos, bufferSize - pos);
+	bufferSize -= pos;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "mixer_protocol.h"
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <span>
+
+// New 12-bit value (0 to MIXER_VALUE_MAX) of one channel
+struct ChannelValue {
+	uint8_t	 channel = 0;
+	uint16_t value	 = 0;
+};
+
+// One validated frame. A full frame lists every channel in order, a delta only the channels that moved and a heartbeat or
+// stats frame none. A stats frame carries the board's counters instead (indexed by mixer_stat_t). The updates and stats
+// point into the parser and are only valid during the callback.
+struct MixerFrame {
+	using TimePoint = std::chrono::steady_clock::time_point;
+
+	uint8_t						  sequence			= 0;
+	mixer_frame_type_t			  type				= MIXER_FRAME_FULL;
+	uint32_t					  deviceTimestampUs = 0; // When the board took the samples, on its own clock (wraps every ~71 minutes)
+	TimePoint					  receivedAt;			 // When the bytes completing the frame were read
+	TimePoint					  parsedAt;				 // When the frame passed its CRC check
+	std::span<const ChannelValue> updates;
+	std::span<const uint32_t>	  stats;
+};
+
+struct FrameParserStats {
+	uint64_t framesReceived = 0; // Frames that passed the CRC check
+	uint64_t framesDropped	= 0; // Frames missing according to the sequence numbers
+	uint64_t framesCorrupt	= 0; // Candidate frames rejected for a bad header or CRC
+	uint64_t bytesSkipped	= 0; // Bytes discarded while searching for the next sync marker
+};
+
+// Streaming parser for the framed serial protocol (see common/mixer_protocol.h). Bytes can be fed in any chunking;
+// after corruption or lost bytes it resynchronises on the next sync marker whose frame passes the CRC.
+class FrameParser {
+public:
+	using FrameHandler = std::function<void(const MixerFrame&)>;
+
+	explicit FrameParser(FrameHandler onFrame) : onFrame(std::move(onFrame)) {}
+
+	// receivedAt is when the bytes were read from the port; it is passed on in every frame they complete
+	void					Feed(const uint8_t* data, size_t size, MixerFrame::TimePoint receivedAt = std::chrono::steady_clock::now());
+
+	const FrameParserStats& Stats() const { return stats; }
+
+private:
+	void										  Parse();
+	size_t										  Decode(mixer_frame_type_t type, uint8_t count, const uint8_t* payload);
+
+	FrameHandler								  onFrame;
+	std::array<uint8_t, MIXER_MAX_FRAME_SIZE * 2> buffer		   = {};
+	std::array<ChannelValue, MIXER_MAX_CHANNELS>  decoded		   = {};
+	std::array<uint32_t, MIXER_MAX_STATS>		  decodedStats	   = {};
+	size_t										  bufferSize	   = 0;
+	MixerFrame::TimePoint						  receivedAt;
+	bool										  haveSequence	   = false;
+	uint8_t										  expectedSequence = 0;
+	FrameParserStats							  stats;
+};
@@ -0,0 +1,61 @@
+#include "FileWatcher.h"
+#include "Log.h"
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+namespace {
+	class InotifyFileWatcher : public FileWatcher {
+	public:
+		InotifyFileWatcher(const int fd, std::string fileName) : fd(fd), fileName(std::move(fileName)) {}
+
+		~InotifyFileWatcher() override { close(fd); }
+
+		WaitResult WaitForChange(const int timeoutMs) override {
+			pollfd	  pfd	= {fd, POLLIN, 0};
+			const int ready = poll(&pfd, 1, timeoutMs);
+			if(ready < 0) { return errno == EINTR ? WaitResult::Timeout : WaitResult::Error; }
+			if(ready == 0) { return WaitResult::Timeout; }
+
+			// Other files in the directory change too; only report events for ours
+			alignas(inotify_event) char buffer[4096];
+			bool						changed = false;
+			ssize_t						size	= 0;
+			while((size = read(fd, buffer, sizeof(buffer))) > 0) {
+				for(char* p = buffer; p < buffer + size;) {
+					const auto* event = reinterpret_cast<const inotify_event*>(p);
+					if(event->len > 0 && fileName == event->name) { changed = true; }
+					p += sizeof(inotify_event) + event->len;
+				}
+			}
+			if(size < 0 && errno != EAGAIN) { return WaitResult::Error; }
+			return changed ? WaitResult::Changed : WaitResult::Timeout;
+		}
+
+	private:
+		int			fd;
+		std::string fileName;
+	};
+} // namespace
+
+// Function to watch a file's directory for writes and renames onto the file
+std::unique_ptr<FileWatcher> WatchFile(const std::string& path) {
+	const std::filesystem::path filePath(path);
+	const std::string			directory = filePath.has_parent_path() ? filePath.parent_path().string() : ".";
+
+	const int					fd		  = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if(fd < 0) {
+		LOG_ERROR("Error: Unable to create inotify instance: {}", strerror(errno));
+		return nullptr;
+	}
+	if(inotify_add_watch(fd, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE) < 0) {
+		LOG_ERROR("Error: Unable to watch {}: {}", directory, strerror(errno));
+		close(fd);
+		return nullptr;
+	}
+	return std::make_unique<InotifyFileWatcher>(fd, filePath.filename().string());
+}
@@ -0,0 +1,144 @@
+#include "SerialEventLoop.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <unordered_map>
+#include <windows.h>
+
+namespace {
+	constexpr ULONG MAX_EVENTS = 16;
+
+	// One watched port. Its completion key is a fresh id rather than the caller's key, so a completion left over from a
+	// removed port is never mistaken for one of a port that was re-added under the same key.
+	struct Registration {
+		enum class State {
+			Idle,	 // Reported by Wait and being drained
+			Waiting, // WaitCommEvent outstanding; the kernel owns the OVERLAPPED until it completes
+			Posted	 // Completion queued by us because bytes were already buffered or the wait could not start
+		};
+
+		size_t	   key		  = 0;
+		HANDLE	   handle	  = nullptr;
+		OVERLAPPED overlapped = {};
+		DWORD	   eventMask  = 0;
+		State	   state	  = State::Idle;
+		bool	   failed	  = false;
+	};
+
+	class IocpSerialEventLoop : public SerialEventLoop {
+	public:
+		explicit IocpSerialEventLoop(const HANDLE completionPort) : completionPort(completionPort) {}
+
+		~IocpSerialEventLoop() override {
+			while(!ids.empty()) {
+				Remove(ids.begin()->first);
+			}
+			CloseHandle(completionPort);
+		}
+
+		bool Add(SerialPort& port, const size_t key) override {
+			const std::optional<HANDLE> handle = port.GetNativeHandle();
+			if(!handle) { return false; }
+
+			const ULONG_PTR id = ++lastId;
+			if(!CreateIoCompletionPort(*handle, completionPort, id, 0)) {
+				LOG_ERROR("Error: Unable to add serial port to the completion port. Error: {}", GetLastError());
+				return false;
+			}
+
+			auto registration	 = std::make_unique<Registration>();
+			registration->key	 = key;
+			registration->handle = *handle;
+			Arm(id, *registration);
+			registrations[id] = std::move(registration);
+			ids[key]		  = id;
+			return true;
+		}
+
+		void Remove(const size_t key) override {
+			const auto idIt = ids.find(key);
+			if(idIt == ids.end()) { return; }
+
+			const auto	  it		   = registrations.find(idIt->second);
+			Registration& registration = *it->second;
+			if(registration.state == Registration::State::Waiting) {
+				CancelIoEx(registration.handle, &registration.overlapped);
+				DWORD unused = 0;
+				GetOverlappedResult(registration.handle, &registration.overlapped, &unused, TRUE);
+			}
+
+			std::erase(toArm, idIt->second);
+			registrations.erase(it);
+			ids.erase(idIt);
+		}
+
+		WaitResult Wait(const int timeoutMs, std::vector<Event>& events) override {
+			events.clear();
+
+			// The ports reported last time have been drained; wait for their next bytes
+			for(const ULONG_PTR id : toArm) {
+				Arm(id, *registrations.at(id));
+			}
+			toArm.clear();
+
+			OVERLAPPED_ENTRY entries[MAX_EVENTS];
+			ULONG			 count = 0;
+			if(!GetQueuedCompletionStatusEx(completionPort, entries, MAX_EVENTS, &count, static_cast<DWORD>(timeoutMs), FALSE)) {
+				return GetLastError() == WAIT_TIMEOUT ? WaitResult::Timeout : WaitResult::Error;
+			}
+
+			for(ULONG i = 0; i < count; ++i) {
+				// Skip completions of removed ports
+				const auto it = registrations.find(entries[i].lpCompletionKey);
+				if(it == registrations.end() || entries[i].lpOverlapped != &it->second->overlapped) { continue; }
+
+				Registration& registration = *it->second;
+				const bool	  failed	   = registration.failed || registration.overlapped.Internal != 0; // NTSTATUS of the wait
+				registration.state		   = Registration::State::Idle;
+				registration.failed		   = false;
+				events.push_back({registration.key, failed});
+				toArm.push_back(it->first);
+			}
+			return events.empty() ? WaitResult::Timeout : WaitResult::Ready;
+		}
+
+	private:
+		// Function to wait for the next received byte. Bytes that arrived while the port was drained do not raise
+		// another EV_RXCHAR, so a port with buffered input is reported again straight away.
+		void Arm(const ULONG_PTR id, Registration& registration) {
+			registration.overlapped = {};
+
+			DWORD	errors	= 0;
+			COMSTAT comStat = {};
+			if(!ClearCommError(registration.handle, &errors, &comStat)) {
+				registration.failed = true;
+			} else if(comStat.cbInQue == 0) {
+				// Completes through the port even when it succeeds immediately
+				if(WaitCommEvent(registration.handle, &registration.eventMask, &registration.overlapped) || GetLastError() == ERROR_IO_PENDING) {
+					registration.state = Registration::State::Waiting;
+					return;
+				}
+				registration.failed = true;
+			}
+
+			registration.state = Registration::State::Posted;
+			PostQueuedCompletionStatus(completionPort, 0, id, &registration.overlapped);
+		}
+
+		HANDLE														 completionPort;
+		ULONG_PTR													 lastId	= 0;
+		std::unordered_map<ULONG_PTR, std::unique_ptr<Registration>> registrations;	// Completion key -> port
+		std::unordered_map<size_t, ULONG_PTR>						 ids;			// Caller's key -> completion key
+		std::vector<ULONG_PTR>										 toArm;			// Reported by the last Wait
+	};
+} // namespace
+
+// Function to create an I/O completion port for the serial ports
+std::unique_ptr<SerialEventLoop> CreateSerialEventLoop() {
+	const HANDLE completionPort = CreateIoCompletionPort(INVALID_HANDLE_VALUE, nullptr, 0, 1);
+	if(!completionPort) {
+		LOG_ERROR("Error: Unable to create I/O completion port. Error: {}", GetLastError());
+		return nullptr;
+	}
+	return std::make_unique<IocpSerialEventLoop>(completionPort);
+}
@@ -0,0 +1,55 @@
+#include "KeyBindingMatcher.h"
+
+#include <algorithm>
+
+void KeyBindingMatcher::AddBinding(const KeyMask& keys, const uint16_t applicationIndex, const float delta) {
+	if(keys.none()) { return; }
+	bindings.push_back({keys, applicationIndex, delta});
+}
+
+void KeyBindingMatcher::Build() {
+	// Counting sort of (key, binding) pairs into one contiguous array
+	triggerOffsets.fill(0);
+	for(const KeyBinding& binding : bindings) {
+		for(uint32_t vkCode = 0; vkCode < 256; ++vkCode) {
+			if(binding.keys.test(vkCode)) { ++triggerOffsets[vkCode + 1]; }
+		}
+	}
+	for(uint32_t vkCode = 0; vkCode < 256; ++vkCode) {
+		triggerOffsets[vkCode + 1] += triggerOffsets[vkCode];
+	}
+
+	triggerBindings.assign(triggerOffsets[256], 0);
+	std::array<uint32_t, 256> next;
+	std::copy_n(triggerOffsets.begin(), 256, next.begin());
+	for(size_t bindingIndex = 0; bindingIndex < bindings.size(); ++bindingIndex) {
+		for(uint32_t vkCode = 0; vkCode < 256; ++vkCode) {
+			if(bindings[bindingIndex].keys.test(vkCode)) { triggerBindings[next[vkCode]++] = static_cast<uint16_t>(bindingIndex); }
+		}
+	}
+}
+
+void KeyBindingMatcher::Clear() {
+	bindings.clear();
+	triggerBindings.clear();
+	triggerOffsets.fill(0);
+}
+
+void KeyboardState::KeyDown(const uint32_t vkCode) {
+	if(vkCode >= 256) { return; }
+	pressedKeys.set(vkCode);
+	if(const uint32_t generic = KeyBindingMatcher::GetGenericModifier(vkCode)) { pressedKeys.set(generic); }
+}
+
+void KeyboardState::KeyUp(const uint32_t vkCode) {
+	if(vkCode >= 256) { return; }
+	pressedKeys.reset(vkCode);
+
+	// Keep the generic modifier held while the other side still is
+	switch(KeyBindingMatcher::GetGenericModifier(vkCode)) {
+		case VirtualKey::Shift: pressedKeys.set(VirtualKey::Shift, pressedKeys.test(VirtualKey::LShift) || pressedKeys.test(VirtualKey::RShift)); break;
+		case VirtualKey::Control: pressedKeys.set(VirtualKey::Control, pressedKeys.test(VirtualKey::LControl) || pressedKeys.test(VirtualKey::RControl)); break;
+		case VirtualKey::Menu: pressedKeys.set(VirtualKey::Menu, pressedKeys.test(VirtualKey::LMenu) || pressedKeys.test(VirtualKey::RMenu)); break;
+		default: break;
+	}
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "VirtualKeys.h"
+
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+// One bit per virtual-key code
+using KeyMask = std::bitset<256>;
+
+// A hotkey compiled at config load: the keys that must be held and what to do when they are
+struct KeyBinding {
+	KeyMask	 keys;
+	uint16_t applicationIndex = 0;
+	float	 delta			  = 0.0f;
+};
+
+// Matches key-downs against every configured hotkey without hashing or allocation. Pressed keys are kept as a bitset and
+// each VK maps to the contiguous list of bindings that contain it, so a key-down is one index lookup plus a mask compare
+// per candidate binding. Once built the matcher is read-only; the held keys live in KeyboardState so a reloaded
+// config can swap matchers while keys are down.
+class KeyBindingMatcher {
+public:
+	void AddBinding(const KeyMask& keys, uint16_t applicationIndex, float delta);
+
+	// Build the per-key index; call after the last AddBinding
+	void Build();
+
+	void Clear();
+
+	// Call onTriggered for each binding containing vkCode whose keys are all held (pressedKeys must already include vkCode)
+	template <typename Callback> void ForEachTriggered(const uint32_t vkCode, const KeyMask& pressedKeys, Callback&& onTriggered) const {
+		if(vkCode >= 256) { return; }
+		ForEachCandidate(vkCode, pressedKeys, onTriggered);
+		if(const uint32_t generic = GetGenericModifier(vkCode)) { ForEachCandidate(generic, pressedKeys, onTriggered); }
+	}
+
+	size_t BindingCount() const { return bindings.size(); }
+
+	// Function to get the generic modifier for a sided modifier key, or 0 if the key is not one. The hook only reports
+	// the sided codes, while configs name the generic one ("Ctrl"), so a sided key also counts as its generic modifier.
+	static constexpr uint32_t GetGenericModifier(const uint32_t vkCode) {
+		switch(vkCode) {
+			case VirtualKey::LShift:
+			case VirtualKey::RShift: return VirtualKey::Shift;
+			case VirtualKey::LControl:
+			case VirtualKey::RControl: return VirtualKey::Control;
+			case VirtualKey::LMenu:
+			case VirtualKey::RMenu: return VirtualKey::Menu;
+			default: return 0;
+		}
+	}
+
+private:
+	template <typename Callback> void ForEachCandidate(const uint32_t vkCode, const KeyMask& pressedKeys, Callback& onTriggered) const {
+		for(uint32_t i = triggerOffsets[vkCode]; i < triggerOffsets[vkCode + 1]; ++i) {
+			const KeyBinding& binding = bindings[triggerBindings[i]];
+			if((binding.keys & ~pressedKeys).none()) { onTriggered(binding); }
+		}
+	}
+
+	std::vector<KeyBinding>	  bindings;
+	std::array<uint32_t, 257> triggerOffsets = {}; // Bindings for key k are triggerBindings[triggerOffsets[k]..triggerOffsets[k + 1])
+	std::vector<uint16_t>	  triggerBindings;
+};
+
+// Keys currently held, as reported by the keyboard hook. A sided modifier also holds its generic modifier.
+class KeyboardState {
+public:
+	void		   KeyDown(uint32_t vkCode);
+	void		   KeyUp(uint32_t vkCode);
+
+	const KeyMask& PressedKeys() const { return pressedKeys; }
+
+private:
+	KeyMask pressedKeys;
+};
@@ -0,0 +1,157 @@
+#pragma once
+
+#include "VirtualKeys.h"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <optional>
+#include <string_view>
+
+// Key name <-> virtual-key code tables for the config parser and its diagnostics, built at compile time. Named keys are
+// sorted case-insensitively so a lookup is a binary search without allocation; the reverse table is a plain 256-entry array.
+// Nothing here depends on <windows.h>, so the tables can be checked with static_assert and benchmarked on any platform.
+namespace KeyNames {
+	struct Entry {
+		std::string_view name;
+		uint8_t			 vkCode = 0;
+	};
+
+	// Every named key. Names are matched ignoring case; the first name listed for a code is the one reported for it.
+	constexpr Entry NAMED_KEYS[] = {
+		// Modifier keys
+		{"Ctrl", VirtualKey::Control},
+		{"Alt", VirtualKey::Menu},
+		{"Shift", VirtualKey::Shift},
+		{"LWin", VirtualKey::LWin},
+		{"RWin", VirtualKey::RWin},
+
+		// Special keys
+		{"Up", VirtualKey::Up},
+		{"Down", VirtualKey::Down},
+		{"Left", VirtualKey::Left},
+		{"Right", VirtualKey::Right},
+		{"Tab", VirtualKey::Tab},
+		{"Enter", VirtualKey::Return},
+		{"Esc", VirtualKey::Escape},
+		{"Escape", VirtualKey::Escape},
+		{"Space", VirtualKey::Space},
+		{"Backspace", VirtualKey::Back},
+		{"Delete", VirtualKey::Delete},
+		{"Del", VirtualKey::Delete},
+		{"Insert", VirtualKey::Insert},
+		{"Ins", VirtualKey::Insert},
+		{"Home", VirtualKey::Home},
+		{"End", VirtualKey::End},
+		{"PageUp", VirtualKey::Prior},
+		{"PageDown", VirtualKey::Next},
+		{"CapsLock", VirtualKey::Capital},
+		{"NumLock", VirtualKey::NumLock},
+		{"ScrollLock", VirtualKey::Scroll},
+		{"PrintScreen", VirtualKey::Snapshot},
+		{"Pause", VirtualKey::Pause},
+		{"Apps", VirtualKey::Apps}, // Context Menu key
+
+		// Numpad keys
+		{"NumPad0", VirtualKey::NumPad0},
+		{"NumPad1", VirtualKey::NumPad0 + 1},
+		{"NumPad2", VirtualKey::NumPad0 + 2},
+		{"NumPad3", VirtualKey::NumPad0 + 3},
+		{"NumPad4", VirtualKey::NumPad0 + 4},
+		{"NumPad5", VirtualKey::NumPad0 + 5},
+		{"NumPad6", VirtualKey::NumPad0 + 6},
+		{"NumPad7", VirtualKey::NumPad0 + 7},
+		{"NumPad8", VirtualKey::NumPad0 + 8},
+		{"NumPad9", VirtualKey::NumPad0 + 9},
+
+		// Media keys
+		{"VolumeUp", VirtualKey::VolumeUp},
+		{"VolumeDown", VirtualKey::VolumeDown},
+		{"VolumeMute", VirtualKey::VolumeMute},
+	};
+
+	constexpr std::string_view FUNCTION_KEY_NAMES[] = {"F1",  "F2",  "F3",  "F4",  "F5",  "F6",  "F7",  "F8",  "F9",  "F10", "F11", "F12",
+													   "F13", "F14", "F15", "F16", "F17", "F18", "F19", "F20", "F21", "F22", "F23", "F24"};
+
+	// Letters and digits are their own (upper-case ASCII) VK codes
+	constexpr std::string_view ALPHANUMERIC_KEYS = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ";
+
+	constexpr char ToLowerAscii(const char c) { return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c; }
+
+	constexpr char ToUpperAscii(const char c) { return c >= 'a' && c <= 'z' ? static_cast<char>(c - 'a' + 'A') : c; }
+
+	// Function to compare two names ignoring ASCII case; returns <0, 0 or >0 like strcmp
+	constexpr int CompareIgnoreCase(const std::string_view a, const std::string_view b) {
+		const size_t length = std::min(a.size(), b.size());
+		for(size_t i = 0; i < length; ++i) {
+			const char x = ToLowerAscii(a[i]);
+			const char y = ToLowerAscii(b[i]);
+			if(x != y) { return x < y ? -1 : 1; }
+		}
+		return a.size() == b.size() ? 0 : (a.size() < b.size() ? -1 : 1);
+	}
+
+	constexpr bool LessIgnoreCase(const Entry& a, const Entry& b) { return CompareIgnoreCase(a.name, b.name) < 0; }
+
+	constexpr auto SORTED_KEYS = [] {
+		std::array<Entry, std::size(NAMED_KEYS)> sorted = {};
+		std::copy(std::begin(NAMED_KEYS), std::end(NAMED_KEYS), sorted.begin());
+		std::sort(sorted.begin(), sorted.end(), LessIgnoreCase);
+		return sorted;
+	}();
+
+	static_assert(std::adjacent_find(SORTED_KEYS.begin(), SORTED_KEYS.end(),
+									 [](const Entry& a, const Entry& b) { return CompareIgnoreCase(a.name, b.name) == 0; }) == SORTED_KEYS.end(),
+				  "Duplicate key name");
+
+	constexpr auto NAMES_BY_CODE = [] {
+		std::array<std::string_view, 256> names;
+		names.fill("");
+		for(size_t i = std::size(NAMED_KEYS); i-- > 0;) {
+			names[NAMED_KEYS[i].vkCode] = NAMED_KEYS[i].name;
+		}
+		for(size_t i = 0; i < std::size(FUNCTION_KEY_NAMES); ++i) {
+			names[VirtualKey::F1 + i] = FUNCTION_KEY_NAMES[i];
+		}
+		for(size_t i = 0; i < ALPHANUMERIC_KEYS.size(); ++i) {
+			names[static_cast<uint8_t>(ALPHANUMERIC_KEYS[i])] = ALPHANUMERIC_KEYS.substr(i, 1);
+		}
+		return names;
+	}();
+} // namespace KeyNames
+
+// Function to parse a function key name ("F1" to "F24", any case); returns nullopt for anything else, e.g. "F0" or "Foo"
+constexpr std::optional<uint8_t> ParseFunctionKey(const std::string_view keyName) {
+	if(keyName.size() < 2 || keyName.size() > 3 || KeyNames::ToLowerAscii(keyName[0]) != 'f') { return std::nullopt; }
+
+	int number = 0;
+	for(const char c : keyName.substr(1)) {
+		if(c < '0' || c > '9') { return std::nullopt; }
+		number = number * 10 + (c - '0');
+	}
+	if(number < 1 || number > static_cast<int>(std::size(KeyNames::FUNCTION_KEY_NAMES))) { return std::nullopt; }
+	return static_cast<uint8_t>(VirtualKey::F1 + number - 1);
+}
+
+// Function to look up the VK code of a key name: named keys, function keys, letters and digits (case-insensitive)
+constexpr std::optional<uint8_t> FindVirtualKey(const std::string_view keyName) {
+	const auto it = std::lower_bound(KeyNames::SORTED_KEYS.begin(), KeyNames::SORTED_KEYS.end(), keyName,
+									 [](const KeyNames::Entry& entry, const std::string_view name) { return KeyNames::CompareIgnoreCase(entry.name, name) < 0; });
+	if(it != KeyNames::SORTED_KEYS.end() && KeyNames::CompareIgnoreCase(it->name, keyName) == 0) { return it->vkCode; }
+
+	if(const auto functionKey = ParseFunctionKey(keyName)) { return functionKey; }
+
+	if(keyName.size() == 1 && KeyNames::ALPHANUMERIC_KEYS.find(KeyNames::ToUpperAscii(keyName[0])) != std::string_view::npos) {
+		return static_cast<uint8_t>(KeyNames::ToUpperAscii(keyName[0]));
+	}
+	return std::nullopt;
+}
+
+// Function to get the config name of a VK code (e.g. "PageUp" for 0x21); empty if the key has no name
+constexpr std::string_view GetVirtualKeyName(const uint32_t vkCode) { return vkCode < KeyNames::NAMES_BY_CODE.size() ? KeyNames::NAMES_BY_CODE[vkCode] : ""; }
+
+static_assert(FindVirtualKey("ctrl") == VirtualKey::Control && FindVirtualKey("PAGEDOWN") == VirtualKey::Next && FindVirtualKey("f24") == VirtualKey::F1 + 23);
+static_assert(FindVirtualKey("q") == 'Q' && !FindVirtualKey("Foo") && !FindVirtualKey("F0") && !FindVirtualKey("F25") && !FindVirtualKey(""));
+static_assert(GetVirtualKeyName(VirtualKey::Escape) == "Esc" && GetVirtualKeyName(VirtualKey::F1 + 11) == "F12" && GetVirtualKeyName(0x07).empty());
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+
+// Lock-free latency histogram with HDR-style log-linear buckets: every power of two is split into SUB_BUCKET_COUNT linear
+// buckets, so any value from 1ns to ~36 minutes is kept within ~3% and Record is a couple of relaxed atomic adds.
+// Any thread may record while another reads percentiles or dumps it.
+class LatencyHistogram {
+public:
+	static constexpr uint32_t SUB_BUCKET_BITS  = 5;
+	static constexpr uint32_t SUB_BUCKET_COUNT = 1u << SUB_BUCKET_BITS;
+	static constexpr uint32_t MAX_EXPONENT	   = 40; // Larger values are clamped to 2^41 - 1 ns
+	static constexpr size_t	  BUCKET_COUNT	   = (MAX_EXPONENT - SUB_BUCKET_BITS + 2) * SUB_BUCKET_COUNT;
+
+	void Record(const std::chrono::nanoseconds latency) {
+		const uint64_t value = latency.count() < 0 ? 0 : static_cast<uint64_t>(latency.count());
+		counts[BucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+		totalCount.fetch_add(1, std::memory_order_relaxed);
+		totalNs.fetch_add(value, std::memory_order_relaxed);
+
+		uint64_t currentMax = maxNs.load(std::memory_order_relaxed);
+		while(value > currentMax && !maxNs.compare_exchange_weak(currentMax, value, std::memory_order_relaxed)) {}
+	}
+
+	uint64_t				 Count() const { return totalCount.load(std::memory_order_relaxed); }
+
+	std::chrono::nanoseconds Max() const { return std::chrono::nanoseconds(maxNs.load(std::memory_order_relaxed)); }
+
+	std::chrono::nanoseconds Mean() const {
+		const uint64_t count = Count();
+		return std::chrono::nanoseconds(count == 0 ? 0 : totalNs.load(std::memory_order_relaxed) / count);
+	}
+
+	// Function to get the given percentile (0-100); reports the highest value of the bucket it falls in
+	std::chrono::nanoseconds Percentile(const double percentile) const {
+		std::array<uint64_t, BUCKET_COUNT> snapshot;
+		uint64_t						   count = 0;
+		for(size_t i = 0; i < BUCKET_COUNT; ++i) {
+			snapshot[i] = counts[i].load(std::memory_order_relaxed);
+			count += snapshot[i];
+		}
+		if(count == 0) { return std::chrono::nanoseconds(0); }
+
+		const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(percentile / 100.0 * static_cast<double>(count) + 0.5));
+		uint64_t	   seen = 0;
+		for(size_t i = 0; i < BUCKET_COUNT; ++i) {
+			seen += snapshot[i];
+			if(seen >= rank) { return std::chrono::nanoseconds(std::min(BucketHighestValue(i), maxNs.load(std::memory_order_relaxed))); }
+		}
+		return Max();
+	}
+
+	void Reset() {
+		for(auto& count : counts) {
+			count.store(0, std::memory_order_relaxed);
+		}
+		totalCount.store(0, std::memory_order_relaxed);
+		totalNs.store(0, std::memory_order_relaxed);
+		maxNs.store(0, std::memory_order_relaxed);
+	}
+
+	// Function to write the summary as a JSON object
+	void WriteJson(std::ostream& out) const {
+		out << "{\"count\":" << Count() << ",\"mean_ns\":" << Mean().count() << ",\"p50_ns\":" << Percentile(50).count()
+			<< ",\"p90_ns\":" << Percentile(90).count() << ",\"p99_ns\":" << Percentile(99).count() << ",\"p999_ns\":" << Percentile(99.9).count()
+			<< ",\"max_ns\":" << Max().count() << "}";
+	}
+
+private:
+	static constexpr size_t BucketIndex(uint64_t value) {
+		if(value < SUB_BUCKET_COUNT) { return static_cast<size_t>(value); }
+		value					= std::min<uint64_t>(value, (uint64_t{1} << (MAX_EXPONENT + 1)) - 1);
+		const uint32_t exponent = static_cast<uint32_t>(std::bit_width(value)) - 1;
+		const uint32_t group	= exponent - SUB_BUCKET_BITS + 1;
+		return group * SUB_BUCKET_COUNT + static_cast<size_t>((value >> (exponent - SUB_BUCKET_BITS)) - SUB_BUCKET_COUNT);
+	}
+
+	static constexpr uint64_t BucketHighestValue(const size_t index) {
+		if(index < SUB_BUCKET_COUNT) { return index; }
+		const uint64_t group = index / SUB_BUCKET_COUNT;
+		const uint64_t lower = (SUB_BUCKET_COUNT + index % SUB_BUCKET_COUNT) << (group - 1);
+		return lower + (uint64_t{1} << (group - 1)) - 1;
+	}
+
+	std::array<std::atomic<uint64_t>, BUCKET_COUNT> counts	   = {};
+	std::atomic<uint64_t>							totalCount = 0;
+	std::atomic<uint64_t>							totalNs	   = 0;
+	std::atomic<uint64_t>							maxNs	   = 0;
+};
@@ -0,0 +1,175 @@
+#include "CommandLine.h"
+#include "ConfigReloader.h"
+#include "ControlServer.h"
+#include "Log.h"
+#include "MixerController.h"
+#include "PulseAudioBackend.h"
+#include "SerialDeviceManager.h"
+#include "SerialLog.h"
+#include "SerialReader.h"
+#include "SharedStateWriter.h"
+
+#include <atomic>
+#include <csignal>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <pthread.h>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Written on SIGUSR1 (the Linux stand-in for the "Dump Latency" tray item), in the working directory
+#define LATENCY_DUMP_PATH	"audioMixer_latency.json"
+
+// Config used when no path is given on the command line
+#define DEFAULT_CONFIG_PATH "audio_conf.json"
+
+// Board used when the config has no "devices" list (ESP32 boards with a USB-UART bridge; /dev/ttyACM0 for native USB)
+#define DEFAULT_SERIAL_PORT "/dev/ttyUSB0"
+
+// Global variables
+std::unique_ptr<MixerController> mixer; // Config, pot routing and the audio worker
+
+// Atomic flag to control the serial reading thread
+std::atomic<bool>				 keepReading(true);
+
+// Function to play a recorded session back in a separate thread
+void ReplayThread(SerialPort& replayPort) {
+	SerialReader reader(replayPort, [](const MixerFrame& frame) { mixer->ApplyPotFrame(frame); }, &mixer->Latency());
+	reader.Run(keepReading);
+
+	LOG_INFO("Replay thread exiting.");
+}
+
+// Function to service every mixer board from one event loop in a separate thread
+void DeviceThread(SerialDeviceManager& deviceManager) {
+	if(!deviceManager.Run(keepReading)) { LOG_ERROR("Unable to wait for the mixer boards."); }
+	deviceManager.ReportStats();
+
+	LOG_INFO("Device thread exiting.");
+}
+
+// Function to write the pot path latency histograms to a file
+void DumpLatency(const std::string& path) {
+	std::ofstream outFile(path);
+	if(!outFile.is_open()) {
+		LOG_ERROR("Unable to write {}.", path);
+		return;
+	}
+	mixer->Latency().WriteJson(outFile);
+	LOG_INFO("Latency written to {}.", path);
+}
+
+// Main function
+int main(int argc, char** argv) {
+	// Usage: audioMixer [config path] [--record <file>] [--replay <file> [--speed N|max]] [--latency <file>]
+	CommandLineOptions options;
+	if(!ParseCommandLine(argc, argv, options)) { return 2; }
+	const std::string configPath = options.configPath.empty() ? DEFAULT_CONFIG_PATH : options.configPath;
+
+	// Block the signals before any thread starts, so they all inherit the mask and only the sigwait below receives them
+	sigset_t signals;
+	sigemptyset(&signals);
+	sigaddset(&signals, SIGINT);
+	sigaddset(&signals, SIGTERM);
+	sigaddset(&signals, SIGUSR1);
+	pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+
+	if(!Log::Start(options.log)) { return 2; }
+
+	std::unique_ptr<MixerConfig> initialConfig = LoadConfig(configPath);
+	if(!initialConfig) { return -1; }
+
+	// Connect to the sound server once; its subscription keeps the streams current for the audio worker
+	PulseAudioBackend audioBackend;
+	if(!audioBackend.Initialize()) { return -1; }
+
+	// Publish the state for overlays and monitoring tools; the mixer works the same without it
+	std::unique_ptr<SharedStateWriter> sharedState = CreateSharedStateWriter(SharedState::DefaultName());
+	if(!sharedState) { std::cerr << "The mixer state will not be shared with other tools." << std::endl; }
+
+	mixer = std::make_unique<MixerController>(audioBackend, sharedState.get());
+	mixer->PublishConfig(std::move(initialConfig));
+	mixer->Start();
+
+	// There is no global keyboard hook on X11/Wayland that works without extra privileges, so only the pots are live
+	std::cout << "Application volume controller started." << std::endl;
+	std::cout << "Hotkeys are not supported on Linux; monitoring pots for applications:" << std::endl;
+	{
+		const auto liveConfig = mixer->ReadLiveConfig(MixerController::CONFIG_READER_INPUT);
+		for(const auto& app : liveConfig->applications) {
+			std::cout << " - " << app.applicationName << " (pot " << app.potNumber << ")" << std::endl;
+		}
+	}
+
+	// Pick up edits to the config without restarting the serial thread
+	ConfigReloader configReloader(configPath, [](std::unique_ptr<MixerConfig> config) { mixer->PublishConfig(std::move(config)); });
+	if(!configReloader.Start()) { std::cerr << "Config changes will only be picked up after a restart." << std::endl; }
+
+	// Stream the mixer state to the frontend and take its volume changes
+	ControlServer controlServer(*mixer, DefaultLocalEndpoint());
+	if(!controlServer.Start()) { std::cerr << "The frontend will not be able to connect." << std::endl; }
+
+	// The boards to service; the list is read once, so adding a board needs a restart
+	std::vector<DeviceConfig> devices = mixer->ReadLiveConfig(MixerController::CONFIG_READER_INPUT)->devices;
+	if(devices.empty()) { devices.push_back({DEFAULT_SERIAL_PORT}); }
+
+	// With --record each board gets its own log: the given path, or the path plus ".<board index>" with several boards
+	std::vector<std::shared_ptr<SerialLogWriter>> recordLogs;
+	SerialDeviceManager::PortOpener				  openPort;
+	if(!options.recordPath.empty()) {
+		for(size_t i = 0; i < devices.size(); ++i) {
+			recordLogs.push_back(std::make_shared<SerialLogWriter>());
+			if(!recordLogs.back()->Open(devices.size() == 1 ? options.recordPath : options.recordPath + "." + std::to_string(i))) { return 1; }
+		}
+		openPort = [&recordLogs](const size_t deviceIndex, const DeviceConfig& device) -> std::unique_ptr<SerialPort> {
+			std::unique_ptr<SerialPort> port = OpenSerialPort(device.portName, device.baudRate);
+			return port ? RecordSerialPort(std::move(port), recordLogs[deviceIndex]) : nullptr;
+		};
+	}
+
+	SerialDeviceManager deviceManager(
+		std::move(devices),
+		[](const MixerFrame& frame, const DeviceConfig& device) { mixer->ApplyPotFrame(frame, device.firstChannel, device.channelCount); },
+		&mixer->Latency(), std::move(openPort));
+
+	// Service the boards, or play back a recorded session in their place
+	std::unique_ptr<SerialPort> replayPort;
+	std::thread					serialThread;
+	if(!options.replayPath.empty()) {
+		replayPort = OpenReplayPort(options.replayPath, options.replaySpeed);
+		if(!replayPort) { return 1; }
+		serialThread = std::thread(ReplayThread, std::ref(*replayPort));
+	} else {
+		serialThread = std::thread(DeviceThread, std::ref(deviceManager));
+	}
+
+	// Signal loop: SIGUSR1 dumps the latency, SIGINT/SIGTERM exit
+	int signal = 0;
+	while(sigwait(&signals, &signal) == 0 && signal == SIGUSR1) {
+		DumpLatency(LATENCY_DUMP_PATH);
+	}
+
+	// Signal the serial thread to stop and wait for it to finish
+	LOG_INFO("Exiting...");
+	keepReading = false;
+	if(serialThread.joinable()) { serialThread.join(); }
+	configReloader.Stop();
+	controlServer.Stop();
+
+	// Let the worker finish what is queued
+	mixer->Stop();
+	mixer->ReportStats();
+	if(!options.latencyPath.empty()) { DumpLatency(options.latencyPath); }
+	mixer.reset();
+
+	// Close the replayed log; the device thread closed the boards when it exited
+	replayPort.reset();
+	LOG_INFO("Serial ports closed.");
+
+	// Write what is still queued; the backend disconnects from the server when it goes out of scope
+	Log::Stop();
+
+	return 0;
+}
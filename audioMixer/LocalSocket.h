@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Byte stream to one local process (a Unix domain socket on Linux, a named pipe instance on Windows). Reads and writes
+// never block, so one thread can serve many connections without a slow peer holding it up.
+class LocalConnection {
+public:
+	virtual ~LocalConnection()							= default;
+
+	// Read whatever has arrived; returns the byte count, 0 if nothing is buffered, or -1 once the peer is gone
+	virtual int Read(uint8_t* buffer, size_t size)		= 0;
+
+	// Write as much as the connection accepts right now; returns the bytes taken (possibly 0), or -1 once the peer is gone
+	virtual int Write(const uint8_t* data, size_t size)	= 0;
+};
+
+// Listening endpoint for local clients, reachable only from this machine and, on Linux, only by this user
+class LocalListener {
+public:
+	virtual ~LocalListener()																					   = default;
+
+	// Take a waiting client without blocking; nullptr if there is none
+	virtual std::unique_ptr<LocalConnection> Accept()															   = 0;
+
+	// Block until a client connects, one of the connections (all from Accept) has input, Wake is called, or timeoutMs
+	// elapses (-1 for no timeout)
+	virtual void							 Wait(const std::vector<LocalConnection*>& connections, int timeoutMs) = 0;
+
+	// Make the current Wait, or the next one, return; safe to call from any thread
+	virtual void							 Wake()																   = 0;
+};
+
+// Function to start listening on a local endpoint (socket path or pipe name); returns nullptr on failure
+std::unique_ptr<LocalListener>	 ListenLocal(const std::string& endpoint);
+
+// Function to connect to a local endpoint as a client; returns nullptr if nothing is listening
+std::unique_ptr<LocalConnection> ConnectLocal(const std::string& endpoint);
+
+// Function to get the endpoint the app listens on by default: \\.\pipe\audioMixer on Windows, a socket in
+// $XDG_RUNTIME_DIR (or /tmp) elsewhere
+std::string						 DefaultLocalEndpoint();
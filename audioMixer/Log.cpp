@@ -0,0 +1,283 @@
+#include "Log.h"
+
+#include <array>
+#include <charconv>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+std::atomic<LogLevel> Log::minimumLevel = LogLevel::Info;
+std::atomic<uint32_t> Log::rateLimit	= 20;
+
+namespace {
+	// Single-producer/single-consumer ring: the owning thread advances head, the writer thread advances tail
+	struct ThreadRing {
+		std::atomic<bool>							claimed = false;
+		alignas(64) std::atomic<size_t>				head	= 0;
+		alignas(64) std::atomic<size_t>				tail	= 0;
+		std::array<Log::Record, Log::RING_CAPACITY> records;
+	};
+
+	// Gives the calling thread's ring back when the thread exits; the writer still drains what it left behind
+	struct RingOwner {
+		ThreadRing* ring = nullptr;
+
+		~RingOwner() {
+			if(ring) { ring->claimed.store(false, std::memory_order_release); }
+		}
+	};
+
+	ThreadRing				 rings[Log::MAX_THREADS];
+	thread_local RingOwner	 ringOwner;
+	std::atomic<uint64_t>	 droppedCount = 0;
+	std::atomic<uint32_t>	 writerSignal = 0; // Bumped to wake the writer; it sleeps only while every ring is empty
+
+	// Writer thread state, guarded by writerMutex
+	std::mutex				 writerMutex;
+	std::condition_variable	 writerFlushed;
+	std::thread				 writerThread;
+	bool					 running	   = false;
+	bool					 stopRequested = false;
+	uint64_t				 flushRequests = 0;
+	uint64_t				 flushesDone   = 0;
+
+	// Only touched by the writer thread while it runs
+	LogOptions				 options;
+	std::ofstream			 file;
+	int64_t					 startedNs	   = 0;
+	uint64_t				 droppedSeen   = 0;
+	std::vector<Log::Record> batch;
+
+	const char* LevelName(const LogLevel level) {
+		switch(level) {
+			case LogLevel::Debug: return "DEBUG";
+			case LogLevel::Info: return "INFO ";
+			case LogLevel::Warning: return "WARN ";
+			case LogLevel::Error: return "ERROR";
+		}
+		return "?????";
+	}
+
+	// Function to append one argument of a record
+	void AppendArgument(std::string& out, const Log::Record& record, const size_t index) {
+		const Log::Record::Argument& argument = record.arguments[index];
+		char						 number[32];
+		switch(record.types[index]) {
+			case Log::ArgumentType::Signed: out.append(number, std::to_chars(number, number + sizeof(number), argument.signedValue).ptr); break;
+			case Log::ArgumentType::Unsigned: out.append(number, std::to_chars(number, number + sizeof(number), argument.unsignedValue).ptr); break;
+			case Log::ArgumentType::Float: {
+				// %g prints what the iostream default formatting did
+				const int size = std::snprintf(number, sizeof(number), "%g", argument.floatValue);
+				out.append(number, static_cast<size_t>(std::clamp(size, 0, static_cast<int>(sizeof(number) - 1))));
+				break;
+			}
+			case Log::ArgumentType::Bool: out += argument.unsignedValue ? "true" : "false"; break;
+			case Log::ArgumentType::Text: out.append(record.text + argument.text.offset, argument.text.size); break;
+		}
+	}
+
+	// Function to substitute the arguments into the format, one per "{}"
+	void AppendMessage(std::string& out, const Log::Record& record) {
+		size_t argument = 0;
+		for(const char* c = record.format; *c; ++c) {
+			if(c[0] == '{' && c[1] == '}' && argument < record.argumentCount) {
+				AppendArgument(out, record, argument++);
+				++c;
+			} else {
+				out += *c;
+			}
+		}
+		if(record.suppressed > 0) {
+			out += " (";
+			out += std::to_string(record.suppressed);
+			out += " similar messages suppressed)";
+		}
+	}
+
+	// Function to take every committed record off the rings, oldest first
+	void DrainRings() {
+		batch.clear();
+		for(ThreadRing& ring : rings) {
+			const size_t tail = ring.tail.load(std::memory_order_relaxed);
+			const size_t head = ring.head.load(std::memory_order_acquire);
+			for(size_t i = tail; i != head; ++i) {
+				batch.push_back(ring.records[i % Log::RING_CAPACITY]);
+			}
+			ring.tail.store(head, std::memory_order_release);
+		}
+
+		// Each ring is in order already; this interleaves the threads
+		std::stable_sort(batch.begin(), batch.end(), [](const Log::Record& a, const Log::Record& b) { return a.timestampNs < b.timestampNs; });
+	}
+
+	// Function to tell whether a record was committed that the writer has not taken yet
+	bool RingsEmpty() {
+		for(const ThreadRing& ring : rings) {
+			if(ring.head.load(std::memory_order_acquire) != ring.tail.load(std::memory_order_relaxed)) { return false; }
+		}
+		return true;
+	}
+
+	// Function to wake the writer; a notify with nobody waiting does not make a syscall
+	void WakeWriter() {
+		writerSignal.fetch_add(1, std::memory_order_release);
+		writerSignal.notify_one();
+	}
+
+	// Function to format and write one batch
+	void WriteRecords() {
+		DrainRings();
+		if(!options.console && !file.is_open()) { return; }
+
+		std::string line;
+		bool		wroteOut = false;
+		bool		wroteErr = false;
+		for(const Log::Record& record : batch) {
+			line.clear();
+			AppendMessage(line, record);
+			line += '\n';
+			if(options.console) {
+				const bool error = record.level >= LogLevel::Warning;
+				(error ? std::cerr : std::cout) << line;
+				(error ? wroteErr : wroteOut) = true;
+			}
+			if(file.is_open()) {
+				char prefix[48];
+				const int size = std::snprintf(prefix, sizeof(prefix), "[%12.6f] %s ", (record.timestampNs - startedNs) / 1e9, LevelName(record.level));
+				file.write(prefix, std::clamp(size, 0, static_cast<int>(sizeof(prefix) - 1)));
+				file << line;
+			}
+		}
+
+		const uint64_t dropped = droppedCount.load(std::memory_order_relaxed);
+		if(dropped != droppedSeen) {
+			const std::string message = "Log: " + std::to_string(dropped - droppedSeen) + " records dropped (ring full or too many threads)\n";
+			if(options.console) {
+				std::cerr << message;
+				wroteErr = true;
+			}
+			if(file.is_open()) { file << message; }
+			droppedSeen = dropped;
+		}
+
+		if(wroteOut) { std::cout.flush(); }
+		if(wroteErr) { std::cerr.flush(); }
+		if(file.is_open()) { file.flush(); }
+	}
+
+	void WriterLoop() {
+		while(true) {
+			// Read before the requests, so a flush or stop asked for after them changes it and the wait below returns
+			const uint32_t	 signal	   = writerSignal.load(std::memory_order_acquire);
+			std::unique_lock lock(writerMutex);
+			const uint64_t	 requested = flushRequests;
+			const bool		 stopping  = stopRequested;
+
+			lock.unlock();
+			WriteRecords();
+			lock.lock();
+
+			flushesDone = requested;
+			writerFlushed.notify_all();
+			if(stopping) { break; }
+			lock.unlock();
+
+			// A record committed to a ring that was not empty yet does not wake the writer, so look again before sleeping.
+			// Pairs with the fence in CommitRecord: either this sees the new head or the committer sees the ring empty.
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if(RingsEmpty()) { writerSignal.wait(signal, std::memory_order_acquire); }
+		}
+	}
+} // namespace
+
+bool Log::Start(const LogOptions& startOptions) {
+	std::lock_guard lock(writerMutex);
+	if(running) { return false; }
+
+	options = startOptions;
+	if(!options.filePath.empty()) {
+		file.open(options.filePath, std::ios::app);
+		if(!file.is_open()) {
+			std::cerr << "Unable to open log file " << options.filePath << "." << std::endl;
+			return false;
+		}
+	}
+	minimumLevel.store(options.level, std::memory_order_relaxed);
+	rateLimit.store(options.rateLimitPerSecond, std::memory_order_relaxed);
+	startedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	batch.reserve(MAX_THREADS * RING_CAPACITY);
+
+	// An early return from main still writes what was queued, and never leaves the writer thread joinable
+	static const bool stopAtExit = std::atexit(Stop) == 0;
+	(void)stopAtExit;
+
+	stopRequested = false;
+	running		  = true;
+	writerThread  = std::thread(WriterLoop);
+	return true;
+}
+
+void Log::Stop() {
+	{
+		std::lock_guard lock(writerMutex);
+		if(!running) { return; }
+		stopRequested = true;
+	}
+	WakeWriter();
+	writerThread.join();
+
+	std::lock_guard lock(writerMutex);
+	running = false;
+	file.close();
+}
+
+void Log::Flush() {
+	std::unique_lock lock(writerMutex);
+	if(!running) { return; }
+	const uint64_t target = ++flushRequests;
+	WakeWriter();
+	writerFlushed.wait(lock, [target] { return flushesDone >= target || !running; });
+}
+
+uint64_t Log::DroppedCount() { return droppedCount.load(std::memory_order_relaxed); }
+
+Log::Record* Log::BeginRecord() {
+	ThreadRing* ring = ringOwner.ring;
+	if(!ring) {
+		for(ThreadRing& candidate : rings) {
+			bool expected = false;
+			if(candidate.claimed.compare_exchange_strong(expected, true, std::memory_order_acquire)) {
+				ring = &candidate;
+				break;
+			}
+		}
+		if(!ring) {
+			droppedCount.fetch_add(1, std::memory_order_relaxed);
+			return nullptr;
+		}
+		ringOwner.ring = ring;
+	}
+
+	const size_t head = ring->head.load(std::memory_order_relaxed);
+	if(head - ring->tail.load(std::memory_order_acquire) >= RING_CAPACITY) {
+		droppedCount.fetch_add(1, std::memory_order_relaxed);
+		return nullptr;
+	}
+	return &ring->records[head % RING_CAPACITY];
+}
+
+void Log::CommitRecord(const LogLevel level) {
+	ThreadRing*	 ring = ringOwner.ring;
+	const size_t head = ring->head.load(std::memory_order_relaxed);
+	ring->head.store(head + 1, std::memory_order_release);
+
+	// The writer sleeps only once every ring is empty, so only the first record since it drained this ring has to wake it;
+	// warnings and errors wake it regardless so they are written at once
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if(ring->tail.load(std::memory_order_relaxed) == head || level >= LogLevel::Warning) { WakeWriter(); }
+}
@@ -0,0 +1,180 @@
+// Asynchronous logger for the control path. A call site copies its arguments into a fixed-size record in a ring owned
+// by the calling thread; a background thread drains every ring, formats the records and writes them to the console
+// and, if configured, a file. Logging never allocates or locks at the call site, so it is safe in the keyboard hook and
+// the audio worker. The writer sleeps until there is something to write: a thread's first record since the writer last
+// drained its ring, or any warning or error, wakes it, which costs a futex wake only when it is actually asleep.
+//
+//   LOG_INFO("Set volume for {} to {}%", applicationName, volume * 100);
+//
+// The format is a string literal with one "{}" per argument. Arguments are integers, floating point numbers, bools and
+// strings; strings are copied into the record and truncated if the record runs out of room. Each call site is rate
+// limited on its own, so an error repeated in a tight loop costs a counter increment and shows up once per window
+// with the number of messages it stood for. A record that finds its thread's ring full is dropped and counted.
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+enum class LogLevel : uint8_t {
+	Debug,
+	Info,
+	Warning,
+	Error,
+};
+
+struct LogOptions {
+	LogLevel	level			   = LogLevel::Info;
+	bool		console			   = true; // Debug and info to stdout, warnings and errors to stderr
+	std::string	filePath;				   // Also append every record, with a timestamp and level, to this file
+	uint32_t	rateLimitPerSecond = 20;   // Records per call site and second, 0 for no limit
+};
+
+namespace Log {
+	constexpr size_t MAX_ARGUMENTS = 8;
+	constexpr size_t TEXT_CAPACITY = 96;  // Bytes of string arguments per record
+	constexpr size_t RING_CAPACITY = 256; // Records per thread
+	constexpr size_t MAX_THREADS   = 16;  // Threads that can log at the same time; records from any more are dropped
+
+	// Per call site state, created by the LOG_ macros as a function-local static
+	struct Site {
+		constexpr explicit Site(const LogLevel level) : level(level) {}
+
+		const LogLevel		  level;
+		std::atomic<int64_t>  windowStartNs = 0;
+		std::atomic<uint32_t> windowCount	= 0;
+		std::atomic<uint32_t> suppressed	= 0; // Records refused by the rate limit since the last one written
+	};
+
+	enum class ArgumentType : uint8_t {
+		Signed,
+		Unsigned,
+		Float,
+		Bool,
+		Text,
+	};
+
+	struct Record {
+		int64_t		 timestampNs;
+		const char*	 format;
+		LogLevel	 level;
+		uint8_t		 argumentCount;
+		uint8_t		 textSize;
+		ArgumentType types[MAX_ARGUMENTS];
+		uint32_t	 suppressed;
+
+		union Argument {
+			int64_t	 signedValue;
+			uint64_t unsignedValue;
+			double	 floatValue;
+			struct {
+				uint8_t offset;
+				uint8_t size;
+			} text;
+		} arguments[MAX_ARGUMENTS];
+
+		char text[TEXT_CAPACITY];
+	};
+
+	static_assert(std::is_trivially_copyable_v<Record> && sizeof(Record) <= 192);
+
+	extern std::atomic<LogLevel> minimumLevel;
+	extern std::atomic<uint32_t> rateLimit;
+
+	// Function to start the writer thread; records logged before are kept (as far as the rings hold them) and written first
+	bool		Start(const LogOptions& options);
+
+	// Function to write everything logged so far and stop the writer thread
+	void		Stop();
+
+	// Function to wait until the writer has written everything logged before the call; returns at once if not started
+	void		Flush();
+
+	// Records dropped because a ring was full or every ring was taken
+	uint64_t	DroppedCount();
+
+	// Function to get the ring of the calling thread, claiming one on its first record; nullptr if none is free
+	Record*		BeginRecord();
+
+	// Function to hand the record from BeginRecord to the writer, waking it if needed
+	void		CommitRecord(LogLevel level);
+
+	// Function to decide whether a call site may log now, counting the record as suppressed if not
+	inline bool Allow(Site& site, const int64_t nowNs) {
+		const uint32_t limit = rateLimit.load(std::memory_order_relaxed);
+		if(limit == 0) { return true; }
+
+		int64_t windowStart = site.windowStartNs.load(std::memory_order_relaxed);
+		if(nowNs - windowStart >= 1'000'000'000 && site.windowStartNs.compare_exchange_strong(windowStart, nowNs, std::memory_order_relaxed)) {
+			site.windowCount.store(0, std::memory_order_relaxed);
+		}
+		if(site.windowCount.fetch_add(1, std::memory_order_relaxed) < limit) { return true; }
+		site.suppressed.fetch_add(1, std::memory_order_relaxed);
+		return false;
+	}
+
+	// Function to copy one argument into the record
+	template <typename T> void Encode(Record& record, const size_t index, const T& value) {
+		using Type				   = std::decay_t<T>;
+		Record::Argument& argument = record.arguments[index];
+		if constexpr(std::is_same_v<Type, bool>) {
+			record.types[index]	   = ArgumentType::Bool;
+			argument.unsignedValue = value ? 1 : 0;
+		} else if constexpr(std::is_integral_v<Type> && std::is_signed_v<Type>) {
+			record.types[index]	 = ArgumentType::Signed;
+			argument.signedValue = value;
+		} else if constexpr(std::is_integral_v<Type> || std::is_enum_v<Type>) {
+			record.types[index]	   = ArgumentType::Unsigned;
+			argument.unsignedValue = static_cast<uint64_t>(value);
+		} else if constexpr(std::is_floating_point_v<Type>) {
+			record.types[index] = ArgumentType::Float;
+			argument.floatValue = value;
+		} else {
+			const std::string_view text = value;
+			const size_t		   size = std::min(text.size(), TEXT_CAPACITY - record.textSize);
+			std::memcpy(record.text + record.textSize, text.data(), size);
+			record.types[index]	  = ArgumentType::Text;
+			argument.text.offset  = record.textSize;
+			argument.text.size	  = static_cast<uint8_t>(size);
+			record.textSize		 += static_cast<uint8_t>(size);
+		}
+	}
+
+	template <typename... Args> void Write(Site& site, const char* format, const Args&... args) {
+		static_assert(sizeof...(Args) <= MAX_ARGUMENTS, "too many log arguments");
+		if(site.level < minimumLevel.load(std::memory_order_relaxed)) { return; }
+
+		const int64_t nowNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+		if(!Allow(site, nowNs)) { return; }
+		Record* record = BeginRecord();
+		if(!record) { return; }
+
+		record->timestampNs	  = nowNs;
+		record->format		  = format;
+		record->level		  = site.level;
+		record->argumentCount = static_cast<uint8_t>(sizeof...(Args));
+		record->textSize	  = 0;
+		record->suppressed	  = site.suppressed.exchange(0, std::memory_order_relaxed);
+		size_t index		  = 0;
+		(Encode(*record, index++, args), ...);
+		CommitRecord(site.level);
+	}
+} // namespace Log
+
+// The format must be a string literal; the record keeps a pointer to it
+#define LOG_AT(level, ...)                \
+	do {                                  \
+		static Log::Site logSite(level);  \
+		Log::Write(logSite, __VA_ARGS__); \
+	} while(false)
+
+#define LOG_DEBUG(...)	 LOG_AT(LogLevel::Debug, __VA_ARGS__)
+#define LOG_INFO(...)	 LOG_AT(LogLevel::Info, __VA_ARGS__)
+#define LOG_WARNING(...) LOG_AT(LogLevel::Warning, __VA_ARGS__)
+#define LOG_ERROR(...)	 LOG_AT(LogLevel::Error, __VA_ARGS__)
@@ -0,0 +1,220 @@
+#include "MixerConfig.h"
+#include "KeyNames.h"
+#include "Log.h"
+#include "MixerState.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <nlohmann/json.hpp>
+
+#ifdef _WIN32
+	#include <windows.h>
+#endif
+
+using json = nlohmann::json;
+
+// Function to map key names to virtual key codes
+int GetVirtualKeyCode(const std::string_view keyName) {
+	if(const auto vkCode = FindVirtualKey(keyName)) return *vkCode;
+
+#ifdef _WIN32
+	// Symbol keys depend on the keyboard layout
+	if(keyName.length() == 1) {
+		HKL			hklLayout = GetKeyboardLayout(0);
+		const SHORT vk		  = VkKeyScanExA(keyName[0], hklLayout);
+		if(vk != -1) return vk & 0xFF;
+	}
+#endif
+
+	// If key not found, return 0
+	return 0;
+}
+
+// Function to parse key combination strings
+bool ParseKeyCombination(const std::string_view keyCombinationStr, KeyMask& keyCombination) {
+	size_t start = 0;
+	while(start < keyCombinationStr.size()) {
+		const size_t		   end	  = std::min(keyCombinationStr.find('+', start), keyCombinationStr.size());
+		const std::string_view key	  = keyCombinationStr.substr(start, end - start);
+		const int			   vkCode = GetVirtualKeyCode(key);
+		if(vkCode == 0) {
+			LOG_ERROR("Invalid key in combination: {}", key);
+			return false;
+		}
+		keyCombination.set(vkCode);
+		start = end + 1;
+	}
+	return true;
+}
+
+namespace {
+	// Function to append a key's config name, or its VK code if it has none, to a "+"-separated combination
+	void AppendKeyName(std::string& text, const uint32_t vkCode) {
+		if(!text.empty()) { text += '+'; }
+
+		const std::string_view name = GetVirtualKeyName(vkCode);
+		if(!name.empty()) {
+			text += name;
+			return;
+		}
+
+		constexpr char HEX_DIGITS[] = "0123456789ABCDEF";
+		text += "VK_0x";
+		text += HEX_DIGITS[vkCode >> 4];
+		text += HEX_DIGITS[vkCode & 0xF];
+	}
+} // namespace
+
+// Function to format a key combination for messages, e.g. "Ctrl+Alt+Up"
+std::string FormatKeyCombination(const KeyMask& keyCombination) {
+	// Modifiers first, in the order people write them; the other keys follow in VK order
+	constexpr uint8_t MODIFIERS[] = {VirtualKey::Control, VirtualKey::Menu, VirtualKey::Shift, VirtualKey::LWin, VirtualKey::RWin};
+
+	std::string		  text;
+	for(const uint8_t modifier : MODIFIERS) {
+		if(keyCombination.test(modifier)) { AppendKeyName(text, modifier); }
+	}
+	for(uint32_t vkCode = 0; vkCode < keyCombination.size(); ++vkCode) {
+		if(keyCombination.test(vkCode) && std::ranges::find(MODIFIERS, vkCode) == std::end(MODIFIERS)) { AppendKeyName(text, vkCode); }
+	}
+	return text;
+}
+
+// Function to read and parse the configuration file
+bool ReadConfig(const std::string& configFile, MixerConfig& config) {
+	std::ifstream inFile(configFile);
+	if(!inFile.is_open()) {
+		LOG_ERROR("Unable to open config file {}.", configFile);
+		return false;
+	}
+
+	try {
+		json j;
+		inFile >> j;
+
+		if(j.contains("max_volume_updates_per_second")) { config.maxVolumeUpdatesPerSecond = std::max(1, j["max_volume_updates_per_second"].get<int>()); }
+
+		// A board without "first_channel" continues where the previous one ended
+		if(j.contains("devices")) {
+			size_t nextChannel = 0;
+			for(const auto& device : j["devices"]) {
+				DeviceConfig deviceConfig;
+				deviceConfig.portName = device["port"].get<std::string>();
+				if(device.contains("baud_rate")) { deviceConfig.baudRate = device["baud_rate"].get<int>(); }
+				if(device.contains("channel_count")) { deviceConfig.channelCount = std::min<size_t>(device["channel_count"].get<size_t>(), MIXER_MAX_CHANNELS); }
+				deviceConfig.firstChannel = device.contains("first_channel") ? device["first_channel"].get<size_t>() : nextChannel;
+				nextChannel				  = deviceConfig.firstChannel + deviceConfig.channelCount;
+				if(nextChannel > MixerState::MAX_CHANNELS) {
+					LOG_ERROR("Device {} is mapped past channel {}.", deviceConfig.portName, MixerState::MAX_CHANNELS - 1);
+					return false;
+				}
+
+				for(const DeviceConfig& other : config.devices) {
+					if(deviceConfig.firstChannel < other.firstChannel + other.channelCount && other.firstChannel < nextChannel) {
+						LOG_ERROR("Devices {} and {} are mapped to overlapping channels.", other.portName, deviceConfig.portName);
+						return false;
+					}
+				}
+				config.devices.push_back(deviceConfig);
+			}
+		}
+
+		// Global channels: one board's worth, or as far as the configured boards reach
+		size_t channelLimit = MIXER_MAX_CHANNELS;
+		for(const DeviceConfig& device : config.devices) {
+			channelLimit = std::max(channelLimit, device.firstChannel + device.channelCount);
+		}
+		if(j.contains("channel_count")) {
+			config.channelCount = j["channel_count"].get<size_t>();
+			if(config.channelCount > channelLimit) {
+				LOG_ERROR("channel_count {} is more than the {} channels available.", config.channelCount, channelLimit);
+				return false;
+			}
+		}
+
+		const auto& apps = j["applications"];
+		for(const auto& app : apps) {
+			// "endpoint" controls a device's own volume: "master" for the default output, or a device ID or friendly name.
+			// Otherwise "application_name" is controlled on "device", or on the default output if none is given; it can be a
+			// glob, path, title or regex pattern (see ApplicationMatcher.h).
+			ApplicationConfig appConfig;
+			if(app.contains("endpoint")) {
+				const std::string endpoint = app["endpoint"].get<std::string>();
+				appConfig.target.device	   = endpoint == "master" ? "" : endpoint;
+				appConfig.applicationName  = endpoint;
+			} else {
+				appConfig.applicationName		 = app["application_name"].get<std::string>();
+				appConfig.target.applicationName = appConfig.applicationName;
+				if(app.contains("device")) { appConfig.target.device = app["device"].get<std::string>(); }
+			}
+			appConfig.potNumber = app["pot_number"].get<int>();
+			if(appConfig.potNumber < -1 || appConfig.potNumber >= static_cast<int>(channelLimit)) {
+				LOG_ERROR("pot_number {} of {} must be -1 or a channel from 0 to {}.", appConfig.potNumber, appConfig.applicationName, channelLimit - 1);
+				return false;
+			}
+
+			if(app.contains("volume_up_key") && app.contains("volume_down_key")) {
+				std::string volUpKeyStr	  = app["volume_up_key"].get<std::string>();
+				std::string volDownKeyStr = app["volume_down_key"].get<std::string>();
+
+				if(!ParseKeyCombination(volUpKeyStr, appConfig.volumeUpKeyCombination)) return false;
+				if(!ParseKeyCombination(volDownKeyStr, appConfig.volumeDownKeyCombination)) return false;
+			} else {
+				LOG_WARNING("Volume up/down keys not set for application: {}", appConfig.applicationName);
+			}
+
+			config.applications.push_back(appConfig);
+		}
+	} catch(json::exception& e) {
+		LOG_ERROR("Error parsing config file: {}", e.what());
+		return false;
+	} catch(std::exception& e) {
+		// Anything else thrown while reading; a reload must not take the watcher thread down
+		LOG_ERROR("Error reading config file: {}", e.what());
+		return false;
+	}
+
+	return true;
+}
+
+// Function to build the hotkey matcher and channel router from the parsed applications
+bool CompileConfig(MixerConfig& config) {
+	// Hotkeys
+	config.keyBindings.Clear();
+	for(size_t appIndex = 0; appIndex < config.applications.size(); ++appIndex) {
+		const ApplicationConfig& app = config.applications[appIndex];
+		config.keyBindings.AddBinding(app.volumeUpKeyCombination, static_cast<uint16_t>(appIndex), 0.1f);	 // Increase volume by 10%
+		config.keyBindings.AddBinding(app.volumeDownKeyCombination, static_cast<uint16_t>(appIndex), -0.1f); // Decrease volume by 10%
+	}
+	config.keyBindings.Build();
+
+	// Pot channel -> application routing table
+	std::vector<int> appChannels;
+	appChannels.reserve(config.applications.size());
+	for(const ApplicationConfig& app : config.applications) {
+		appChannels.push_back(app.potNumber);
+	}
+	config.channelRouter.Build(appChannels, config.channelCount);
+
+	// Application patterns, so sessions are matched against a prebuilt index and not the raw strings
+	auto applicationMatcher = std::make_shared<ApplicationMatcher>();
+	for(const ApplicationConfig& app : config.applications) {
+		std::string error;
+		if(!app.target.IsEndpoint() && !applicationMatcher->AddPattern(app.target.applicationName, error)) {
+			LOG_ERROR("Invalid application pattern {}: {}", app.target.applicationName, error);
+			return false;
+		}
+	}
+	applicationMatcher->Build();
+	config.applicationMatcher = std::move(applicationMatcher);
+	return true;
+}
+
+// Function to read and compile a config; returns nullptr on any error
+std::unique_ptr<MixerConfig> LoadConfig(const std::string& configFile) {
+	auto config = std::make_unique<MixerConfig>();
+	if(!ReadConfig(configFile, *config)) { return nullptr; }
+	if(!CompileConfig(*config)) { return nullptr; }
+	return config;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "ApplicationMatcher.h"
+#include "ChannelRouter.h"
+#include "KeyBindingMatcher.h"
+#include "VolumeTarget.h"
+#include "mixer_protocol.h"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Struct to hold application configurations. Despite the name an entry can also control a device's own volume (master
+// volume, mic gain); applicationName is then the name it is shown under.
+struct ApplicationConfig {
+	std::string	 applicationName;
+	VolumeTarget target;
+	KeyMask		 volumeUpKeyCombination;
+	KeyMask		 volumeDownKeyCombination;
+	int			 potNumber = -1; // For serial input mapping
+};
+
+// A mixer board and the block of global channels its pots are mapped to. pot_number in the applications refers to the
+// global channel, so with two five-pot boards the second board's first pot is channel 5.
+struct DeviceConfig {
+	std::string portName;
+	int			baudRate	 = 115200;
+	size_t		firstChannel = 0;				   // Global channel of the board's channel 0
+	size_t		channelCount = MIXER_MAX_CHANNELS; // Channels the board may send; higher ones are ignored
+};
+
+// Everything read from audio_conf.json plus the lookup tables compiled from it. A config is never modified once loaded;
+// a reload builds a new one and publishes it in place of the old.
+struct MixerConfig {
+	std::vector<ApplicationConfig> applications;
+	std::vector<DeviceConfig>	   devices;						   // From "devices"; read once at startup, empty if not configured
+	size_t						   channelCount				 = 0;  // From "channel_count"; grows to fit the highest pot_number
+	int							   maxVolumeUpdatesPerSecond = 60; // Per application; intermediate values are coalesced
+	uint64_t					   generation				 = 0;  // Incremented per load, so readers can tell configs apart
+
+	KeyBindingMatcher						  keyBindings;		  // Hotkeys of every application
+	ChannelRouter							  channelRouter;	  // Pot channel -> bound applications (copied by the serial thread, which owns the last values)
+	std::shared_ptr<const ApplicationMatcher> applicationMatcher; // Glob, path, title and regex application names; handed to the backend
+};
+
+// Function to map key names to virtual key codes; returns 0 for an unknown name
+int							 GetVirtualKeyCode(std::string_view keyName);
+
+// Function to parse key combination strings
+bool						 ParseKeyCombination(std::string_view keyCombinationStr, KeyMask& keyCombination);
+
+// Function to format a key combination for messages, e.g. "Ctrl+Alt+Up"
+std::string					 FormatKeyCombination(const KeyMask& keyCombination);
+
+// Function to read and parse the configuration file
+bool						 ReadConfig(const std::string& configFile, MixerConfig& config);
+
+// Function to build the hotkey matcher, channel router and application patterns from the parsed applications; false if
+// a pattern is malformed
+bool						 CompileConfig(MixerConfig& config);
+
+// Function to read and compile a config; returns nullptr on any error
+std::unique_ptr<MixerConfig> LoadConfig(const std::string& configFile);
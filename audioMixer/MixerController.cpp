@@ -0,0 +1,136 @@
+#include "MixerController.h"
+#include "Log.h"
+
+#include <algorithm>
+
+void MixerController::PublishConfig(std::unique_ptr<MixerConfig> newConfig) {
+	const uint64_t generation = ++configGeneration;
+	newConfig->generation	  = generation;
+	if(sharedState) { sharedState->PublishConfig(*newConfig); }
+
+	// Patterns first, so the sessions are filed under the new config's keys by the time its targets are used
+	backend.SetApplicationMatcher(newConfig->applicationMatcher);
+	config.Publish(std::move(newConfig));
+	state.SetConfigGeneration(generation);
+}
+
+void MixerController::Start() {
+	if(audioWorker) { return; }
+
+	// Read once; changing the rate limit needs a restart
+	int maxVolumeUpdatesPerSecond = 60;
+	if(const auto liveConfig = config.Read(CONFIG_READER_INPUT)) { maxVolumeUpdatesPerSecond = liveConfig->maxVolumeUpdatesPerSecond; }
+
+	// Every volume change goes through the worker, which orders pot and hotkey changes and rate-limits them per app
+	audioWorker = std::make_unique<AudioWorker>(
+		backend, [this](const std::span<const VolumeCommand> commands) { ApplyCommands(commands); },
+		[this] {
+			const auto liveConfig = config.Read(CONFIG_READER_AUDIO);
+			return liveConfig ? AudioWorker::ConfigInfo{liveConfig->generation, liveConfig->applications.size()} : AudioWorker::ConfigInfo{};
+		},
+		std::chrono::nanoseconds(std::chrono::seconds(1)) / maxVolumeUpdatesPerSecond, &latency);
+	audioWorker->Start();
+}
+
+void MixerController::Stop() {
+	if(audioWorker) { audioWorker->Stop(); }
+}
+
+void MixerController::ApplyCommands(const std::span<const VolumeCommand> commands) {
+	const auto liveConfig = config.Read(CONFIG_READER_AUDIO);
+	if(!liveConfig) { return; }
+
+	// Absolute volumes (pots, control clients) go to the backend as one batch; an adjustment needs the target's current
+	// volume, so each one is its own call
+	volumeBatch.clear();
+	volumeBatchApplications.clear();
+	for(const VolumeCommand& command : commands) {
+		// A command queued just before a reload may name an application the new config no longer has
+		if(command.applicationIndex >= liveConfig->applications.size()) { continue; }
+
+		const VolumeTarget& target = liveConfig->applications[command.applicationIndex].target;
+		if(command.type == VolumeCommand::Type::Set) {
+			volumeBatch.push_back({&target, command.value});
+			volumeBatchApplications.push_back(command.applicationIndex);
+			continue;
+		}
+
+		// An adjustment's target is only known once the backend has applied it; -1 means unknown / failed
+		float volume = 0.0f;
+		if(!backend.AdjustVolume(target, command.value, &volume)) { volume = -1.0f; }
+		PublishVolume(*liveConfig, command.applicationIndex, volume, volume);
+	}
+
+	if(volumeBatch.empty()) { return; }
+	backend.SetVolumes(volumeBatch);
+	for(size_t i = 0; i < volumeBatch.size(); ++i) {
+		PublishVolume(*liveConfig, volumeBatchApplications[i], volumeBatch[i].volume, volumeBatch[i].applied ? volumeBatch[i].volume : -1.0f);
+	}
+}
+
+// Function to record the outcome of a volume command; applied is negative if the backend call failed
+void MixerController::PublishVolume(const MixerConfig& liveConfig, const uint16_t applicationIndex, const float target, const float applied) {
+	if(applied >= 0.0f) { state.SetVolume(applicationIndex, applied); }
+	if(sharedState) { sharedState->SetVolume(liveConfig.generation, applicationIndex, target, applied); }
+}
+
+bool MixerController::SubmitVolume(const uint16_t applicationIndex, const float volume) {
+	return audioWorker && audioWorker->Submit({.type = VolumeCommand::Type::Set, .applicationIndex = applicationIndex, .value = std::clamp(volume, 0.0f, 1.0f)});
+}
+
+void MixerController::KeyDown(const uint32_t vkCode) {
+	keyboardState.KeyDown(vkCode);
+
+	// Only queue the change here; a hook that takes too long is silently removed by Windows
+	const auto liveConfig = config.Read(CONFIG_READER_INPUT);
+	liveConfig->keyBindings.ForEachTriggered(vkCode, keyboardState.PressedKeys(), [this](const KeyBinding& binding) {
+		audioWorker->Submit({.type = VolumeCommand::Type::Adjust, .applicationIndex = binding.applicationIndex, .value = binding.delta});
+	});
+}
+
+void MixerController::KeyUp(const uint32_t vkCode) { keyboardState.KeyUp(vkCode); }
+
+void MixerController::ApplyPotFrame(const MixerFrame& frame, const size_t firstChannel, const size_t channelCount) {
+	const auto liveConfig = config.Read(CONFIG_READER_SERIAL);
+	if(potState.configGeneration != liveConfig->generation) {
+		potState.configGeneration = liveConfig->generation;
+		potState.channelRouter	  = liveConfig->channelRouter;
+		potState.volumePercentage.assign(liveConfig->applications.size(), -1.0f);
+	}
+
+	// Queue the new volume of an application whose potentiometer moved
+	const auto submitVolume = [&](const uint16_t appIndex, const uint16_t value) {
+		const float volume = static_cast<float>(value) / MIXER_VALUE_MAX;
+		LOG_INFO("Set volume for {} from {} to {}%", liveConfig->applications[appIndex].applicationName, potState.volumePercentage[appIndex] * 100,
+				 volume * 100);
+		potState.volumePercentage[appIndex] = volume;
+
+		const auto routedAt = std::chrono::steady_clock::now();
+		potState.routedCommands.push_back({VolumeCommand::Type::Set, appIndex, volume, frame.receivedAt, routedAt});
+		latency.RecordRouted(frame, routedAt);
+	};
+
+	potState.routedCommands.clear();
+
+	if(sharedState) { sharedState->BeginFrame(); }
+	for(const ChannelValue& update : frame.updates) {
+		if(update.channel >= channelCount) { continue; }
+
+		// Only the applications bound to this potentiometer are touched, and only if its value moved
+		const size_t channel = firstChannel + update.channel;
+		const bool	 moved	 = potState.channelRouter.Route(channel, update.value, submitVolume);
+		if(moved) { state.SetChannel(channel, update.value); }
+		if(sharedState) { sharedState->SetChannel(channel, update.value, moved); }
+	}
+	if(sharedState) { sharedState->EndFrame(frame.deviceTimestampUs, frame.updates.size()); }
+
+	// One wakeup for the whole frame, so the worker applies its changes as one batch
+	if(!potState.routedCommands.empty()) { audioWorker->Submit(potState.routedCommands); }
+}
+
+void MixerController::ReportStats() const {
+	if(!audioWorker) { return; }
+	const VolumeSchedulerStats volumeStats = audioWorker->SchedulerStats();
+	LOG_INFO("Volume commands: {} from pots, {} from hotkeys, {} applied, {} dropped", volumeStats.setReceived, volumeStats.adjustReceived, volumeStats.applied,
+			 audioWorker->DroppedCount());
+}
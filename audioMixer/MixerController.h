@@ -0,0 +1,95 @@
+#pragma once
+
+#include "AudioBackend.h"
+#include "AudioWorker.h"
+#include "FrameParser.h"
+#include "MixerConfig.h"
+#include "MixerState.h"
+#include "PipelineLatency.h"
+#include "RcuPointer.h"
+#include "SharedStateWriter.h"
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <vector>
+
+// The host control path without any platform code: the live config, hotkey matching, pot routing and the audio worker
+// that applies every volume change through the backend. WinMain only wires the keyboard hook, serial port and tray to
+// it, so the same path runs against MockAudioBackend in the benchmarks.
+class MixerController {
+public:
+	// Threads that read the live config; each owns one RCU reader slot
+	enum ConfigReader : size_t {
+		CONFIG_READER_INPUT,   // Message loop and keyboard hook
+		CONFIG_READER_SERIAL,  // Serial reader
+		CONFIG_READER_AUDIO,   // Audio worker
+		CONFIG_READER_CONTROL, // Control server
+		CONFIG_READER_COUNT
+	};
+
+	using ConfigPointer = RcuPointer<MixerConfig, CONFIG_READER_COUNT>;
+
+	// sharedState, if given, is kept up to date with the config, channel values and applied volumes
+	explicit MixerController(AudioBackend& backend, SharedStateWriter* sharedState = nullptr) : backend(backend), sharedState(sharedState) {}
+
+	~MixerController() { Stop(); }
+
+	// Make a loaded config the live one. Safe to call while the other threads are running.
+	void					 PublishConfig(std::unique_ptr<MixerConfig> config);
+
+	// Start the audio worker; its rate limit comes from the config published first
+	void					 Start();
+
+	// Apply everything already queued and stop the audio worker
+	void					 Stop();
+
+	// Keyboard hook thread: returns without blocking, volume changes are only queued
+	void					 KeyDown(uint32_t vkCode);
+	void					 KeyUp(uint32_t vkCode);
+
+	// Serial thread: apply the channel values of one frame to the mapped applications. The board's channels are mapped to
+	// the global channels [firstChannel, firstChannel + channelCount); anything it sends past its block is ignored.
+	void					 ApplyPotFrame(const MixerFrame& frame, size_t firstChannel = 0, size_t channelCount = MIXER_MAX_CHANNELS);
+
+	// Any thread: queue an absolute volume (0.0 to 1.0) for an application, e.g. on behalf of a control client.
+	// Returns false if the queue is full.
+	bool					 SubmitVolume(uint16_t applicationIndex, float volume);
+
+	ConfigPointer::ReadGuard ReadLiveConfig(const ConfigReader reader) const { return config.Read(reader); }
+
+	// Channel values and applied volumes as they change, for observers such as the control server
+	MixerState&				 State() { return state; }
+
+	PipelineLatency&		 Latency() { return latency; }
+
+	void					 ReportStats() const;
+
+private:
+	// Pot routing state owned by the serial thread. The routing table comes from the live config, but the last routed
+	// values and volumes change per frame, so the thread keeps its own copy and refreshes it when the config is reloaded.
+	struct PotRoutingState {
+		uint64_t				   configGeneration	= 0;
+		ChannelRouter			   channelRouter;	 // Pot channel -> bound applications
+		std::vector<float>		   volumePercentage; // Current volume per application (0.0 to 1.0, 12-bit resolution from the pots), -1 until the first frame
+		std::vector<VolumeCommand> routedCommands;	 // Volume changes of the frame being routed, queued together once it is done
+	};
+
+	void						 ApplyCommands(std::span<const VolumeCommand> commands);
+	void						 PublishVolume(const MixerConfig& liveConfig, uint16_t applicationIndex, float target, float applied);
+
+	AudioBackend&				 backend;
+	ConfigPointer				 config;
+	std::atomic<uint64_t>		 configGeneration = 0;
+	KeyboardState				 keyboardState; // Held keys; survives config reloads
+	PotRoutingState				 potState;
+	PipelineLatency				 latency; // Pot path timings, from the board's sample to the applied volume
+	MixerState					 state;
+	SharedStateWriter*			 sharedState;
+	std::unique_ptr<AudioWorker> audioWorker;
+
+	// Absolute volumes of the batch being applied, kept between batches so applying one does not allocate
+	std::vector<TargetVolume> volumeBatch;
+	std::vector<uint16_t>	  volumeBatchApplications; // Application index of each entry of volumeBatch
+};
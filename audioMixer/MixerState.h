@@ -0,0 +1,85 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// Latest pot value of every global channel and applied volume of every application, written by the control path and
+// read by observers such as the control server. A writer stores the value and sets its dirty bit, so it never waits
+// and never allocates. The reader collects the dirty bits: however long it takes between two reads, it sees every
+// entry that changed once, with its latest value.
+class MixerState {
+public:
+	static constexpr size_t	  MAX_CHANNELS	   = 1024; // Entries past these limits are not tracked
+	static constexpr size_t	  MAX_APPLICATIONS = 1024;
+	static constexpr uint16_t NO_VALUE		   = 0xFFFF; // Channel not moved / volume not set since the config was loaded
+	static constexpr uint16_t VOLUME_SCALE	   = 10000;	 // Volumes are stored in 0.01% steps
+
+	// Serial thread: a channel moved to value (0 to MIXER_VALUE_MAX)
+	void SetChannel(const size_t channel, const uint16_t value) { channels.Set(channel, value); }
+
+	// Audio worker: an application's volume (0.0 to 1.0) was applied
+	void SetVolume(const size_t applicationIndex, const float volume) {
+		volumes.Set(applicationIndex, static_cast<uint16_t>(std::clamp(volume, 0.0f, 1.0f) * VOLUME_SCALE + 0.5f));
+	}
+
+	// A new config was published. Application indices change meaning, so volumes are forgotten and readers should
+	// start over from a snapshot.
+	void SetConfigGeneration(const uint64_t generation) {
+		volumes.Clear();
+		configGeneration.store(generation, std::memory_order_release);
+	}
+
+	uint16_t Channel(const size_t channel) const { return channels.Get(channel); }
+
+	uint16_t Volume(const size_t applicationIndex) const { return volumes.Get(applicationIndex); }
+
+	uint64_t ConfigGeneration() const { return configGeneration.load(std::memory_order_acquire); }
+
+	// Single reader: call onChange(index) for every channel / application changed since the last call
+	template <typename Callback> void CollectChannels(Callback&& onChange) { channels.Collect(onChange); }
+
+	template <typename Callback> void CollectVolumes(Callback&& onChange) { volumes.Collect(onChange); }
+
+private:
+	template <size_t Size> class Table {
+	public:
+		Table() { Clear(); }
+
+		void Set(const size_t index, const uint16_t value) {
+			if(index >= Size) { return; }
+			values[index].store(value, std::memory_order_relaxed);
+			dirty[index / 64].fetch_or(uint64_t(1) << (index % 64), std::memory_order_release);
+		}
+
+		uint16_t Get(const size_t index) const { return index < Size ? values[index].load(std::memory_order_relaxed) : NO_VALUE; }
+
+		template <typename Callback> void Collect(Callback& onChange) {
+			for(size_t word = 0; word < dirty.size(); ++word) {
+				for(uint64_t bits = dirty[word].exchange(0, std::memory_order_acquire); bits != 0; bits &= bits - 1) {
+					onChange(word * 64 + static_cast<size_t>(std::countr_zero(bits)));
+				}
+			}
+		}
+
+		void Clear() {
+			for(size_t index = 0; index < Size; ++index) {
+				values[index].store(NO_VALUE, std::memory_order_relaxed);
+			}
+			for(std::atomic<uint64_t>& word : dirty) {
+				word.store(0, std::memory_order_release);
+			}
+		}
+
+	private:
+		std::array<std::atomic<uint16_t>, Size>		 values;
+		std::array<std::atomic<uint64_t>, Size / 64> dirty;
+	};
+
+	Table<MAX_CHANNELS>		channels;
+	Table<MAX_APPLICATIONS> volumes;
+	std::atomic<uint64_t>	configGeneration = 0;
+};
@@ -0,0 +1,133 @@
+#include "MockAudioBackend.h"
+
+bool MockAudioBackend::MockSession::GetVolume(float& currentVolume) {
+	if(expired) { return false; }
+	currentVolume = volume;
+	return true;
+}
+
+bool MockAudioBackend::MockSession::SetVolume(const float newVolume) {
+	if(expired) { return false; }
+	volume = newVolume;
+	++backend.setVolumeCount;
+	return true;
+}
+
+MockAudioBackend::MockAudioBackend() {
+	AddDevice(DEFAULT_DEVICE_ID, "Speakers (Mock Audio)");
+	defaultDeviceId = DEFAULT_DEVICE_ID;
+}
+
+void MockAudioBackend::AddDevice(const std::string& id, const std::string& name, const AudioDeviceFlow flow, const float volume) {
+	{
+		std::lock_guard lock(mockMutex);
+		if(devices.contains(id)) { return; }
+		devices[id] = {name, flow, std::make_shared<MockSession>(*this, volume)};
+	}
+
+	// Same effect as IMMNotificationClient::OnDeviceAdded
+	InvalidateDevices();
+}
+
+void MockAudioBackend::RemoveDevice(const std::string& id) {
+	{
+		std::lock_guard lock(mockMutex);
+		const auto		it = devices.find(id);
+		if(it == devices.end()) { return; }
+		it->second.volume->expired = true;
+		devices.erase(it);
+
+		std::erase_if(processes, [&id](const auto& entry) {
+			if(entry.second.deviceId != id) { return false; }
+			entry.second.session->expired = true;
+			return true;
+		});
+	}
+
+	// Same effect as IMMNotificationClient::OnDeviceRemoved followed by the sessions' OnSessionDisconnected
+	InvalidateDevices();
+	InvalidateSessions();
+}
+
+void MockAudioBackend::SetDefaultDevice(const std::string& id) {
+	{
+		std::lock_guard lock(mockMutex);
+		defaultDeviceId = id;
+	}
+
+	// Same effect as IMMNotificationClient::OnDefaultDeviceChanged
+	InvalidateDevices();
+}
+
+uint32_t MockAudioBackend::AddSession(const std::string& processName, const float volume, const std::string& deviceId) {
+	uint32_t processId = 0;
+	{
+		std::lock_guard lock(mockMutex);
+		processId			 = nextProcessId++;
+		processes[processId] = {processName, deviceId, std::make_shared<MockSession>(*this, volume), "", ""};
+	}
+
+	// Same effect as IAudioSessionNotification::OnSessionCreated
+	InvalidateSessions();
+	return processId;
+}
+
+void MockAudioBackend::SetSessionDetails(const uint32_t processId, const std::string& processPath, const std::string& displayName) {
+	{
+		std::lock_guard lock(mockMutex);
+		const auto		it = processes.find(processId);
+		if(it == processes.end()) { return; }
+		it->second.processPath = processPath;
+		it->second.displayName = displayName;
+	}
+
+	// Same effect as IAudioSessionEvents::OnDisplayNameChanged
+	InvalidateSessions();
+}
+
+void MockAudioBackend::ExpireSession(const uint32_t processId, const bool notify) {
+	{
+		std::lock_guard lock(mockMutex);
+		const auto		it = processes.find(processId);
+		if(it == processes.end()) { return; }
+		it->second.session->expired = true;
+		processes.erase(it);
+	}
+
+	// Same effect as IAudioSessionEvents::OnStateChanged(AudioSessionStateExpired)
+	if(notify) { InvalidateSessions(); }
+}
+
+float MockAudioBackend::GetSessionVolume(const uint32_t processId) const {
+	std::lock_guard lock(mockMutex);
+	const auto		it = processes.find(processId);
+	return it != processes.end() ? it->second.session->volume.load() : 0.0f;
+}
+
+float MockAudioBackend::GetDeviceVolume(const std::string& id) const {
+	std::lock_guard lock(mockMutex);
+	const auto		it = devices.find(id);
+	return it != devices.end() ? it->second.volume->volume.load() : 0.0f;
+}
+
+bool MockAudioBackend::EnumerateDevices(std::vector<AudioDeviceEntry>& entries) {
+	std::lock_guard lock(mockMutex);
+	for(const auto& [id, device] : devices) {
+		entries.push_back({id, device.name, device.flow, id == defaultDeviceId, device.volume});
+	}
+	return true;
+}
+
+bool MockAudioBackend::EnumerateSessions(const AudioDeviceEntry& device, std::vector<AudioSessionEntry>& sessions) {
+	std::lock_guard lock(mockMutex);
+	for(const auto& [processId, process] : processes) {
+		if(process.deviceId == device.id) { sessions.push_back({process.processName, processId, process.session, process.displayName}); }
+	}
+	return true;
+}
+
+std::string MockAudioBackend::GetProcessPath(const uint32_t processId) {
+	std::lock_guard lock(mockMutex);
+	const auto		it = processes.find(processId);
+	return it != processes.end() ? it->second.processPath : std::string();
+}
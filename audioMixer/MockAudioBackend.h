@@ -0,0 +1,79 @@
+#pragma once
+
+#include "AudioBackend.h"
+
+#include <map>
+
+// In-memory audio backend used to exercise routing and caching without a sound device. It starts with one output,
+// DEFAULT_DEVICE_ID, which is the default; more render and capture devices can be plugged in and removed.
+class MockAudioBackend : public AudioBackend {
+public:
+	static constexpr const char* DEFAULT_DEVICE_ID = "mock-default";
+
+	MockAudioBackend();
+
+	// Plug in a device, the way a headset would be; does nothing if the ID is taken
+	void	 AddDevice(const std::string& id, const std::string& name, AudioDeviceFlow flow = AudioDeviceFlow::Render, float volume = 1.0f);
+
+	// Unplug a device: its volume and sessions expire
+	void	 RemoveDevice(const std::string& id);
+
+	void	 SetDefaultDevice(const std::string& id);
+
+	// Create a session for a process on a device and return its process id
+	uint32_t AddSession(const std::string& processName, float volume = 1.0f, const std::string& deviceId = DEFAULT_DEVICE_ID);
+
+	// Give a process the executable path and session display name that path and title patterns match
+	void	 SetSessionDetails(uint32_t processId, const std::string& processPath, const std::string& displayName);
+
+	// Expire a session the way an exiting process would; without notify the backend is not told, as when it misses the
+	// notification, and only finds out when a call on the session fails
+	void	 ExpireSession(uint32_t processId, bool notify = true);
+
+	float	 GetSessionVolume(uint32_t processId) const;
+
+	float	 GetDeviceVolume(const std::string& id) const;
+
+	// Calls that reached a session or device volume
+	uint64_t SetVolumeCount() const { return setVolumeCount; }
+
+protected:
+	bool		EnumerateDevices(std::vector<AudioDeviceEntry>& entries) override;
+	bool		EnumerateSessions(const AudioDeviceEntry& device, std::vector<AudioSessionEntry>& sessions) override;
+	std::string GetProcessPath(uint32_t processId) override;
+
+private:
+	// A session or a device's own volume
+	class MockSession : public AudioSession {
+	public:
+		explicit MockSession(MockAudioBackend& backend, const float volume) : backend(backend), volume(volume) {}
+
+		bool			  GetVolume(float& currentVolume) override;
+		bool			  SetVolume(float newVolume) override;
+
+		MockAudioBackend& backend;
+		std::atomic<float> volume;
+		std::atomic<bool>  expired = false;
+	};
+
+	struct MockDevice {
+		std::string					 name;
+		AudioDeviceFlow				 flow;
+		std::shared_ptr<MockSession> volume;
+	};
+
+	struct MockProcess {
+		std::string					 processName;
+		std::string					 deviceId;
+		std::shared_ptr<MockSession> session;
+		std::string					 processPath;
+		std::string					 displayName;
+	};
+
+	mutable std::mutex				  mockMutex;
+	std::map<std::string, MockDevice> devices; // By ID
+	std::string						  defaultDeviceId;
+	std::map<uint32_t, MockProcess>	  processes;
+	uint32_t						  nextProcessId	 = 1000;
+	std::atomic<uint64_t>			  setVolumeCount = 0;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// Bounded lock-free multi-producer/single-consumer queue (Vyukov's sequence-numbered ring).
+// TryPush never blocks or allocates, so it is safe to call from the keyboard hook; it fails when the ring is full.
+template <typename T, size_t Capacity> class MpscQueue {
+	static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+public:
+	MpscQueue() {
+		for(size_t i = 0; i < Capacity; ++i) {
+			cells[i].sequence.store(i, std::memory_order_relaxed);
+		}
+	}
+
+	bool TryPush(const T& value) {
+		Cell*  cell		= nullptr;
+		size_t position = enqueuePosition.load(std::memory_order_relaxed);
+		while(true) {
+			cell					= &cells[position & (Capacity - 1)];
+			const size_t   sequence = cell->sequence.load(std::memory_order_acquire);
+			const intptr_t diff		= static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+			if(diff == 0) {
+				if(enqueuePosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) { break; }
+			} else if(diff < 0) {
+				return false; // Full
+			} else {
+				position = enqueuePosition.load(std::memory_order_relaxed);
+			}
+		}
+
+		cell->value = value;
+		cell->sequence.store(position + 1, std::memory_order_release);
+		return true;
+	}
+
+	// Must only be called from the single consumer thread
+	bool TryPop(T& value) {
+		Cell&		   cell		= cells[dequeuePosition & (Capacity - 1)];
+		const size_t   sequence = cell.sequence.load(std::memory_order_acquire);
+		const intptr_t diff		= static_cast<intptr_t>(sequence) - static_cast<intptr_t>(dequeuePosition + 1);
+		if(diff < 0) { return false; } // Empty
+
+		value = cell.value;
+		cell.sequence.store(dequeuePosition + Capacity, std::memory_order_release);
+		++dequeuePosition;
+		return true;
+	}
+
+private:
+	static constexpr size_t CACHE_LINE = 64;
+
+	struct Cell {
+		std::atomic<size_t> sequence;
+		T					value;
+	};
+
+	alignas(CACHE_LINE) std::array<Cell, Capacity> cells;
+	alignas(CACHE_LINE) std::atomic<size_t> enqueuePosition = 0;
+	alignas(CACHE_LINE) size_t dequeuePosition = 0;
+};
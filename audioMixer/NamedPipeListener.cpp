@@ -0,0 +1,205 @@
+#include "LocalSocket.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <windows.h>
+
+namespace {
+	constexpr DWORD PIPE_BUFFER_SIZE = 64 * 1024;
+
+	// One pipe instance with an overlapped read and an overlapped write. The read is always outstanding, so its event
+	// tells the listener's Wait when input arrives; Write copies the data so the caller never waits for completion.
+	class NamedPipeConnection : public LocalConnection {
+	public:
+		explicit NamedPipeConnection(const HANDLE pipe) : pipe(pipe) {
+			readOverlapped.hEvent  = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+			writeOverlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+			readBuffer.resize(PIPE_BUFFER_SIZE);
+			writeBuffer.resize(PIPE_BUFFER_SIZE);
+			StartRead();
+		}
+
+		~NamedPipeConnection() override {
+			CancelIoEx(pipe, nullptr);
+			DWORD unused = 0;
+			if(readPending) { GetOverlappedResult(pipe, &readOverlapped, &unused, TRUE); }
+			if(writePending) { GetOverlappedResult(pipe, &writeOverlapped, &unused, TRUE); }
+			CloseHandle(readOverlapped.hEvent);
+			CloseHandle(writeOverlapped.hEvent);
+			CloseHandle(pipe);
+		}
+
+		int Read(uint8_t* buffer, const size_t size) override {
+			if(broken) { return -1; }
+			if(readPending) {
+				DWORD bytesRead = 0;
+				if(!GetOverlappedResult(pipe, &readOverlapped, &bytesRead, FALSE)) { return GetLastError() == ERROR_IO_INCOMPLETE ? 0 : -1; }
+				readPending = false;
+				readSize	= bytesRead;
+				readOffset	= 0;
+			}
+
+			// Hand out what the completed read brought in, then start the next one
+			const size_t count = std::min(size, readSize - readOffset);
+			std::memcpy(buffer, readBuffer.data() + readOffset, count);
+			readOffset += count;
+			if(readOffset == readSize) { StartRead(); }
+			return static_cast<int>(count);
+		}
+
+		int Write(const uint8_t* data, const size_t size) override {
+			if(broken) { return -1; }
+			if(writePending) {
+				DWORD bytesWritten = 0;
+				if(!GetOverlappedResult(pipe, &writeOverlapped, &bytesWritten, FALSE)) { return GetLastError() == ERROR_IO_INCOMPLETE ? 0 : -1; }
+				writePending = false;
+			}
+
+			const DWORD count = static_cast<DWORD>(std::min<size_t>(size, writeBuffer.size()));
+			std::memcpy(writeBuffer.data(), data, count);
+			if(!WriteFile(pipe, writeBuffer.data(), count, nullptr, &writeOverlapped) && GetLastError() != ERROR_IO_PENDING) { return -1; }
+			writePending = true;
+			return static_cast<int>(count);
+		}
+
+		HANDLE ReadEvent() const { return readOverlapped.hEvent; }
+
+	private:
+		// Function to start the next overlapped read; a failure is reported by the next Read
+		void StartRead() {
+			readSize   = 0;
+			readOffset = 0;
+			if(!ReadFile(pipe, readBuffer.data(), static_cast<DWORD>(readBuffer.size()), nullptr, &readOverlapped) && GetLastError() != ERROR_IO_PENDING) {
+				broken = true;
+				return;
+			}
+			readPending = true;
+		}
+
+		HANDLE				 pipe;
+		OVERLAPPED			 readOverlapped	 = {};
+		OVERLAPPED			 writeOverlapped = {};
+		std::vector<uint8_t> readBuffer;
+		std::vector<uint8_t> writeBuffer;
+		size_t				 readSize	  = 0;
+		size_t				 readOffset	  = 0;
+		bool				 readPending  = false;
+		bool				 writePending = false;
+		bool				 broken		  = false;
+	};
+
+	// Keeps one unconnected pipe instance waiting for the next client
+	class NamedPipeListener : public LocalListener {
+	public:
+		explicit NamedPipeListener(std::string pipeName) : pipeName(std::move(pipeName)) {
+			connectOverlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+			wakeEvent				 = CreateEvent(nullptr, FALSE, FALSE, nullptr); // Auto-reset: one Wake ends one Wait
+		}
+
+		~NamedPipeListener() override {
+			if(pendingPipe != INVALID_HANDLE_VALUE) {
+				CancelIoEx(pendingPipe, &connectOverlapped);
+				DWORD unused = 0;
+				GetOverlappedResult(pendingPipe, &connectOverlapped, &unused, TRUE);
+				CloseHandle(pendingPipe);
+			}
+			CloseHandle(connectOverlapped.hEvent);
+			CloseHandle(wakeEvent);
+		}
+
+		// Function to create the next instance and wait for a client on it
+		bool CreateInstance(const bool first) {
+			// The event may still be signalled by the last instance's connect; left set, Wait would return at once forever
+			ResetEvent(connectOverlapped.hEvent);
+
+			const DWORD openMode = PIPE_ACCESS_DUPLEX | FILE_FLAG_OVERLAPPED | (first ? FILE_FLAG_FIRST_PIPE_INSTANCE : 0);
+			pendingPipe			 = CreateNamedPipe(pipeName.c_str(), openMode, PIPE_TYPE_BYTE | PIPE_READMODE_BYTE | PIPE_WAIT | PIPE_REJECT_REMOTE_CLIENTS,
+												   PIPE_UNLIMITED_INSTANCES, PIPE_BUFFER_SIZE, PIPE_BUFFER_SIZE, 0, nullptr);
+			if(pendingPipe == INVALID_HANDLE_VALUE) {
+				LOG_ERROR("Error: Unable to create pipe {}. Error: {}", pipeName, GetLastError());
+				return false;
+			}
+
+			clientConnected = false;
+			if(!ConnectNamedPipe(pendingPipe, &connectOverlapped)) {
+				// A client that connected between CreateNamedPipe and ConnectNamedPipe is reported as an error
+				if(GetLastError() == ERROR_PIPE_CONNECTED) {
+					clientConnected = true;
+					SetEvent(connectOverlapped.hEvent);
+				} else if(GetLastError() != ERROR_IO_PENDING) {
+					LOG_ERROR("Error: Unable to wait for pipe clients. Error: {}", GetLastError());
+					CloseHandle(pendingPipe);
+					pendingPipe = INVALID_HANDLE_VALUE;
+					return false;
+				}
+			}
+			return true;
+		}
+
+		std::unique_ptr<LocalConnection> Accept() override {
+			if(pendingPipe == INVALID_HANDLE_VALUE) { return nullptr; }
+			if(!clientConnected) {
+				DWORD unused = 0;
+				if(!GetOverlappedResult(pendingPipe, &connectOverlapped, &unused, FALSE)) {
+					const DWORD error = GetLastError();
+					if(error == ERROR_IO_INCOMPLETE) { return nullptr; }
+
+					// A client that raced the connect is still connected; any other failure (a client that went away before
+					// it was accepted) leaves the instance unusable, so it is replaced by a fresh one
+					if(error != ERROR_PIPE_CONNECTED) {
+						LOG_ERROR("Error: Pipe client failed to connect. Error: {}", error);
+						CloseHandle(pendingPipe);
+						pendingPipe = INVALID_HANDLE_VALUE;
+						CreateInstance(false);
+						return nullptr;
+					}
+				}
+			}
+
+			auto connection = std::make_unique<NamedPipeConnection>(pendingPipe);
+			pendingPipe		= INVALID_HANDLE_VALUE;
+			CreateInstance(false);
+			return connection;
+		}
+
+		void Wait(const std::vector<LocalConnection*>& connections, const int timeoutMs) override {
+			// WaitForMultipleObjects takes at most 64 handles; the connections past that are served on the next wakeup
+			HANDLE handles[MAXIMUM_WAIT_OBJECTS];
+			DWORD  count	= 0;
+			handles[count++] = connectOverlapped.hEvent;
+			handles[count++] = wakeEvent;
+			for(const LocalConnection* connection : connections) {
+				if(count == MAXIMUM_WAIT_OBJECTS) { break; }
+				handles[count++] = static_cast<const NamedPipeConnection*>(connection)->ReadEvent();
+			}
+			WaitForMultipleObjects(count, handles, FALSE, timeoutMs < 0 ? INFINITE : static_cast<DWORD>(timeoutMs));
+		}
+
+		void Wake() override { SetEvent(wakeEvent); }
+
+	private:
+		std::string pipeName;
+		HANDLE		pendingPipe		  = INVALID_HANDLE_VALUE;
+		OVERLAPPED	connectOverlapped = {};
+		HANDLE		wakeEvent		  = nullptr;
+		bool		clientConnected	  = false;
+	};
+} // namespace
+
+// Function to create a named pipe that only local processes can open
+std::unique_ptr<LocalListener> ListenLocal(const std::string& endpoint) {
+	auto listener = std::make_unique<NamedPipeListener>(endpoint);
+	if(!listener->CreateInstance(true)) { return nullptr; }
+	return listener;
+}
+
+// Function to open a named pipe as a client
+std::unique_ptr<LocalConnection> ConnectLocal(const std::string& endpoint) {
+	const HANDLE pipe = CreateFile(endpoint.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_FLAG_OVERLAPPED, nullptr);
+	if(pipe == INVALID_HANDLE_VALUE) { return nullptr; }
+	return std::make_unique<NamedPipeConnection>(pipe);
+}
+
+// Function to get the default pipe name
+std::string DefaultLocalEndpoint() { return R"(\\.\pipe\audioMixer)"; }
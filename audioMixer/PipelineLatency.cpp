@@ -0,0 +1,54 @@
+#include "PipelineLatency.h"
+
+#include <algorithm>
+
+std::chrono::nanoseconds DeviceClock::Transit(const MixerFrame& frame) {
+	// Extend the 32-bit microsecond timestamp, which wraps every ~71 minutes
+	deviceClockUs += haveDeviceClock ? static_cast<uint32_t>(frame.deviceTimestampUs - lastDeviceUs) : frame.deviceTimestampUs;
+	lastDeviceUs	= frame.deviceTimestampUs;
+	haveDeviceClock = true;
+
+	const int64_t receivedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(frame.receivedAt.time_since_epoch()).count();
+	const int64_t offset	 = receivedNs - static_cast<int64_t>(deviceClockUs) * 1000;
+	minTransitOffset		 = std::min(minTransitOffset, offset);
+	return std::chrono::nanoseconds(offset - minTransitOffset);
+}
+
+void PipelineLatency::RecordFrame(const MixerFrame& frame, DeviceClock& deviceClock) {
+	receivedToParsed.Record(frame.parsedAt - frame.receivedAt);
+	sampledToReceived.Record(deviceClock.Transit(frame));
+}
+
+void PipelineLatency::RecordRouted(const MixerFrame& frame, const TimePoint routedAt) { parsedToRouted.Record(routedAt - frame.parsedAt); }
+
+void PipelineLatency::RecordApplied(const VolumeCommand& command, const TimePoint started, const TimePoint finished) {
+	if(command.receivedAt == TimePoint{}) { return; } // Hotkey commands are not timed
+	routedToApplyStarted.Record(started - command.routedAt);
+	applyDuration.Record(finished - started);
+	receivedToApplied.Record(finished - command.receivedAt);
+}
+
+void PipelineLatency::Reset() {
+	sampledToReceived.Reset();
+	receivedToParsed.Reset();
+	parsedToRouted.Reset();
+	routedToApplyStarted.Reset();
+	applyDuration.Reset();
+	receivedToApplied.Reset();
+}
+
+void PipelineLatency::WriteJson(std::ostream& out) const {
+	out << "{\"sampled_to_received\":";
+	sampledToReceived.WriteJson(out);
+	out << ",\"received_to_parsed\":";
+	receivedToParsed.WriteJson(out);
+	out << ",\"parsed_to_routed\":";
+	parsedToRouted.WriteJson(out);
+	out << ",\"routed_to_apply_started\":";
+	routedToApplyStarted.WriteJson(out);
+	out << ",\"apply_duration\":";
+	applyDuration.WriteJson(out);
+	out << ",\"received_to_applied\":";
+	receivedToApplied.WriteJson(out);
+	out << "}";
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "FrameParser.h"
+#include "LatencyHistogram.h"
+#include "VolumeCommand.h"
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+// One board's clock against ours. Boards have unrelated clocks, so each connection of each board gets its own.
+class DeviceClock {
+public:
+	// Function to take a frame's transit time above the lowest one seen from this board so far
+	std::chrono::nanoseconds Transit(const MixerFrame& frame);
+
+private:
+	uint64_t				 deviceClockUs	  = 0; // Device timestamps unwrapped to 64 bits
+	uint32_t				 lastDeviceUs	  = 0;
+	bool					 haveDeviceClock  = false;
+	int64_t					 minTransitOffset = INT64_MAX; // Lowest (host receive time - device time) seen, in ns
+};
+
+// Per-stage latency of the pot path, from the board sampling a value to the backend having applied it. Each stage is
+// recorded by the thread that completes it (serial thread, then audio worker) into lock-free histograms, so the
+// instrumentation can stay enabled and be dumped at any time.
+class PipelineLatency {
+public:
+	using TimePoint = std::chrono::steady_clock::time_point;
+
+	// Serial thread: a frame was parsed from the board whose clock is deviceClock
+	void			 RecordFrame(const MixerFrame& frame, DeviceClock& deviceClock);
+
+	// Serial thread: a volume command was queued for the frame
+	void			 RecordRouted(const MixerFrame& frame, TimePoint routedAt);
+
+	// Audio worker: the backend call that applied a timed command (and the rest of its batch) ran from started to finished
+	void			 RecordApplied(const VolumeCommand& command, TimePoint started, TimePoint finished);
+
+	void			 Reset();
+
+	// Function to write every stage as one JSON object
+	void			 WriteJson(std::ostream& out) const;
+
+	// A board's clock is not synchronised with ours, so this is the transit time above the lowest one seen from the same
+	// board (sampling, filtering, encoding, UART and driver buffering); its spread is what matters.
+	LatencyHistogram sampledToReceived;
+	LatencyHistogram receivedToParsed;	   // Frame parser
+	LatencyHistogram parsedToRouted;	   // Routing table and queueing the command
+	LatencyHistogram routedToApplyStarted; // Command queue plus per-application rate limiting
+	LatencyHistogram applyDuration;		   // Backend call for the batch the command was applied in
+	LatencyHistogram receivedToApplied;	   // Whole host path
+};
@@ -0,0 +1,86 @@
+#include "SerialPort.h"
+#include "Log.h"
+
+#include <cerrno>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace {
+	// Function to map a numeric baud rate to its termios constant
+	speed_t GetBaudConstant(const int baudRate) {
+		switch(baudRate) {
+			case 9600: return B9600;
+			case 19200: return B19200;
+			case 38400: return B38400;
+			case 57600: return B57600;
+			case 115200: return B115200;
+			case 230400: return B230400;
+			case 460800: return B460800;
+			case 921600: return B921600;
+			default: return B0;
+		}
+	}
+
+	class PosixSerialPort : public SerialPort {
+	public:
+		explicit PosixSerialPort(const int fd) : fd(fd) {}
+
+		~PosixSerialPort() override { close(fd); }
+
+		WaitResult WaitForData(const int timeoutMs) override {
+			pollfd pfd = {fd, POLLIN, 0};
+			const int ready = poll(&pfd, 1, timeoutMs);
+			if(ready < 0) { return errno == EINTR ? WaitResult::Timeout : WaitResult::Error; }
+			if(ready == 0) { return WaitResult::Timeout; }
+			if(pfd.revents & POLLIN) { return WaitResult::Data; }
+			return WaitResult::Error; // POLLERR/POLLHUP: device unplugged or pty master closed
+		}
+
+		int ReadAvailable(uint8_t* buffer, const size_t size) override {
+			const ssize_t bytesRead = read(fd, buffer, size);
+			if(bytesRead < 0) { return (errno == EAGAIN || errno == EINTR) ? 0 : -1; }
+			return static_cast<int>(bytesRead);
+		}
+
+		std::optional<NativeHandle> GetNativeHandle() const override { return fd; }
+
+	private:
+		int fd;
+	};
+} // namespace
+
+// Function to open a tty (or pty slave) in raw, non-blocking mode
+std::unique_ptr<SerialPort> OpenSerialPort(const std::string& portName, const int baudRate) {
+	const int fd = open(portName.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+	if(fd < 0) {
+		LOG_ERROR("Error: Unable to open serial port {}.", portName);
+		return nullptr;
+	}
+
+	termios tty = {};
+	if(tcgetattr(fd, &tty) != 0) {
+		LOG_ERROR("Error: Unable to get serial port state.");
+		close(fd);
+		return nullptr;
+	}
+
+	cfmakeraw(&tty);
+	tty.c_cflag |= CLOCAL | CREAD;
+	tty.c_cflag &= ~(CSTOPB | PARENB | CRTSCTS);
+	tty.c_cc[VMIN]	= 0;
+	tty.c_cc[VTIME] = 0;
+	if(const speed_t speed = GetBaudConstant(baudRate); speed != B0) {
+		cfsetispeed(&tty, speed);
+		cfsetospeed(&tty, speed);
+	}
+
+	if(tcsetattr(fd, TCSANOW, &tty) != 0) {
+		LOG_ERROR("Error: Unable to set serial port parameters.");
+		close(fd);
+		return nullptr;
+	}
+
+	return std::make_unique<PosixSerialPort>(fd);
+}
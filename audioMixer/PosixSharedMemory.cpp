@@ -0,0 +1,65 @@
+#include "SharedMemory.h"
+#include "Log.h"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+	class PosixSharedMemory : public SharedMemory {
+	public:
+		PosixSharedMemory(std::string name, void* data, const size_t size, const bool owner) : name(std::move(name)), data(data), size(size), owner(owner) {}
+
+		~PosixSharedMemory() override {
+			munmap(data, size);
+			if(owner) { shm_unlink(name.c_str()); }
+		}
+
+		void*  Data() override { return data; }
+
+		size_t Size() const override { return size; }
+
+	private:
+		std::string name;
+		void*		data;
+		size_t		size;
+		bool		owner;
+	};
+} // namespace
+
+// Function to create a POSIX shared memory object; one left behind by a crashed instance is replaced
+std::unique_ptr<SharedMemory> CreateSharedMemory(const std::string& name, const size_t size) {
+	shm_unlink(name.c_str());
+	const int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR | O_CLOEXEC, 0600);
+	if(fd < 0) {
+		LOG_ERROR("Error: Unable to create shared memory {}: {}", name, strerror(errno));
+		return nullptr;
+	}
+
+	// A new object is zero-filled by ftruncate
+	void* data = MAP_FAILED;
+	if(ftruncate(fd, static_cast<off_t>(size)) == 0) { data = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0); }
+	close(fd);
+	if(data == MAP_FAILED) {
+		LOG_ERROR("Error: Unable to map shared memory {}: {}", name, strerror(errno));
+		shm_unlink(name.c_str());
+		return nullptr;
+	}
+	return std::make_unique<PosixSharedMemory>(name, data, size, true);
+}
+
+// Function to map a POSIX shared memory object read-only
+std::unique_ptr<SharedMemory> OpenSharedMemory(const std::string& name, const size_t size) {
+	const int fd = shm_open(name.c_str(), O_RDONLY | O_CLOEXEC, 0);
+	if(fd < 0) { return nullptr; }
+
+	struct stat status;
+	void*		data = MAP_FAILED;
+	if(fstat(fd, &status) == 0 && static_cast<size_t>(status.st_size) >= size) { data = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0); }
+	close(fd);
+	if(data == MAP_FAILED) { return nullptr; }
+	return std::make_unique<PosixSharedMemory>(name, data, size, false);
+}
@@ -0,0 +1,86 @@
+#include "ProcessIndex.h"
+
+#include <algorithm>
+#include <cctype>
+#include <mutex>
+
+std::string_view ProcessIndex::LowerName(const std::string_view exeName, char (&buffer)[MAX_NAME_LENGTH]) {
+	const size_t length = std::min(exeName.size(), MAX_NAME_LENGTH);
+	for(size_t i = 0; i < length; ++i) {
+		buffer[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(exeName[i])));
+	}
+	return std::string_view(buffer, length);
+}
+
+void ProcessIndex::AddLocked(const uint32_t processId, const std::string_view exeName) {
+	char	   lowered[MAX_NAME_LENGTH];
+	const auto key = LowerName(exeName, lowered);
+
+	// A recycled PID may now belong to a different exe
+	if(const auto existing = nameById.find(processId); existing != nameById.end()) {
+		if(existing->second == key) { return; }
+		RemoveLocked(processId);
+	}
+
+	nameById.emplace(processId, std::string(key));
+	auto it = processIdsByName.find(key);
+	if(it == processIdsByName.end()) { it = processIdsByName.emplace(std::string(key), std::vector<uint32_t>()).first; }
+	it->second.push_back(processId);
+}
+
+void ProcessIndex::RemoveLocked(const uint32_t processId) {
+	const auto existing = nameById.find(processId);
+	if(existing == nameById.end()) { return; }
+
+	if(const auto it = processIdsByName.find(existing->second); it != processIdsByName.end()) {
+		std::erase(it->second, processId);
+		if(it->second.empty()) { processIdsByName.erase(it); }
+	}
+	nameById.erase(existing);
+}
+
+void ProcessIndex::Rebuild(const std::span<const ProcessInfo> processes) {
+	std::unordered_map<uint32_t, const ProcessInfo*> listed;
+	listed.reserve(processes.size());
+	for(const ProcessInfo& process : processes) {
+		listed.emplace(process.processId, &process);
+	}
+
+	std::unique_lock lock(mutex);
+
+	// Drop processes that exited since the last listing
+	std::vector<uint32_t> exited;
+	for(const auto& [processId, name] : nameById) {
+		if(!listed.contains(processId)) { exited.push_back(processId); }
+	}
+	for(const uint32_t processId : exited) {
+		RemoveLocked(processId);
+	}
+
+	// Add new processes (AddLocked is a no-op for unchanged ones)
+	for(const ProcessInfo& process : processes) {
+		AddLocked(process.processId, process.exeName);
+	}
+}
+
+void ProcessIndex::AddProcess(const uint32_t processId, const std::string_view exeName) {
+	std::unique_lock lock(mutex);
+	AddLocked(processId, exeName);
+}
+
+void ProcessIndex::RemoveProcess(const uint32_t processId) {
+	std::unique_lock lock(mutex);
+	RemoveLocked(processId);
+}
+
+std::optional<std::string> ProcessIndex::FindName(const uint32_t processId) const {
+	std::shared_lock lock(mutex);
+	const auto		 it = nameById.find(processId);
+	if(it == nameById.end()) { return std::nullopt; }
+	return it->second;
+}
+
+size_t ProcessIndex::Size() const {
+	std::shared_lock lock(mutex);
+	return nameById.size();
+}
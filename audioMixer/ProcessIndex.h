@@ -0,0 +1,64 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <shared_mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// One running process as reported by the platform's process source
+struct ProcessInfo {
+	uint32_t	processId = 0;
+	std::string exeName;
+};
+
+// Lower-cased exe name -> PIDs index that is kept up to date incrementally (single processes added/removed as sessions
+// come and go, plus an occasional full rebuild from a process listing) instead of snapshotting every process per lookup.
+// It only consumes ProcessInfo lists, so it can be fed synthetic process tables. All methods are thread-safe.
+class ProcessIndex {
+public:
+	// Replace the index contents with a full listing, touching only the entries that changed
+	void					   Rebuild(std::span<const ProcessInfo> processes);
+
+	void					   AddProcess(uint32_t processId, std::string_view exeName);
+	void					   RemoveProcess(uint32_t processId);
+
+	std::optional<std::string> FindName(uint32_t processId) const;
+
+	// Call onProcessId for every PID running the given exe (case-insensitive); returns false if there are none
+	template <typename Callback> bool ForEachProcessId(const std::string_view exeName, Callback&& onProcessId) const {
+		char			 lowered[MAX_NAME_LENGTH];
+		const auto		 key = LowerName(exeName, lowered);
+		std::shared_lock lock(mutex);
+		const auto		 it = processIdsByName.find(key);
+		if(it == processIdsByName.end()) { return false; }
+		for(const uint32_t processId : it->second) {
+			onProcessId(processId);
+		}
+		return true;
+	}
+
+	size_t Size() const;
+
+private:
+	static constexpr size_t MAX_NAME_LENGTH = 260; // MAX_PATH
+
+	// Hash/equality that accept string_view so lookups do not allocate
+	struct NameHash {
+		using is_transparent = void;
+
+		size_t operator()(const std::string_view name) const { return std::hash<std::string_view>{}(name); }
+	};
+
+	static std::string_view LowerName(std::string_view exeName, char (&buffer)[MAX_NAME_LENGTH]);
+
+	void					AddLocked(uint32_t processId, std::string_view exeName);
+	void					RemoveLocked(uint32_t processId);
+
+	mutable std::shared_mutex														  mutex;
+	std::unordered_map<std::string, std::vector<uint32_t>, NameHash, std::equal_to<>> processIdsByName;
+	std::unordered_map<uint32_t, std::string>										  nameById; // Lower-cased
+};
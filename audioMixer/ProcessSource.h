@@ -0,0 +1,17 @@
+#pragma once
+
+#include "ProcessIndex.h"
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+// Function to list every running process (Toolhelp snapshot on Windows); used for the occasional full ProcessIndex rebuild
+bool EnumerateProcesses(std::vector<ProcessInfo>& processes);
+
+// Function to look up the exe name of a single process without listing all of them
+std::optional<std::string> QueryProcessName(uint32_t processId);
+
+// Function to look up the full executable path of a single process
+std::optional<std::string> QueryProcessPath(uint32_t processId);
@@ -0,0 +1,416 @@
+#include "PulseAudioBackend.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+
+namespace {
+	// Delay before the first attempt to reconnect to a server that went away, doubled after each failed attempt
+	constexpr uint32_t RECONNECT_MIN_DELAY_MS = 500;
+	constexpr uint32_t RECONNECT_MAX_DELAY_MS = 30000;
+} // namespace
+
+// Controls one sink input, sink or source. The last volume the server reported (or we set) is kept, so reading it
+// back for a hotkey step needs no round trip.
+class PulseAudioBackend::PulseVolume : public AudioSession {
+public:
+	enum class Kind : uint8_t {
+		SinkInput,
+		Sink,
+		Source,
+	};
+
+	PulseVolume(PulseAudioBackend& backend, const Kind kind, const uint32_t index) : backend(backend), kind(kind), index(index) {}
+
+	bool GetVolume(float& currentVolume) override {
+		if(expired) { return false; }
+		currentVolume = volume;
+		return true;
+	}
+
+	// Sends the request without waiting for it: the change event that follows updates the cached volume, and a stream
+	// that went away in the meantime is removed by its own event
+	bool SetVolume(const float newVolume) override {
+		if(expired) { return false; }
+
+		pa_cvolume cvolume;
+		pa_cvolume_set(&cvolume, channels, static_cast<pa_volume_t>(std::lround(newVolume * PA_VOLUME_NORM)));
+
+		pa_threaded_mainloop_lock(backend.mainloop);
+		pa_operation* operation = nullptr;
+		switch(kind) {
+			case Kind::SinkInput: operation = pa_context_set_sink_input_volume(backend.context, index, &cvolume, nullptr, nullptr); break;
+			case Kind::Sink: operation = pa_context_set_sink_volume_by_index(backend.context, index, &cvolume, nullptr, nullptr); break;
+			case Kind::Source: operation = pa_context_set_source_volume_by_index(backend.context, index, &cvolume, nullptr, nullptr); break;
+		}
+		if(operation) { pa_operation_unref(operation); }
+		pa_threaded_mainloop_unlock(backend.mainloop);
+
+		if(!operation) { return false; }
+		volume = newVolume;
+		return true;
+	}
+
+	// Function to take the volume the server reported; called on the mainloop thread
+	void Update(const pa_cvolume& cvolume) {
+		channels = std::max<uint8_t>(cvolume.channels, 1);
+		volume	 = static_cast<float>(pa_cvolume_max(&cvolume)) / PA_VOLUME_NORM;
+	}
+
+	void Expire() { expired = true; }
+
+private:
+	PulseAudioBackend&	 backend;
+	Kind				 kind;
+	uint32_t			 index;
+	std::atomic<uint8_t> channels = 2;
+	std::atomic<float>	 volume	  = 1.0f;
+	std::atomic<bool>	 expired  = false;
+};
+
+PulseAudioBackend::~PulseAudioBackend() {
+	// Not a lost connection, so the state callback is detached and nothing reconnects
+	connected = false;
+	if(mainloop) {
+		pa_threaded_mainloop_lock(mainloop);
+		if(reconnectEvent) { pa_threaded_mainloop_get_api(mainloop)->time_free(reconnectEvent); }
+		if(context) {
+			pa_context_set_state_callback(context, nullptr, nullptr);
+			pa_context_disconnect(context);
+		}
+		pa_threaded_mainloop_unlock(mainloop);
+		pa_threaded_mainloop_stop(mainloop);
+	}
+	if(context) { pa_context_unref(context); }
+	if(mainloop) { pa_threaded_mainloop_free(mainloop); }
+	ExpireAll();
+}
+
+bool PulseAudioBackend::Initialize(const char* serverName) {
+	server			 = serverName ? serverName : "";
+	reconnectDelayMs = RECONNECT_MIN_DELAY_MS;
+	mainloop		 = pa_threaded_mainloop_new();
+	if(!mainloop) {
+		LOG_ERROR("Failed to create the PulseAudio mainloop.");
+		return false;
+	}
+	if(pa_threaded_mainloop_start(mainloop) < 0) {
+		LOG_ERROR("Failed to start the PulseAudio mainloop.");
+		return false;
+	}
+
+	pa_threaded_mainloop_lock(mainloop);
+	if(!Connect()) {
+		pa_threaded_mainloop_unlock(mainloop);
+		return false;
+	}
+	for(pa_context_state_t state = pa_context_get_state(context); state != PA_CONTEXT_READY; state = pa_context_get_state(context)) {
+		if(!PA_CONTEXT_IS_GOOD(state)) {
+			LOG_ERROR("Failed to connect to the PulseAudio server: {}", pa_strerror(pa_context_errno(context)));
+			pa_threaded_mainloop_unlock(mainloop);
+			return false;
+		}
+		pa_threaded_mainloop_wait(mainloop);
+	}
+
+	LoadState(true);
+	connected = true;
+	LOG_INFO("Connected to {} sinks, {} sources and {} playback streams.", sinks.size(), sources.size(), sinkInputs.size());
+	pa_threaded_mainloop_unlock(mainloop);
+	return true;
+}
+
+bool PulseAudioBackend::Connect() {
+	if(context) {
+		pa_context_set_state_callback(context, nullptr, nullptr);
+		pa_context_set_subscribe_callback(context, nullptr, nullptr);
+		pa_context_disconnect(context);
+		pa_context_unref(context);
+	}
+
+	pa_proplist* properties = pa_proplist_new();
+	pa_proplist_sets(properties, PA_PROP_APPLICATION_NAME, "audioMixer");
+	context = pa_context_new_with_proplist(pa_threaded_mainloop_get_api(mainloop), "audioMixer", properties);
+	pa_proplist_free(properties);
+	if(!context) {
+		LOG_ERROR("Failed to create the PulseAudio context.");
+		return false;
+	}
+	pa_context_set_state_callback(context, ContextStateCallback, this);
+	pa_context_set_subscribe_callback(context, SubscribeCallback, this);
+
+	if(pa_context_connect(context, server.empty() ? nullptr : server.c_str(), PA_CONTEXT_NOAUTOSPAWN, nullptr) < 0) {
+		LOG_ERROR("Failed to connect to the PulseAudio server: {}", pa_strerror(pa_context_errno(context)));
+		return false;
+	}
+	return true;
+}
+
+void PulseAudioBackend::LoadState(const bool wait) {
+	// Subscribe before listing, so nothing that changes while the lists are loading is missed
+	const auto	  mask		   = static_cast<pa_subscription_mask_t>(PA_SUBSCRIPTION_MASK_SINK_INPUT | PA_SUBSCRIPTION_MASK_SINK | PA_SUBSCRIPTION_MASK_SOURCE |
+																 PA_SUBSCRIPTION_MASK_SERVER);
+	pa_operation* operations[] = {
+		pa_context_subscribe(context, mask, SuccessCallback, this),
+		pa_context_get_server_info(context, ServerInfoCallback, this),
+		pa_context_get_sink_info_list(context, SinkInfoCallback, this),
+		pa_context_get_source_info_list(context, SourceInfoCallback, this),
+		pa_context_get_sink_input_info_list(context, SinkInputInfoCallback, this),
+	};
+	for(pa_operation* operation : operations) {
+		if(wait) {
+			WaitFor(operation);
+		} else if(operation) {
+			pa_operation_unref(operation);
+		}
+	}
+}
+
+void PulseAudioBackend::ScheduleReconnect() {
+	timeval time;
+	pa_timeval_add(pa_gettimeofday(&time), static_cast<pa_usec_t>(reconnectDelayMs) * PA_USEC_PER_MSEC);
+	pa_mainloop_api* api = pa_threaded_mainloop_get_api(mainloop);
+	if(reconnectEvent) {
+		api->time_restart(reconnectEvent, &time);
+	} else {
+		reconnectEvent = api->time_new(api, &time, ReconnectCallback, this);
+	}
+	LOG_INFO("Reconnecting to the PulseAudio server in {} ms.", reconnectDelayMs);
+	reconnectDelayMs = std::min(reconnectDelayMs * 2, RECONNECT_MAX_DELAY_MS);
+}
+
+// Function to start the next attempt; its outcome arrives in ContextStateCallback
+void PulseAudioBackend::ReconnectCallback(pa_mainloop_api* api, pa_time_event* event, const struct timeval*, void* userdata) {
+	auto* backend = static_cast<PulseAudioBackend*>(userdata);
+	api->time_free(event);
+	backend->reconnectEvent = nullptr;
+	backend->reconnecting	= true;
+	if(!backend->Connect()) { backend->ScheduleReconnect(); }
+}
+
+void PulseAudioBackend::WaitFor(pa_operation* operation) {
+	if(!operation) { return; }
+	while(pa_operation_get_state(operation) == PA_OPERATION_RUNNING) {
+		pa_threaded_mainloop_wait(mainloop);
+	}
+	pa_operation_unref(operation);
+}
+
+void PulseAudioBackend::ContextStateCallback(pa_context* context, void* userdata) {
+	auto*					 backend = static_cast<PulseAudioBackend*>(userdata);
+	const pa_context_state_t state	 = pa_context_get_state(context);
+	if(state == PA_CONTEXT_READY && backend->reconnecting) {
+		// Load the copy again without waiting; the answers invalidate the device list and sessions as they arrive
+		backend->reconnecting	  = false;
+		backend->reconnectDelayMs = RECONNECT_MIN_DELAY_MS;
+		backend->LoadState(false);
+		backend->connected = true;
+		LOG_INFO("Reconnected to the PulseAudio server.");
+	} else if(!PA_CONTEXT_IS_GOOD(state)) {
+		if(backend->connected.exchange(false)) {
+			LOG_ERROR("Lost the connection to the PulseAudio server: {}", pa_strerror(pa_context_errno(context)));
+			backend->ExpireAll();
+			backend->ScheduleReconnect();
+		} else if(backend->reconnecting) {
+			backend->reconnecting = false;
+			backend->ScheduleReconnect();
+		}
+	}
+	pa_threaded_mainloop_signal(backend->mainloop, 0);
+}
+
+void PulseAudioBackend::SuccessCallback(pa_context*, int, void* userdata) {
+	pa_threaded_mainloop_signal(static_cast<PulseAudioBackend*>(userdata)->mainloop, 0);
+}
+
+// Function to turn one subscription event into a request for the entity's new state, or a removal
+void PulseAudioBackend::SubscribeCallback(pa_context* context, const pa_subscription_event_type_t event, const uint32_t index, void* userdata) {
+	auto*	   backend = static_cast<PulseAudioBackend*>(userdata);
+	const auto type	   = event & PA_SUBSCRIPTION_EVENT_TYPE_MASK;
+	++backend->eventCount;
+
+	pa_operation* operation = nullptr;
+	switch(event & PA_SUBSCRIPTION_EVENT_FACILITY_MASK) {
+		case PA_SUBSCRIPTION_EVENT_SINK_INPUT:
+			if(type == PA_SUBSCRIPTION_EVENT_REMOVE) {
+				backend->RemoveSinkInput(index);
+			} else {
+				operation = pa_context_get_sink_input_info(context, index, SinkInputInfoCallback, backend);
+			}
+			break;
+		case PA_SUBSCRIPTION_EVENT_SINK:
+			if(type == PA_SUBSCRIPTION_EVENT_REMOVE) {
+				backend->RemoveDevice(backend->sinks, index);
+			} else {
+				operation = pa_context_get_sink_info_by_index(context, index, SinkInfoCallback, backend);
+			}
+			break;
+		case PA_SUBSCRIPTION_EVENT_SOURCE:
+			if(type == PA_SUBSCRIPTION_EVENT_REMOVE) {
+				backend->RemoveDevice(backend->sources, index);
+			} else {
+				operation = pa_context_get_source_info_by_index(context, index, SourceInfoCallback, backend);
+			}
+			break;
+		case PA_SUBSCRIPTION_EVENT_SERVER: operation = pa_context_get_server_info(context, ServerInfoCallback, backend); break;
+		default: break;
+	}
+	if(operation) { pa_operation_unref(operation); }
+}
+
+void PulseAudioBackend::ServerInfoCallback(pa_context*, const pa_server_info* info, void* userdata) {
+	auto* backend = static_cast<PulseAudioBackend*>(userdata);
+	if(info) {
+		const std::string defaultSink = info->default_sink_name ? info->default_sink_name : "";
+		std::lock_guard	  lock(backend->cacheMutex);
+		if(defaultSink != backend->defaultSinkName) {
+			backend->defaultSinkName = defaultSink;
+			backend->InvalidateDevices();
+		}
+	}
+	pa_threaded_mainloop_signal(backend->mainloop, 0);
+}
+
+void PulseAudioBackend::SinkInputInfoCallback(pa_context*, const pa_sink_input_info* info, const int eol, void* userdata) {
+	auto* backend = static_cast<PulseAudioBackend*>(userdata);
+	if(eol != 0 || !info) {
+		pa_threaded_mainloop_signal(backend->mainloop, 0);
+		return;
+	}
+	backend->UpdateSinkInput(*info);
+}
+
+void PulseAudioBackend::SinkInfoCallback(pa_context*, const pa_sink_info* info, const int eol, void* userdata) {
+	auto* backend = static_cast<PulseAudioBackend*>(userdata);
+	if(eol != 0 || !info) {
+		pa_threaded_mainloop_signal(backend->mainloop, 0);
+		return;
+	}
+	backend->UpdateDevice(backend->sinks, info->index, info->name, info->description, info->volume, false);
+}
+
+void PulseAudioBackend::SourceInfoCallback(pa_context*, const pa_source_info* info, const int eol, void* userdata) {
+	auto* backend = static_cast<PulseAudioBackend*>(userdata);
+	if(eol != 0 || !info) {
+		pa_threaded_mainloop_signal(backend->mainloop, 0);
+		return;
+	}
+	// A sink's monitor is not something a pot should turn down
+	if(info->monitor_of_sink != PA_INVALID_INDEX) { return; }
+	backend->UpdateDevice(backend->sources, info->index, info->name, info->description, info->volume, true);
+}
+
+// Function to add or refresh a stream; only a new stream, or one that was renamed or moved, invalidates the sessions
+void PulseAudioBackend::UpdateSinkInput(const pa_sink_input_info& info) {
+	// Streams without a binary (module loopbacks, some sandboxed clients) fall back to their application name
+	const char* applicationName = pa_proplist_gets(info.proplist, PA_PROP_APPLICATION_NAME);
+	const char* binary			= pa_proplist_gets(info.proplist, PA_PROP_APPLICATION_PROCESS_BINARY);
+	if(!binary) { binary = applicationName; }
+	const char* processId = pa_proplist_gets(info.proplist, PA_PROP_APPLICATION_PROCESS_ID);
+
+	std::lock_guard lock(cacheMutex);
+	auto [it, inserted] = sinkInputs.try_emplace(info.index);
+	SinkInput& input	= it->second;
+	if(inserted) { input.volume = std::make_shared<PulseVolume>(*this, PulseVolume::Kind::SinkInput, info.index); }
+	input.volume->Update(info.volume);
+
+	const std::string name		  = binary ? binary : "";
+	const std::string displayName = applicationName ? applicationName : "";
+	if(!inserted && input.binary == name && input.displayName == displayName && input.sink == info.sink) { return; }
+	input.binary	  = name;
+	input.displayName = displayName;
+	input.processId	  = processId ? static_cast<uint32_t>(std::strtoul(processId, nullptr, 10)) : 0;
+	input.sink		  = info.sink;
+	InvalidateSessions();
+}
+
+void PulseAudioBackend::RemoveSinkInput(const uint32_t index) {
+	std::lock_guard lock(cacheMutex);
+	const auto		it = sinkInputs.find(index);
+	if(it == sinkInputs.end()) { return; }
+	it->second.volume->Expire();
+	sinkInputs.erase(it);
+	InvalidateSessions();
+}
+
+// Function to add or refresh a device; only a new or renamed device invalidates the device list
+void PulseAudioBackend::UpdateDevice(DeviceMap& devices, const uint32_t index, const char* name, const char* description, const pa_cvolume& volume,
+									 const bool capture) {
+	std::lock_guard lock(cacheMutex);
+	auto [it, inserted] = devices.try_emplace(index);
+	Device& device		= it->second;
+	if(inserted) {
+		device.volume = std::make_shared<PulseVolume>(*this, capture ? PulseVolume::Kind::Source : PulseVolume::Kind::Sink, index);
+	}
+	device.volume->Update(volume);
+
+	const std::string newName		 = name ? name : "";
+	const std::string newDescription = description ? description : newName;
+	if(!inserted && device.name == newName && device.description == newDescription) { return; }
+	device.name		   = newName;
+	device.description = newDescription;
+	InvalidateDevices();
+}
+
+void PulseAudioBackend::RemoveDevice(DeviceMap& devices, const uint32_t index) {
+	std::lock_guard lock(cacheMutex);
+	const auto		it = devices.find(index);
+	if(it == devices.end()) { return; }
+	it->second.volume->Expire();
+	devices.erase(it);
+
+	// Its streams are moved to another sink, and report that with their own change events
+	InvalidateDevices();
+}
+
+void PulseAudioBackend::ExpireAll() {
+	std::lock_guard lock(cacheMutex);
+	for(auto& [index, input] : sinkInputs) {
+		input.volume->Expire();
+	}
+	for(DeviceMap* devices : {&sinks, &sources}) {
+		for(auto& [index, device] : *devices) {
+			device.volume->Expire();
+		}
+		devices->clear();
+	}
+	sinkInputs.clear();
+	InvalidateDevices();
+	InvalidateSessions();
+}
+
+bool PulseAudioBackend::EnumerateDevices(std::vector<AudioDeviceEntry>& entries) {
+	if(!connected) { return false; }
+
+	std::lock_guard lock(cacheMutex);
+	for(const auto& [index, sink] : sinks) {
+		entries.push_back({sink.name, sink.description, AudioDeviceFlow::Render, sink.name == defaultSinkName, sink.volume});
+	}
+	for(const auto& [index, source] : sources) {
+		entries.push_back({source.name, source.description, AudioDeviceFlow::Capture, false, source.volume});
+	}
+	return true;
+}
+
+bool PulseAudioBackend::EnumerateSessions(const AudioDeviceEntry& device, std::vector<AudioSessionEntry>& sessions) {
+	if(!connected) { return false; }
+
+	std::lock_guard lock(cacheMutex);
+	const auto		sink = std::ranges::find_if(sinks, [&device](const auto& entry) { return entry.second.name == device.id; });
+	if(sink == sinks.end()) { return true; } // A source, whose recording streams are not controlled
+
+	for(const auto& [index, input] : sinkInputs) {
+		if(input.sink == sink->first) { sessions.push_back({input.binary, input.processId, input.volume, input.displayName}); }
+	}
+	return true;
+}
+
+// Function to read a local client's executable path; empty for remote clients and processes we may not inspect
+std::string PulseAudioBackend::GetProcessPath(const uint32_t processId) {
+	if(processId == 0) { return {}; }
+	std::error_code error;
+	const auto		path = std::filesystem::read_symlink("/proc/" + std::to_string(processId) + "/exe", error);
+	return error ? std::string() : path.string();
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "AudioBackend.h"
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <pulse/pulseaudio.h>
+#include <string>
+#include <unordered_map>
+
+// PulseAudio backend, which also drives PipeWire through pipewire-pulse. Applications are sink inputs, named by their
+// application.process.binary; devices are the sinks and the capture sources (monitors excluded). Sink inputs, sinks and
+// sources are loaded once, then kept current by a subscription on a pa_threaded_mainloop. Enumerations are served from
+// that copy without a round trip to the server. A volume change is one asynchronous request and is not waited on. When the
+// server goes away (a pipewire-pulse restart, a new login session) every handle expires and the backend reconnects in
+// the background, waiting longer after each failed attempt; the copy is loaded again once the server answers.
+class PulseAudioBackend : public AudioBackend {
+public:
+	~PulseAudioBackend() override;
+
+	// Function to connect (server nullptr for the default one) and load the initial state; false if no server answers
+	bool	 Initialize(const char* serverName = nullptr);
+
+	// Subscription events applied to the local copy since Initialize
+	uint64_t EventCount() const { return eventCount; }
+
+protected:
+	bool		EnumerateDevices(std::vector<AudioDeviceEntry>& entries) override;
+	bool		EnumerateSessions(const AudioDeviceEntry& device, std::vector<AudioSessionEntry>& sessions) override;
+	std::string GetProcessPath(uint32_t processId) override;
+
+private:
+	class PulseVolume;
+
+	// A playback stream and the sink it plays on
+	struct SinkInput {
+		std::string					 binary;
+		std::string					 displayName; // application.name, for title patterns
+		uint32_t					 processId = 0;
+		uint32_t					 sink	   = PA_INVALID_INDEX;
+		std::shared_ptr<PulseVolume> volume;
+	};
+
+	// A sink or a capture source
+	struct Device {
+		std::string					 name; // Stable pa name, used as the device ID
+		std::string					 description;
+		std::shared_ptr<PulseVolume> volume;
+	};
+
+	using DeviceMap = std::unordered_map<uint32_t, Device>;
+
+	static void	  ContextStateCallback(pa_context* context, void* userdata);
+	static void	  SubscribeCallback(pa_context* context, pa_subscription_event_type_t event, uint32_t index, void* userdata);
+	static void	  SuccessCallback(pa_context* context, int success, void* userdata);
+	static void	  ServerInfoCallback(pa_context* context, const pa_server_info* info, void* userdata);
+	static void	  SinkInputInfoCallback(pa_context* context, const pa_sink_input_info* info, int eol, void* userdata);
+	static void	  SinkInfoCallback(pa_context* context, const pa_sink_info* info, int eol, void* userdata);
+	static void	  SourceInfoCallback(pa_context* context, const pa_source_info* info, int eol, void* userdata);
+	static void	  ReconnectCallback(pa_mainloop_api* api, pa_time_event* event, const struct timeval* time, void* userdata);
+
+	// Function to replace the context with a new one and start connecting it; called with the mainloop locked
+	bool		  Connect();
+
+	// Function to subscribe and request the initial lists, waiting for them or not; called with the mainloop locked
+	void		  LoadState(bool wait);
+
+	// Function to try connecting again after the current delay, then double it; called on the mainloop thread
+	void		  ScheduleReconnect();
+
+	// Function to wait, with the mainloop locked, for a request to complete
+	void		  WaitFor(pa_operation* operation);
+
+	// Functions to apply a server answer or removal to the local copy; called on the mainloop thread
+	void		  UpdateSinkInput(const pa_sink_input_info& info);
+	void		  RemoveSinkInput(uint32_t index);
+	void		  UpdateDevice(DeviceMap& devices, uint32_t index, const char* name, const char* description, const pa_cvolume& volume, bool capture);
+	void		  RemoveDevice(DeviceMap& devices, uint32_t index);
+
+	// Function to expire every handle after the connection is lost
+	void		  ExpireAll();
+
+	pa_threaded_mainloop*					mainloop		 = nullptr;
+	pa_context*								context			 = nullptr;
+	std::string								server;					  // Empty for the default server
+	pa_time_event*							reconnectEvent	 = nullptr;
+	uint32_t								reconnectDelayMs = 0;
+	bool									reconnecting	 = false; // A reconnect attempt is under way; mainloop thread only
+	std::atomic<bool>						connected		 = false;
+	std::atomic<uint64_t>					eventCount		 = 0;
+	std::mutex								cacheMutex;				  // Guards the local copy below; the mainloop thread writes it, enumerations read it
+	std::unordered_map<uint32_t, SinkInput>	sinkInputs;				  // By sink input index
+	DeviceMap								sinks;
+	DeviceMap								sources;
+	std::string								defaultSinkName;
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+// Pointer to an immutable value that is replaced as a whole (RCU style). Readers never block or retry: a read stores the
+// current epoch in the reader's slot and loads the pointer, and leaving the read clears the slot. A published value
+// replaces the old one atomically, and the old one is only deleted once no reader slot can still be looking at it.
+// Each reader thread owns one slot in [0, MaxReaders) and must not nest reads.
+template <typename T, size_t MaxReaders> class RcuPointer {
+public:
+	// Keeps the value alive for as long as the guard exists
+	class ReadGuard {
+	public:
+		ReadGuard(std::atomic<uint64_t>& slot, const T* value) : slot(&slot), value(value) {}
+
+		ReadGuard(ReadGuard&& other) noexcept : slot(std::exchange(other.slot, nullptr)), value(other.value) {}
+
+		ReadGuard(const ReadGuard&)			   = delete;
+		ReadGuard& operator=(const ReadGuard&) = delete;
+		ReadGuard& operator=(ReadGuard&&)	   = delete;
+
+		~ReadGuard() {
+			if(slot) { slot->store(INACTIVE, std::memory_order_release); }
+		}
+
+		const T* get() const { return value; }
+
+		const T* operator->() const { return value; }
+
+		const T& operator*() const { return *value; }
+
+		explicit operator bool() const { return value != nullptr; }
+
+	private:
+		std::atomic<uint64_t>* slot;
+		const T*			   value;
+	};
+
+	RcuPointer() = default;
+
+	RcuPointer(const RcuPointer&)			 = delete;
+	RcuPointer& operator=(const RcuPointer&) = delete;
+
+	// Every reader must be finished
+	~RcuPointer() { delete current.load(std::memory_order_relaxed); }
+
+	ReadGuard Read(const size_t reader) const {
+		std::atomic<uint64_t>& slot = readers[reader].epoch;
+		slot.store(epoch.load(std::memory_order_seq_cst), std::memory_order_seq_cst);
+		return ReadGuard(slot, current.load(std::memory_order_seq_cst));
+	}
+
+	// Replace the value; the previous one is deleted once every reader has moved past it
+	void Publish(std::unique_ptr<const T> value) {
+		std::lock_guard lock(writerMutex);
+		const T*		previous  = current.exchange(value.release(), std::memory_order_seq_cst);
+		const uint64_t	retiredAt = epoch.fetch_add(1, std::memory_order_seq_cst) + 1;
+		if(previous) { retired.emplace_back(retiredAt, std::unique_ptr<const T>(previous)); }
+		ReclaimLocked();
+	}
+
+	// Delete retired values no reader can still see; Publish does this too, call it to reclaim between publishes
+	void Reclaim() {
+		std::lock_guard lock(writerMutex);
+		ReclaimLocked();
+	}
+
+	size_t RetiredCount() const {
+		std::lock_guard lock(writerMutex);
+		return retired.size();
+	}
+
+private:
+	static constexpr uint64_t INACTIVE	 = 0;
+	static constexpr size_t	  CACHE_LINE = 64;
+
+	struct alignas(CACHE_LINE) ReaderSlot {
+		std::atomic<uint64_t> epoch = INACTIVE;
+	};
+
+	void ReclaimLocked() {
+		// A reader that entered at epoch e may hold anything retired after e
+		uint64_t oldestReader = UINT64_MAX;
+		for(const ReaderSlot& reader : readers) {
+			const uint64_t readerEpoch = reader.epoch.load(std::memory_order_seq_cst);
+			if(readerEpoch != INACTIVE && readerEpoch < oldestReader) { oldestReader = readerEpoch; }
+		}
+		std::erase_if(retired, [oldestReader](const auto& entry) { return entry.first <= oldestReader; });
+	}
+
+	mutable std::array<ReaderSlot, MaxReaders> readers;
+	alignas(CACHE_LINE) std::atomic<const T*> current = nullptr;
+	std::atomic<uint64_t>									   epoch   = 1;
+	mutable std::mutex										   writerMutex;
+	std::vector<std::pair<uint64_t, std::unique_ptr<const T>>> retired; // (epoch it was retired at, value)
+};
@@ -0,0 +1,67 @@
+#include "CommandLine.h"
+#include "Log.h"
+#include "MixerController.h"
+#include "MockAudioBackend.h"
+#include "SerialLog.h"
+#include "SerialReader.h"
+
+#include <atomic>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+
+// Usage: audioMixerReplay <config path> --replay <file> [--speed N|max] [--latency <file>]
+// Feeds a serial log recorded with "audioMixer --record" through the frame parser, pot routing, scheduler and audio
+// worker against MockAudioBackend. At --speed 1 it reproduces a session on any platform; at --speed max it measures the
+// throughput of the whole host pipeline.
+int main(int argc, char** argv) {
+	CommandLineOptions options;
+	if(!ParseCommandLine(argc, argv, options)) { return 2; }
+	if(options.configPath.empty() || options.replayPath.empty()) {
+		std::cerr << "Usage: audioMixerReplay <config path> --replay <file> [--speed N|max] [--latency <file>]" << std::endl;
+		return 2;
+	}
+	if(!Log::Start(options.log)) { return 2; }
+
+	std::unique_ptr<MixerConfig> config = LoadConfig(options.configPath);
+	if(!config) { return 1; }
+
+	// One session per configured application (and the devices they name), so every routed change ends in a backend call
+	MockAudioBackend backend;
+	for(const ApplicationConfig& app : config->applications) {
+		const std::string deviceId = app.target.device.empty() ? MockAudioBackend::DEFAULT_DEVICE_ID : app.target.device;
+		backend.AddDevice(deviceId, deviceId);
+		if(!app.target.IsEndpoint()) { backend.AddSession(app.target.applicationName, 1.0f, deviceId); }
+	}
+
+	std::unique_ptr<SerialPort> serialPort = OpenReplayPort(options.replayPath, options.replaySpeed);
+	if(!serialPort) { return 1; }
+
+	MixerController mixer(backend);
+	mixer.PublishConfig(std::move(config));
+	mixer.Start();
+
+	std::atomic<bool> keepReading(true);
+	SerialReader	  reader(*serialPort, [&mixer](const MixerFrame& frame) { mixer.ApplyPotFrame(frame); }, &mixer.Latency());
+	const auto		  started = std::chrono::steady_clock::now();
+	reader.Run(keepReading);
+	mixer.Stop();
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - started);
+
+	mixer.ReportStats();
+	Log::Stop();
+	const uint64_t frames = reader.ParserStats().framesReceived;
+	std::cout << "Replayed " << frames << " frames in " << elapsed.count() * 1000 << "ms (" << (elapsed.count() > 0 ? frames / elapsed.count() : 0)
+			  << " frames/s), " << backend.SetVolumeCount() << " backend volume calls" << std::endl;
+
+	if(!options.latencyPath.empty()) {
+		std::ofstream outFile(options.latencyPath);
+		if(!outFile.is_open()) {
+			std::cerr << "Unable to write " << options.latencyPath << "." << std::endl;
+			return 1;
+		}
+		mixer.Latency().WriteJson(outFile);
+	}
+	return 0;
+}
@@ -0,0 +1,124 @@
+#include "SerialDeviceManager.h"
+#include "Log.h"
+
+#include <algorithm>
+
+namespace {
+	constexpr int						WAIT_TIMEOUT_MS = 100; // Upper bound on how long shutdown and reconnects wait
+	constexpr std::chrono::milliseconds MIN_RETRY_DELAY(250);
+	constexpr std::chrono::milliseconds MAX_RETRY_DELAY(4000);
+
+	// Function to add the counters of one connection to a board's totals
+	void AddStats(FrameParserStats& total, const FrameParserStats& stats) {
+		total.framesReceived += stats.framesReceived;
+		total.framesDropped += stats.framesDropped;
+		total.framesCorrupt += stats.framesCorrupt;
+		total.bytesSkipped += stats.bytesSkipped;
+	}
+} // namespace
+
+SerialDeviceManager::SerialDeviceManager(std::vector<DeviceConfig> deviceConfigs, FrameHandler onFrame, PipelineLatency* latency, PortOpener openPort)
+	: onFrame(std::move(onFrame))
+	, latency(latency)
+	, openPort(std::move(openPort)) {
+	if(!this->openPort) {
+		this->openPort = [](size_t, const DeviceConfig& device) { return OpenSerialPort(device.portName, device.baudRate); };
+	}
+
+	devices.resize(deviceConfigs.size());
+	for(size_t i = 0; i < devices.size(); ++i) {
+		devices[i].config	  = std::move(deviceConfigs[i]);
+		devices[i].retryDelay = MIN_RETRY_DELAY;
+	}
+}
+
+SerialDeviceManager::~SerialDeviceManager() {
+	for(size_t i = 0; i < devices.size(); ++i) {
+		Close(i);
+	}
+}
+
+bool SerialDeviceManager::Run(const std::atomic<bool>& keepRunning) {
+	eventLoop = CreateSerialEventLoop();
+	if(!eventLoop) { return false; }
+
+	const Clock::time_point started = Clock::now();
+	for(size_t i = 0; i < devices.size(); ++i) {
+		TryOpen(i, started);
+	}
+
+	std::vector<SerialEventLoop::Event> events;
+	while(keepRunning) {
+		if(eventLoop->Wait(WAIT_TIMEOUT_MS, events) == SerialEventLoop::WaitResult::Error) {
+			LOG_ERROR("Error waiting for serial ports.");
+			break;
+		}
+
+		const Clock::time_point now = Clock::now();
+		for(const SerialEventLoop::Event& event : events) {
+			Device& device = devices[event.key];
+			if(!device.port) { continue; }
+
+			// Frames the board sent before it went away are still applied
+			if(!device.reader->Drain() || event.hangUp) {
+				LOG_INFO("Device {} disconnected.", device.config.portName);
+				Close(event.key);
+				device.nextOpenAttempt = now + device.retryDelay;
+			}
+		}
+
+		for(size_t i = 0; i < devices.size(); ++i) {
+			if(!devices[i].port && devices[i].nextOpenAttempt <= now) { TryOpen(i, now); }
+		}
+	}
+
+	for(size_t i = 0; i < devices.size(); ++i) {
+		Close(i);
+	}
+	eventLoop.reset();
+	return true;
+}
+
+void SerialDeviceManager::TryOpen(const size_t index, const Clock::time_point now) {
+	Device& device = devices[index];
+	device.port	   = openPort(index, device.config);
+	if(device.port && !eventLoop->Add(*device.port, index)) { device.port.reset(); }
+	if(!device.port) {
+		// Back off, so a board that stays unplugged costs little and does not flood the console
+		device.nextOpenAttempt = now + device.retryDelay;
+		device.retryDelay	   = std::min(device.retryDelay * 2, MAX_RETRY_DELAY);
+		return;
+	}
+
+	device.retryDelay = MIN_RETRY_DELAY;
+	device.reader	  = std::make_unique<SerialReader>(
+		*device.port, [this, index](const MixerFrame& frame) { onFrame(frame, devices[index].config); }, latency);
+	++device.connectCount;
+	++connectCount;
+	++connectedCount;
+	LOG_INFO("Device {} connected (channels {} to {}).", device.config.portName, device.config.firstChannel,
+			 device.config.firstChannel + device.config.channelCount - 1);
+}
+
+void SerialDeviceManager::Close(const size_t index) {
+	Device& device = devices[index];
+	if(!device.port) { return; }
+
+	if(eventLoop) { eventLoop->Remove(index); }
+	AddStats(device.closedStats, device.reader->ParserStats());
+	if(device.reader->LatestBoardStats().received) { device.boardStats = device.reader->LatestBoardStats(); }
+	device.reader.reset();
+	device.port.reset();
+	--connectedCount;
+}
+
+void SerialDeviceManager::ReportStats() const {
+	for(const Device& device : devices) {
+		FrameParserStats stats = device.closedStats;
+		if(device.reader) { AddStats(stats, device.reader->ParserStats()); }
+		LOG_INFO("Device {}: {}, {} connections, {} frames received, {} dropped, {} corrupt", device.config.portName, device.port ? "connected" : "disconnected",
+				 device.connectCount, stats.framesReceived, stats.framesDropped, stats.framesCorrupt);
+		const bool live = device.reader && device.reader->LatestBoardStats().received;
+		ReportBoardStats("Device " + device.config.portName + " board", live ? device.reader->LatestBoardStats() : device.boardStats);
+	}
+}
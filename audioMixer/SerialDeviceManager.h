@@ -0,0 +1,65 @@
+#pragma once
+
+#include "MixerConfig.h"
+#include "PipelineLatency.h"
+#include "SerialEventLoop.h"
+#include "SerialReader.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <vector>
+
+// Services every configured mixer board from one thread through a SerialEventLoop. A board that is missing at startup
+// or goes away later (unplugged, pty closed) is reopened with a growing delay while the others keep running.
+class SerialDeviceManager {
+public:
+	// device is the board the frame came from; its channel block maps the frame into the global channel namespace
+	using FrameHandler = std::function<void(const MixerFrame& frame, const DeviceConfig& device)>;
+
+	// Opens the port of a board; by default with OpenSerialPort. Lets the caller wrap ports, e.g. to record them.
+	using PortOpener   = std::function<std::unique_ptr<SerialPort>(size_t deviceIndex, const DeviceConfig& device)>;
+
+	SerialDeviceManager(std::vector<DeviceConfig> deviceConfigs, FrameHandler onFrame, PipelineLatency* latency = nullptr, PortOpener openPort = {});
+
+	~SerialDeviceManager();
+
+	// Function to service the boards until keepRunning is cleared; returns false if the event loop could not be created
+	bool	 Run(const std::atomic<bool>& keepRunning);
+
+	// Boards currently open; safe to read from any thread
+	size_t	 ConnectedCount() const { return connectedCount; }
+
+	// Successful opens over all boards, reconnects included; safe to read from any thread
+	uint64_t ConnectCount() const { return connectCount; }
+
+	// Per-board connection and frame counters; call after Run has returned
+	void	 ReportStats() const;
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	struct Device {
+		DeviceConfig				  config;
+		std::unique_ptr<SerialPort>	  port;
+		std::unique_ptr<SerialReader> reader;	   // Recreated per connection, so a reconnect starts with a clean parser
+		FrameParserStats			  closedStats; // Totals of the connections already closed
+		BoardStats					  boardStats;  // Last stats frame of a connection already closed
+		Clock::time_point			  nextOpenAttempt;
+		std::chrono::milliseconds	  retryDelay;
+		uint64_t					  connectCount = 0;
+	};
+
+	void							 TryOpen(size_t index, Clock::time_point now);
+	void							 Close(size_t index);
+
+	std::vector<Device>				 devices;
+	FrameHandler					 onFrame;
+	PipelineLatency*				 latency;
+	PortOpener						 openPort;
+	std::unique_ptr<SerialEventLoop> eventLoop;
+	std::atomic<size_t>				 connectedCount	= 0;
+	std::atomic<uint64_t>			 connectCount	= 0;
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "SerialPort.h"
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Waits on many serial ports from one thread (epoll on Linux, an I/O completion port on Windows). Ports are identified
+// by a caller-chosen key. Only ports that expose a native handle can be added.
+class SerialEventLoop {
+public:
+	enum class WaitResult { Ready, Timeout, Error };
+
+	struct Event {
+		size_t key	  = 0;
+		bool   hangUp = false; // The device went away; read what is left, then close the port
+	};
+
+	virtual ~SerialEventLoop()										   = default;
+
+	// Start watching a port; it must stay open until it is removed
+	virtual bool	   Add(SerialPort& port, size_t key)			   = 0;
+
+	// Stop watching a port, before it is closed
+	virtual void	   Remove(size_t key)							   = 0;
+
+	// Block until ports are readable or the timeout expires. Every port in events must be drained (read until
+	// ReadAvailable returns 0) before the next call, since the Windows loop only re-arms its wait then.
+	virtual WaitResult Wait(int timeoutMs, std::vector<Event>& events) = 0;
+};
+
+// Function to create the event loop of this platform; returns nullptr if it cannot be created
+std::unique_ptr<SerialEventLoop> CreateSerialEventLoop();
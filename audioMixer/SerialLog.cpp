@@ -0,0 +1,188 @@
+#include "SerialLog.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+namespace {
+	constexpr char	  LOG_MAGIC[4]	  = {'A', 'M', 'X', 'L'};
+	constexpr uint8_t LOG_VERSION	  = 1;
+	constexpr size_t  LOG_HEADER_SIZE = 8;
+	constexpr size_t  MAX_CHUNK_SIZE  = 1 << 16; // Sanity limit when reading; a port read is never this large
+
+	// Function to write an unsigned LEB128 varint
+	void WriteVarint(std::ostream& out, uint64_t value) {
+		uint8_t bytes[10];
+		size_t	count = 0;
+		do {
+			bytes[count] = static_cast<uint8_t>(value & 0x7F);
+			value >>= 7;
+			if(value != 0) { bytes[count] |= 0x80; }
+			++count;
+		} while(value != 0);
+		out.write(reinterpret_cast<const char*>(bytes), static_cast<std::streamsize>(count));
+	}
+
+	// Function to read an unsigned LEB128 varint; returns false at the end of the stream or on an overlong encoding
+	bool ReadVarint(std::istream& in, uint64_t& value) {
+		value = 0;
+		for(int shift = 0; shift < 64; shift += 7) {
+			const int c = in.get();
+			if(c == std::char_traits<char>::eof()) { return false; }
+			value |= static_cast<uint64_t>(c & 0x7F) << shift;
+			if((c & 0x80) == 0) { return true; }
+		}
+		return false;
+	}
+
+	// Passes reads through to the real port and logs them with the time they were read
+	class RecordingSerialPort : public SerialPort {
+	public:
+		RecordingSerialPort(std::unique_ptr<SerialPort> port, std::shared_ptr<SerialLogWriter> log) : port(std::move(port)), log(std::move(log)) {}
+
+		WaitResult WaitForData(const int timeoutMs) override { return port->WaitForData(timeoutMs); }
+
+		int ReadAvailable(uint8_t* buffer, const size_t size) override {
+			const int bytesRead = port->ReadAvailable(buffer, size);
+			if(bytesRead > 0) { log->Append(buffer, static_cast<size_t>(bytesRead), std::chrono::steady_clock::now()); }
+			return bytesRead;
+		}
+
+		std::optional<NativeHandle> GetNativeHandle() const override { return port->GetNativeHandle(); }
+
+	private:
+		std::unique_ptr<SerialPort>		 port;
+		std::shared_ptr<SerialLogWriter> log;
+	};
+
+	// Plays a log back: each record becomes readable once its recorded delay (scaled by speed) has passed
+	class ReplaySerialPort : public SerialPort {
+	public:
+		explicit ReplaySerialPort(const double speed) : speed(speed) {}
+
+		bool OpenLog(const std::string& logPath) {
+			if(!log.Open(logPath)) { return false; }
+			started = std::chrono::steady_clock::now();
+			LoadNext();
+			return true;
+		}
+
+		WaitResult WaitForData(const int timeoutMs) override {
+			if(!havePending) { return WaitResult::Closed; }
+			if(speed <= 0) { return WaitResult::Data; }
+
+			const auto now = std::chrono::steady_clock::now();
+			if(pendingDue <= now) { return WaitResult::Data; }
+
+			const auto timeout = now + std::chrono::milliseconds(timeoutMs);
+			std::this_thread::sleep_until(std::min(pendingDue, timeout));
+			return pendingDue <= timeout ? WaitResult::Data : WaitResult::Timeout;
+		}
+
+		int ReadAvailable(uint8_t* buffer, const size_t size) override {
+			if(!havePending || (speed > 0 && pendingDue > std::chrono::steady_clock::now())) { return 0; }
+
+			// One record per read, so the parser sees the chunking of the original session
+			const size_t count = std::min(size, pending.bytes.size() - pendingOffset);
+			std::memcpy(buffer, pending.bytes.data() + pendingOffset, count);
+			pendingOffset += count;
+			if(pendingOffset == pending.bytes.size()) { LoadNext(); }
+			return static_cast<int>(count);
+		}
+
+	private:
+		void LoadNext() {
+			havePending	  = log.Next(pending);
+			pendingOffset = 0;
+			if(!havePending) { return; }
+
+			recordedElapsed += pending.sincePrevious;
+			if(speed > 0) {
+				pendingDue = started + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+										   std::chrono::duration<double, std::micro>(static_cast<double>(recordedElapsed.count()) / speed));
+			}
+		}
+
+		double								  speed;
+		SerialLogReader						  log;
+		SerialLogChunk						  pending;
+		size_t								  pendingOffset = 0;
+		bool								  havePending	= false;
+		std::chrono::steady_clock::time_point started;
+		std::chrono::steady_clock::time_point pendingDue;
+		std::chrono::microseconds			  recordedElapsed{0}; // Recorded time of the pending record since the log started
+	};
+} // namespace
+
+bool SerialLogWriter::Open(const std::string& path) {
+	file.open(path, std::ios::binary | std::ios::trunc);
+	if(!file.is_open()) {
+		LOG_ERROR("Unable to create serial log {}.", path);
+		return false;
+	}
+
+	const char header[LOG_HEADER_SIZE] = {LOG_MAGIC[0], LOG_MAGIC[1], LOG_MAGIC[2], LOG_MAGIC[3], static_cast<char>(LOG_VERSION), 0, 0, 0};
+	file.write(header, sizeof(header));
+	lastAt	   = std::chrono::steady_clock::now();
+	chunkCount = 0;
+	return true;
+}
+
+void SerialLogWriter::Append(const uint8_t* data, const size_t size, const TimePoint readAt) {
+	const auto sincePrevious = std::chrono::duration_cast<std::chrono::microseconds>(readAt - lastAt);
+	lastAt					 = readAt;
+
+	WriteVarint(file, static_cast<uint64_t>(std::max<int64_t>(0, sincePrevious.count())));
+	WriteVarint(file, size);
+	file.write(reinterpret_cast<const char*>(data), static_cast<std::streamsize>(size));
+	++chunkCount;
+}
+
+bool SerialLogReader::Open(const std::string& path) {
+	file.open(path, std::ios::binary);
+	if(!file.is_open()) {
+		LOG_ERROR("Unable to open serial log {}.", path);
+		return false;
+	}
+
+	char header[LOG_HEADER_SIZE] = {};
+	if(!file.read(header, sizeof(header)) || std::memcmp(header, LOG_MAGIC, sizeof(LOG_MAGIC)) != 0) {
+		LOG_ERROR("{} is not a serial log.", path);
+		return false;
+	}
+	if(static_cast<uint8_t>(header[4]) != LOG_VERSION) {
+		LOG_ERROR("Unsupported serial log version {}.", static_cast<uint8_t>(header[4]));
+		return false;
+	}
+	return true;
+}
+
+bool SerialLogReader::Next(SerialLogChunk& chunk) {
+	uint64_t sincePrevious = 0;
+	uint64_t size		   = 0;
+	if(!ReadVarint(file, sincePrevious) || !ReadVarint(file, size) || size > MAX_CHUNK_SIZE) { return false; }
+
+	chunk.sincePrevious = std::chrono::microseconds(sincePrevious);
+	chunk.bytes.resize(size);
+	return static_cast<bool>(file.read(reinterpret_cast<char*>(chunk.bytes.data()), static_cast<std::streamsize>(size)));
+}
+
+// Function to wrap a port so every byte read from it is also appended to a log
+std::unique_ptr<SerialPort> RecordSerialPort(std::unique_ptr<SerialPort> port, const std::string& logPath) {
+	auto log = std::make_shared<SerialLogWriter>();
+	if(!log->Open(logPath)) { return nullptr; }
+	return RecordSerialPort(std::move(port), std::move(log));
+}
+
+// Function to wrap a port so its reads are appended to an already open log
+std::unique_ptr<SerialPort> RecordSerialPort(std::unique_ptr<SerialPort> port, std::shared_ptr<SerialLogWriter> log) {
+	return std::make_unique<RecordingSerialPort>(std::move(port), std::move(log));
+}
+
+// Function to open a log as a port that replays its records
+std::unique_ptr<SerialPort> OpenReplayPort(const std::string& logPath, const double speed) {
+	auto replayPort = std::make_unique<ReplaySerialPort>(speed);
+	if(!replayPort->OpenLog(logPath)) { return nullptr; }
+	return replayPort;
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include "SerialPort.h"
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Compact binary log of a serial byte stream, written by --record and read back by --replay. Every read from the port
+// becomes one record, so a replay hands the parser the same chunks with the same spacing as the original session.
+//
+//   file header: "AMXL" magic, version (u8), 3 reserved bytes
+//   record:      varint microseconds since the previous record (the first: since recording started),
+//                varint byte count, the bytes
+struct SerialLogChunk {
+	std::chrono::microseconds sincePrevious{0};
+	std::vector<uint8_t>	  bytes;
+};
+
+class SerialLogWriter {
+public:
+	using TimePoint = std::chrono::steady_clock::time_point;
+
+	// Create (or truncate) the log and start its clock
+	bool	 Open(const std::string& path);
+
+	void	 Append(const uint8_t* data, size_t size, TimePoint readAt);
+
+	uint64_t ChunkCount() const { return chunkCount; }
+
+private:
+	std::ofstream file;
+	TimePoint	  lastAt;
+	uint64_t	  chunkCount = 0;
+};
+
+class SerialLogReader {
+public:
+	bool Open(const std::string& path);
+
+	// Read the next record; returns false at the end of the log or on a truncated record
+	bool Next(SerialLogChunk& chunk);
+
+private:
+	std::ifstream file;
+};
+
+// Function to wrap a port so every byte read from it is also appended to a log; returns nullptr if the log cannot be created
+std::unique_ptr<SerialPort> RecordSerialPort(std::unique_ptr<SerialPort> port, const std::string& logPath);
+
+// Function to wrap a port so its reads are appended to an already open log. A board that is reopened after a hot-plug
+// keeps writing to the same log, and the time it was away shows up as the delay before its next record.
+std::unique_ptr<SerialPort> RecordSerialPort(std::unique_ptr<SerialPort> port, std::shared_ptr<SerialLogWriter> log);
+
+// Function to open a log as a port that delivers its records at the recorded pace divided by speed (0 = as fast as the
+// reader takes them). The port reports WaitResult::Closed after the last record. Returns nullptr if the log cannot be read.
+std::unique_ptr<SerialPort> OpenReplayPort(const std::string& logPath, double speed);
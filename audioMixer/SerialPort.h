@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+
+// Byte stream from the mixer board. Implemented with overlapped I/O + WaitCommEvent on Windows and termios + poll elsewhere,
+// and by the record/replay wrappers in SerialLog.h.
+class SerialPort {
+public:
+#ifdef _WIN32
+	using NativeHandle = void*; // HANDLE opened for overlapped I/O
+#else
+	using NativeHandle = int; // File descriptor
+#endif
+
+	enum class WaitResult {
+		Data,
+		Timeout,
+		Error,
+		Closed // The stream has ended (a replayed log ran out); a device port never reports this
+	};
+
+	virtual ~SerialPort() = default;
+
+	// Block until at least one byte is buffered or timeoutMs elapses
+	virtual WaitResult					WaitForData(int timeoutMs) = 0;
+
+	// Read whatever is already buffered without blocking; returns the byte count or -1 on error
+	virtual int							ReadAvailable(uint8_t* buffer, size_t size) = 0;
+
+	// The OS handle a SerialEventLoop waits on; nullopt for ports that can only be waited on with WaitForData
+	virtual std::optional<NativeHandle> GetNativeHandle() const { return std::nullopt; }
+};
+
+// Function to open and configure a serial port (8N1, no flow control); returns nullptr on failure
+std::unique_ptr<SerialPort> OpenSerialPort(const std::string& portName, int baudRate);
@@ -0,0 +1,85 @@
+#include "SerialReader.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace {
+	constexpr int	   WAIT_TIMEOUT_MS		 = 100; // Upper bound on how long shutdown waits for the reader
+	constexpr size_t   READ_CHUNK_SIZE		 = 256;
+	constexpr uint64_t STATS_REPORT_INTERVAL = 1000; // Frames between stats reports
+} // namespace
+
+SerialReader::SerialReader(SerialPort& port, FrameHandler onFrame, PipelineLatency* latency)
+	: port(port)
+	, onFrame(std::move(onFrame))
+	, latency(latency)
+	, parser([this](const MixerFrame& frame) {
+		if(this->latency) { this->latency->RecordFrame(frame, deviceClock); }
+		if(frame.type == MIXER_FRAME_STATS) {
+			// Counters a newer board adds beyond the ones known here are ignored, ones an older board lacks stay 0
+			boardStats.received = true;
+			boardStats.counters.fill(0);
+			std::copy_n(frame.stats.begin(), std::min(frame.stats.size(), boardStats.counters.size()), boardStats.counters.begin());
+		}
+		this->onFrame(frame);
+		if(++framesHandled % STATS_REPORT_INTERVAL == 0) { ReportStats(); }
+	}) {}
+
+void SerialReader::ProcessBytes(const uint8_t* data, const size_t size) { parser.Feed(data, size, std::chrono::steady_clock::now()); }
+
+void SerialReader::Run(const std::atomic<bool>& keepReading) {
+	while(keepReading) {
+		const SerialPort::WaitResult result = port.WaitForData(WAIT_TIMEOUT_MS);
+		if(result == SerialPort::WaitResult::Timeout) { continue; }
+		if(result == SerialPort::WaitResult::Closed) {
+			LOG_INFO("Serial stream ended.");
+			break;
+		}
+		if(result == SerialPort::WaitResult::Error) {
+			LOG_ERROR("Error reading from serial port.");
+			break;
+		}
+
+		// Drain everything the driver has buffered before waiting again
+		if(!Drain()) {
+			LOG_ERROR("Error reading from serial port.");
+			break;
+		}
+	}
+
+	ReportStats();
+}
+
+bool SerialReader::Drain() {
+	uint8_t buffer[READ_CHUNK_SIZE];
+	int		bytesRead = 0;
+	while((bytesRead = port.ReadAvailable(buffer, sizeof(buffer))) > 0) {
+		ProcessBytes(buffer, static_cast<size_t>(bytesRead));
+	}
+	return bytesRead == 0;
+}
+
+void SerialReader::ReportStats() const {
+	const FrameParserStats& stats = parser.Stats();
+	if(stats.framesReceived == 0 && stats.framesCorrupt == 0) { return; }
+
+	if(latency && latency->receivedToApplied.Count() > 0) {
+		using std::chrono::duration_cast;
+		using std::chrono::microseconds;
+		const LatencyHistogram& endToEnd = latency->receivedToApplied;
+		LOG_INFO("Pot latency over {} volume changes: p50 {}us, p99 {}us", endToEnd.Count(), duration_cast<microseconds>(endToEnd.Percentile(50)).count(),
+				 duration_cast<microseconds>(endToEnd.Percentile(99)).count());
+	}
+	ReportBoardStats("Board", boardStats);
+	LOG_INFO("Serial frames: {} received, {} dropped, {} corrupt, {} bytes skipped", stats.framesReceived, stats.framesDropped, stats.framesCorrupt,
+			 stats.bytesSkipped);
+}
+
+void ReportBoardStats(const std::string& label, const BoardStats& stats) {
+	if(!stats.received) { return; }
+	const auto& counters = stats.counters;
+	LOG_INFO("{}: {} ADC overruns, {} ring overruns, sample period {}us (jitter mean {}us, max {}us) over {} batches", label, counters[MIXER_STAT_ADC_OVERRUNS],
+			 counters[MIXER_STAT_RING_OVERRUNS], counters[MIXER_STAT_PERIOD_MEAN_US], counters[MIXER_STAT_JITTER_MEAN_US], counters[MIXER_STAT_JITTER_MAX_US],
+			 counters[MIXER_STAT_BATCHES]);
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "FrameParser.h"
+#include "PipelineLatency.h"
+#include "SerialPort.h"
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+
+// Health of a board's sampling pipeline, from its last stats frame (indexed by mixer_stat_t)
+struct BoardStats {
+	bool								   received = false;
+	std::array<uint32_t, MIXER_STAT_COUNT> counters = {};
+};
+
+// Function to print a board's stats on one line, after label; prints nothing if the board has not sent any
+void ReportBoardStats(const std::string& label, const BoardStats& stats);
+
+// Waits for serial data, drains every buffered byte and hands each complete frame to the handler as soon as it arrives
+class SerialReader {
+public:
+	using FrameHandler = std::function<void(const MixerFrame& frame)>;
+
+	// latency, if given, receives the parse and board-to-host timings of every frame. The board's clock is tracked per
+	// reader, so a reconnected board starts over.
+	SerialReader(SerialPort& port, FrameHandler onFrame, PipelineLatency* latency = nullptr);
+
+	// Function to service the port until keepReading is cleared or the port fails
+	void				Run(const std::atomic<bool>& keepReading);
+
+	// Function to read and parse everything the port has buffered without blocking; returns false if the port failed
+	bool				Drain();
+
+	// Function to feed raw bytes as if they had just been read from the port
+	void				ProcessBytes(const uint8_t* data, size_t size);
+
+	const FrameParserStats& ParserStats() const { return parser.Stats(); }
+
+	const BoardStats&		LatestBoardStats() const { return boardStats; }
+
+	void					ReportStats() const;
+
+private:
+	SerialPort&		 port;
+	FrameHandler	 onFrame;
+	PipelineLatency* latency;
+	DeviceClock		 deviceClock; // Only touched by the serial thread
+	FrameParser		 parser;
+	uint64_t		 framesHandled = 0;
+	BoardStats		 boardStats;
+};
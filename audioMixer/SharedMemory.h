@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+// Named memory region shared with other local processes (POSIX shared memory on Linux, a pagefile-backed file mapping on
+// Windows). The mapping stays valid until the object is destroyed; the creator's destructor also removes the name.
+class SharedMemory {
+public:
+	virtual ~SharedMemory()		= default;
+
+	virtual void*  Data()		= 0;
+
+	virtual size_t Size() const	= 0;
+};
+
+// Function to create (or take over) a region of the given size, zero-filled and accessible to this user only;
+// returns nullptr on failure
+std::unique_ptr<SharedMemory> CreateSharedMemory(const std::string& name, size_t size);
+
+// Function to map an existing region read-only; returns nullptr if it does not exist or is smaller than size
+std::unique_ptr<SharedMemory> OpenSharedMemory(const std::string& name, size_t size);
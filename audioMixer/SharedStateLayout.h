@@ -0,0 +1,208 @@
+// Layout of the shared-memory segment the host publishes its state in, for readers such as overlays and monitoring
+// agents that poll at a high rate and should not pay a socket round trip or a syscall per read.
+//
+// The segment starts with a header that describes the layout, followed by three sections. Each section has a single
+// writer thread and its own sequence counter (seqlock): the writer makes the counter odd, updates the section and makes it
+// even again; a reader copies the section between two loads of the counter and retries if the counter was odd or changed.
+// Readers never write to the segment, so any number of them can read without slowing the host down.
+//
+//   config    written on config load (ConfigReloader)  generation, channel count, per application: pot channel and name
+//   channels  written per frame (serial thread)         per channel: last value from the board, last value routed to the
+//                                                        applications; frame and update counters
+//   volumes   written per applied command (audio worker) per application: volume asked for and volume the backend
+//                                                        applied; applied and failed counters
+//
+// Every section starts on its own cache line, so the writers never share one. Values that are not known yet are NO_VALUE.
+// The layout changes only together with VERSION; a reader must check the header with ValidateSharedState first.
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+namespace SharedState {
+	constexpr uint32_t MAGIC			= 0x53584D41; // "AMXS"
+	constexpr uint16_t VERSION			= 1;
+	constexpr size_t   CACHE_LINE_SIZE	= 64;
+
+	constexpr size_t   MAX_CHANNELS		= 256;
+	constexpr size_t   MAX_APPLICATIONS = 256;
+	constexpr size_t   NAME_SIZE		= 64; // Bytes per application name, including the terminating zero
+	constexpr size_t   NAME_WORDS		= NAME_SIZE / sizeof(uint64_t);
+
+	constexpr uint16_t NO_VALUE			= 0xFFFF;
+	constexpr uint16_t VOLUME_SCALE		= 10000; // Volumes are stored in 0.01% steps
+
+	// Function to get the name the host creates the segment under
+	inline const char* DefaultName() {
+#ifdef _WIN32
+		return "Local\\audioMixerState";
+#else
+		return "/audioMixerState";
+#endif
+	}
+
+	struct alignas(CACHE_LINE_SIZE) Header {
+		std::atomic<uint32_t> magic; // Stored last by the host, once the rest of the segment is initialised
+		uint16_t			  version;
+		uint16_t			  cacheLineSize;
+		uint32_t			  totalSize;
+		uint32_t			  maxChannels;
+		uint32_t			  maxApplications;
+		uint32_t			  nameSize;
+		uint32_t			  configOffset;
+		uint32_t			  channelsOffset;
+		uint32_t			  volumesOffset;
+		uint32_t			  hostProcessId;
+	};
+
+	struct alignas(CACHE_LINE_SIZE) ConfigSection {
+		struct Application {
+			std::atomic<uint16_t> channel; // Global pot channel, NO_VALUE if not bound
+			std::atomic<uint64_t> name[NAME_WORDS];
+		};
+
+		std::atomic<uint32_t> sequence;
+		std::atomic<uint32_t> channelCount;
+		std::atomic<uint32_t> applicationCount;
+		std::atomic<uint64_t> configGeneration;
+		Application			  applications[MAX_APPLICATIONS];
+	};
+
+	struct alignas(CACHE_LINE_SIZE) ChannelSection {
+		std::atomic<uint32_t> sequence;
+		std::atomic<uint32_t> lastDeviceTimestampUs; // Board clock of the last frame
+		std::atomic<uint64_t> framesReceived;
+		std::atomic<uint64_t> updatesReceived;
+		std::atomic<uint16_t> value[MAX_CHANNELS];		 // Last value the board sent (already filtered on the board)
+		std::atomic<uint16_t> routedValue[MAX_CHANNELS]; // Last value that moved the bound applications
+	};
+
+	struct alignas(CACHE_LINE_SIZE) VolumeSection {
+		std::atomic<uint32_t> sequence;
+		std::atomic<uint64_t> configGeneration; // Config the application indices below refer to
+		std::atomic<uint64_t> commandsApplied;
+		std::atomic<uint64_t> backendFailures;
+		std::atomic<uint16_t> target[MAX_APPLICATIONS];	 // Volume asked for by the last command
+		std::atomic<uint16_t> applied[MAX_APPLICATIONS]; // Volume the backend reported as applied
+	};
+
+	struct Layout {
+		Header		   header;
+		ConfigSection  config;
+		ChannelSection channels;
+		VolumeSection  volumes;
+	};
+
+	// The segment is read by other processes, possibly built by another compiler: every field must be a plain lock-free
+	// integer at a fixed offset
+	static_assert(std::atomic<uint16_t>::is_always_lock_free && std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free);
+	static_assert(sizeof(std::atomic<uint16_t>) == 2 && sizeof(std::atomic<uint32_t>) == 4 && sizeof(std::atomic<uint64_t>) == 8);
+	static_assert(std::is_standard_layout_v<Layout>);
+	static_assert(offsetof(Layout, config) % CACHE_LINE_SIZE == 0 && offsetof(Layout, channels) % CACHE_LINE_SIZE == 0 &&
+				  offsetof(Layout, volumes) % CACHE_LINE_SIZE == 0);
+
+	// Copies taken by readers
+	struct ConfigSnapshot {
+		struct Application {
+			uint16_t channel;
+			char	 name[NAME_SIZE];
+		};
+
+		uint32_t	channelCount;
+		uint32_t	applicationCount;
+		uint64_t	configGeneration;
+		Application applications[MAX_APPLICATIONS];
+	};
+
+	struct ChannelSnapshot {
+		uint32_t lastDeviceTimestampUs;
+		uint64_t framesReceived;
+		uint64_t updatesReceived;
+		uint16_t value[MAX_CHANNELS];
+		uint16_t routedValue[MAX_CHANNELS];
+	};
+
+	struct VolumeSnapshot {
+		uint64_t configGeneration;
+		uint64_t commandsApplied;
+		uint64_t backendFailures;
+		uint16_t target[MAX_APPLICATIONS];
+		uint16_t applied[MAX_APPLICATIONS];
+	};
+
+	// Function to check a mapped segment before reading it; returns nullptr if the host has not finished setting it up
+	// or publishes a different layout version
+	inline const Layout* ValidateSharedState(const void* data, const size_t size) {
+		const Layout* layout = static_cast<const Layout*>(data);
+		if(size < sizeof(Header) || layout->header.magic.load(std::memory_order_acquire) != MAGIC) { return nullptr; }
+		const Header& header = layout->header;
+		if(header.version != VERSION || header.totalSize != sizeof(Layout) || size < sizeof(Layout)) { return nullptr; }
+		return layout;
+	}
+
+	// Function to copy a section consistently; returns false if the writer kept it busy for maxAttempts tries
+	template <typename Copy> bool ReadConsistent(const std::atomic<uint32_t>& sequence, Copy&& copy, const int maxAttempts = 10000) {
+		for(int attempt = 0; attempt < maxAttempts; ++attempt) {
+			const uint32_t before = sequence.load(std::memory_order_acquire);
+			if((before & 1) == 0) {
+				copy();
+				std::atomic_thread_fence(std::memory_order_acquire);
+				if(sequence.load(std::memory_order_relaxed) == before) { return true; }
+			}
+
+			// A writer preempted in the middle of an update keeps the section busy for a whole time slice; spinning on the
+			// same core would only delay it further
+			if(attempt >= 16) { std::this_thread::yield(); }
+		}
+		return false;
+	}
+
+	// Function to copy an array of atomics
+	template <typename T, size_t Size> void LoadArray(T (&out)[Size], const std::atomic<T> (&in)[Size]) {
+		for(size_t i = 0; i < Size; ++i) {
+			out[i] = in[i].load(std::memory_order_relaxed);
+		}
+	}
+
+	inline bool ReadConfig(const Layout& layout, ConfigSnapshot& out) {
+		const ConfigSection& section = layout.config;
+		return ReadConsistent(section.sequence, [&] {
+			out.channelCount	 = section.channelCount.load(std::memory_order_relaxed);
+			out.applicationCount = section.applicationCount.load(std::memory_order_relaxed);
+			out.configGeneration = section.configGeneration.load(std::memory_order_relaxed);
+			for(size_t i = 0; i < MAX_APPLICATIONS; ++i) {
+				uint64_t name[NAME_WORDS];
+				LoadArray(name, section.applications[i].name);
+				out.applications[i].channel = section.applications[i].channel.load(std::memory_order_relaxed);
+				std::memcpy(out.applications[i].name, name, NAME_SIZE);
+				out.applications[i].name[NAME_SIZE - 1] = '\0';
+			}
+		});
+	}
+
+	inline bool ReadChannels(const Layout& layout, ChannelSnapshot& out) {
+		const ChannelSection& section = layout.channels;
+		return ReadConsistent(section.sequence, [&] {
+			out.lastDeviceTimestampUs = section.lastDeviceTimestampUs.load(std::memory_order_relaxed);
+			out.framesReceived		  = section.framesReceived.load(std::memory_order_relaxed);
+			out.updatesReceived		  = section.updatesReceived.load(std::memory_order_relaxed);
+			LoadArray(out.value, section.value);
+			LoadArray(out.routedValue, section.routedValue);
+		});
+	}
+
+	inline bool ReadVolumes(const Layout& layout, VolumeSnapshot& out) {
+		const VolumeSection& section = layout.volumes;
+		return ReadConsistent(section.sequence, [&] {
+			out.configGeneration = section.configGeneration.load(std::memory_order_relaxed);
+			out.commandsApplied	 = section.commandsApplied.load(std::memory_order_relaxed);
+			out.backendFailures	 = section.backendFailures.load(std::memory_order_relaxed);
+			LoadArray(out.target, section.target);
+			LoadArray(out.applied, section.applied);
+		});
+	}
+} // namespace SharedState
@@ -0,0 +1,127 @@
+#include "SharedStateWriter.h"
+
+#include <algorithm>
+#include <cstring>
+#include <new>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+	// Function to make a section's sequence odd before changing it
+	void BeginWrite(std::atomic<uint32_t>& sequence) {
+		sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+	}
+
+	// Function to make it even again once the section is consistent
+	void EndWrite(std::atomic<uint32_t>& sequence) { sequence.store(sequence.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+
+	// Function to convert a volume (0.0 to 1.0) to its stored form
+	uint16_t ScaleVolume(const float volume) { return static_cast<uint16_t>(std::clamp(volume, 0.0f, 1.0f) * SharedState::VOLUME_SCALE + 0.5f); }
+
+	uint32_t CurrentProcessId() {
+#ifdef _WIN32
+		return GetCurrentProcessId();
+#else
+		return static_cast<uint32_t>(getpid());
+#endif
+	}
+} // namespace
+
+SharedStateWriter::SharedStateWriter(std::unique_ptr<SharedMemory> sharedMemory) : memory(std::move(sharedMemory)) {
+	layout = new(memory->Data()) SharedState::Layout{};
+
+	SharedState::Header& header = layout->header;
+	header.version				= SharedState::VERSION;
+	header.cacheLineSize		= SharedState::CACHE_LINE_SIZE;
+	header.totalSize			= sizeof(SharedState::Layout);
+	header.maxChannels			= SharedState::MAX_CHANNELS;
+	header.maxApplications		= SharedState::MAX_APPLICATIONS;
+	header.nameSize				= SharedState::NAME_SIZE;
+	header.configOffset			= offsetof(SharedState::Layout, config);
+	header.channelsOffset		= offsetof(SharedState::Layout, channels);
+	header.volumesOffset		= offsetof(SharedState::Layout, volumes);
+	header.hostProcessId		= CurrentProcessId();
+
+	for(size_t i = 0; i < SharedState::MAX_CHANNELS; ++i) {
+		layout->channels.value[i].store(SharedState::NO_VALUE, std::memory_order_relaxed);
+		layout->channels.routedValue[i].store(SharedState::NO_VALUE, std::memory_order_relaxed);
+	}
+	for(size_t i = 0; i < SharedState::MAX_APPLICATIONS; ++i) {
+		layout->config.applications[i].channel.store(SharedState::NO_VALUE, std::memory_order_relaxed);
+		layout->volumes.target[i].store(SharedState::NO_VALUE, std::memory_order_relaxed);
+		layout->volumes.applied[i].store(SharedState::NO_VALUE, std::memory_order_relaxed);
+	}
+	header.magic.store(SharedState::MAGIC, std::memory_order_release);
+}
+
+void SharedStateWriter::PublishConfig(const MixerConfig& config) {
+	SharedState::ConfigSection& section			 = layout->config;
+	const size_t				applicationCount = std::min(config.applications.size(), SharedState::MAX_APPLICATIONS);
+
+	BeginWrite(section.sequence);
+	section.channelCount.store(static_cast<uint32_t>(std::min(config.channelRouter.ChannelCount(), SharedState::MAX_CHANNELS)), std::memory_order_relaxed);
+	section.applicationCount.store(static_cast<uint32_t>(applicationCount), std::memory_order_relaxed);
+	section.configGeneration.store(config.generation, std::memory_order_relaxed);
+	for(size_t i = 0; i < applicationCount; ++i) {
+		const ApplicationConfig& application = config.applications[i];
+		section.applications[i].channel.store(application.potNumber >= 0 ? static_cast<uint16_t>(application.potNumber) : SharedState::NO_VALUE,
+											  std::memory_order_relaxed);
+
+		// Names are stored as whole words, so readers copy them with atomic loads like everything else
+		uint64_t name[SharedState::NAME_WORDS] = {};
+		std::memcpy(name, application.applicationName.c_str(), std::min(application.applicationName.size(), SharedState::NAME_SIZE - 1));
+		for(size_t word = 0; word < SharedState::NAME_WORDS; ++word) {
+			section.applications[i].name[word].store(name[word], std::memory_order_relaxed);
+		}
+	}
+	EndWrite(section.sequence);
+}
+
+void SharedStateWriter::BeginFrame() { BeginWrite(layout->channels.sequence); }
+
+void SharedStateWriter::SetChannel(const size_t channel, const uint16_t value, const bool routed) {
+	if(channel >= SharedState::MAX_CHANNELS) { return; }
+	layout->channels.value[channel].store(value, std::memory_order_relaxed);
+	if(routed) { layout->channels.routedValue[channel].store(value, std::memory_order_relaxed); }
+}
+
+void SharedStateWriter::EndFrame(const uint32_t deviceTimestampUs, const size_t updateCount) {
+	SharedState::ChannelSection& section = layout->channels;
+	section.lastDeviceTimestampUs.store(deviceTimestampUs, std::memory_order_relaxed);
+	section.framesReceived.store(section.framesReceived.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	section.updatesReceived.store(section.updatesReceived.load(std::memory_order_relaxed) + updateCount, std::memory_order_relaxed);
+	EndWrite(section.sequence);
+}
+
+void SharedStateWriter::SetVolume(const uint64_t configGeneration, const size_t applicationIndex, const float target, const float applied) {
+	SharedState::VolumeSection& section = layout->volumes;
+
+	BeginWrite(section.sequence);
+	// Indices of the previous config meant other applications
+	if(section.configGeneration.load(std::memory_order_relaxed) != configGeneration) {
+		section.configGeneration.store(configGeneration, std::memory_order_relaxed);
+		for(size_t i = 0; i < SharedState::MAX_APPLICATIONS; ++i) {
+			section.target[i].store(SharedState::NO_VALUE, std::memory_order_relaxed);
+			section.applied[i].store(SharedState::NO_VALUE, std::memory_order_relaxed);
+		}
+	}
+	if(applicationIndex < SharedState::MAX_APPLICATIONS) {
+		if(target >= 0.0f) { section.target[applicationIndex].store(ScaleVolume(target), std::memory_order_relaxed); }
+		if(applied >= 0.0f) { section.applied[applicationIndex].store(ScaleVolume(applied), std::memory_order_relaxed); }
+	}
+	std::atomic<uint64_t>& counter = applied >= 0.0f ? section.commandsApplied : section.backendFailures;
+	counter.store(counter.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+	EndWrite(section.sequence);
+}
+
+// Function to create the segment and the writer over it
+std::unique_ptr<SharedStateWriter> CreateSharedStateWriter(const std::string& name) {
+	std::unique_ptr<SharedMemory> memory = CreateSharedMemory(name, sizeof(SharedState::Layout));
+	if(!memory) { return nullptr; }
+	return std::make_unique<SharedStateWriter>(std::move(memory));
+}
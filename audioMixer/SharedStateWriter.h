@@ -0,0 +1,39 @@
+#pragma once
+
+#include "MixerConfig.h"
+#include "SharedMemory.h"
+#include "SharedStateLayout.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// Host side of the shared-memory state (see SharedStateLayout.h). Each group of methods updates one section and must
+// only ever be called from that section's thread; an update never blocks, allocates or makes a syscall.
+class SharedStateWriter {
+public:
+	// Initialises the segment and marks it valid for readers
+	explicit SharedStateWriter(std::unique_ptr<SharedMemory> memory);
+
+	// Config thread: describe the applications of a newly published config
+	void					   PublishConfig(const MixerConfig& config);
+
+	// Serial thread: BeginFrame, SetChannel per update, EndFrame; readers see the whole frame or none of it
+	void					   BeginFrame();
+	void					   SetChannel(size_t channel, uint16_t value, bool routed);
+	void					   EndFrame(uint32_t deviceTimestampUs, size_t updateCount);
+
+	// Audio worker: record a command applied for configGeneration. target is negative if not known (a failed adjustment),
+	// applied is negative if the backend call failed.
+	void					   SetVolume(uint64_t configGeneration, size_t applicationIndex, float target, float applied);
+
+	const SharedState::Layout& Layout() const { return *layout; }
+
+private:
+	std::unique_ptr<SharedMemory> memory;
+	SharedState::Layout*		  layout;
+};
+
+// Function to create the segment under name (SharedState::DefaultName() for the app); returns nullptr on failure
+std::unique_ptr<SharedStateWriter> CreateSharedStateWriter(const std::string& name);
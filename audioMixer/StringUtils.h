@@ -0,0 +1,18 @@
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <string>
+#include <string_view>
+
+// Function to lower-case an ASCII string (process and key names are compared case-insensitively)
+inline std::string ToLowerAscii(std::string_view text) {
+	std::string result(text);
+	std::ranges::transform(result, result.begin(), [](const unsigned char c) { return static_cast<char>(std::tolower(c)); });
+	return result;
+}
+
+// Function to compare two ASCII strings case-insensitively without allocating
+inline bool EqualsIgnoreCaseAscii(const std::string_view a, const std::string_view b) {
+	return std::ranges::equal(a, b, [](const unsigned char x, const unsigned char y) { return std::tolower(x) == std::tolower(y); });
+}
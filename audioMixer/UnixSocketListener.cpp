@@ -0,0 +1,141 @@
+#include "LocalSocket.h"
+#include "Log.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+	class UnixSocketConnection : public LocalConnection {
+	public:
+		explicit UnixSocketConnection(const int fd) : fd(fd) {}
+
+		~UnixSocketConnection() override { close(fd); }
+
+		int Read(uint8_t* buffer, const size_t size) override {
+			const ssize_t bytesRead = recv(fd, buffer, size, MSG_DONTWAIT);
+			if(bytesRead == 0) { return -1; } // Orderly shutdown by the peer
+			if(bytesRead < 0) { return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1; }
+			return static_cast<int>(bytesRead);
+		}
+
+		int Write(const uint8_t* data, const size_t size) override {
+			// MSG_NOSIGNAL: a client that went away is reported as an error instead of raising SIGPIPE
+			const ssize_t bytesWritten = send(fd, data, size, MSG_DONTWAIT | MSG_NOSIGNAL);
+			if(bytesWritten < 0) { return (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR) ? 0 : -1; }
+			return static_cast<int>(bytesWritten);
+		}
+
+		int Fd() const { return fd; }
+
+	private:
+		int fd;
+	};
+
+	class UnixSocketListener : public LocalListener {
+	public:
+		UnixSocketListener(const int fd, std::string path) : fd(fd), wakeFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)), path(std::move(path)) {}
+
+		~UnixSocketListener() override {
+			close(fd);
+			close(wakeFd);
+			unlink(path.c_str());
+		}
+
+		std::unique_ptr<LocalConnection> Accept() override {
+			const int clientFd = accept4(fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+			if(clientFd < 0) { return nullptr; }
+			return std::make_unique<UnixSocketConnection>(clientFd);
+		}
+
+		void Wait(const std::vector<LocalConnection*>& connections, const int timeoutMs) override {
+			pollFds.assign({{fd, POLLIN, 0}, {wakeFd, POLLIN, 0}});
+			for(const LocalConnection* connection : connections) {
+				pollFds.push_back({static_cast<const UnixSocketConnection*>(connection)->Fd(), POLLIN, 0});
+			}
+			poll(pollFds.data(), pollFds.size(), timeoutMs);
+
+			// Reading the counter resets it, so the next Wait blocks again
+			uint64_t wakeCount = 0;
+			if(pollFds[1].revents & POLLIN) { (void)read(wakeFd, &wakeCount, sizeof(wakeCount)); }
+		}
+
+		void Wake() override {
+			const uint64_t one = 1;
+			(void)write(wakeFd, &one, sizeof(one));
+		}
+
+	private:
+		int					fd;
+		int					wakeFd; // eventfd that Wake signals
+		std::string			path;
+		std::vector<pollfd>	pollFds; // Reused between waits
+	};
+
+	// Function to fill a socket address; returns false if the path does not fit
+	bool MakeAddress(const std::string& path, sockaddr_un& address) {
+		address			   = {};
+		address.sun_family = AF_UNIX;
+		if(path.size() >= sizeof(address.sun_path)) {
+			LOG_ERROR("Error: Socket path too long: {}", path);
+			return false;
+		}
+		std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+		return true;
+	}
+} // namespace
+
+// Function to listen on a Unix domain socket that only this user can connect to
+std::unique_ptr<LocalListener> ListenLocal(const std::string& endpoint) {
+	sockaddr_un address;
+	if(!MakeAddress(endpoint, address)) { return nullptr; }
+
+	const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+	if(fd < 0) {
+		LOG_ERROR("Error: Unable to create socket: {}", strerror(errno));
+		return nullptr;
+	}
+
+	// A socket file left behind by a crashed instance would make bind fail; one that still answers belongs to a running instance
+	if(ConnectLocal(endpoint)) {
+		LOG_ERROR("Error: {} is already in use.", endpoint);
+		close(fd);
+		return nullptr;
+	}
+	unlink(endpoint.c_str());
+	const mode_t previousMask = umask(0077);
+	const bool	 bound		  = bind(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+	umask(previousMask);
+	if(!bound || listen(fd, SOMAXCONN) != 0) {
+		LOG_ERROR("Error: Unable to listen on {}: {}", endpoint, strerror(errno));
+		close(fd);
+		return nullptr;
+	}
+	return std::make_unique<UnixSocketListener>(fd, endpoint);
+}
+
+// Function to connect to a Unix domain socket
+std::unique_ptr<LocalConnection> ConnectLocal(const std::string& endpoint) {
+	sockaddr_un address;
+	if(!MakeAddress(endpoint, address)) { return nullptr; }
+
+	const int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+	if(fd < 0) { return nullptr; }
+	if(connect(fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0) {
+		close(fd);
+		return nullptr;
+	}
+	return std::make_unique<UnixSocketConnection>(fd);
+}
+
+// Function to pick a per-user socket path
+std::string DefaultLocalEndpoint() {
+	if(const char* runtimeDir = std::getenv("XDG_RUNTIME_DIR"); runtimeDir && *runtimeDir) { return std::string(runtimeDir) + "/audioMixer.sock"; }
+	return "/tmp/audioMixer-" + std::to_string(getuid()) + ".sock";
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+
+// Windows virtual-key codes, spelled out so key names can be resolved (and benchmarked) without <windows.h>.
+// The values match the VK_* macros, which the hook reports.
+namespace VirtualKey {
+	constexpr uint8_t Back		   = 0x08;
+	constexpr uint8_t Tab		   = 0x09;
+	constexpr uint8_t Return	   = 0x0D;
+	constexpr uint8_t Shift		   = 0x10;
+	constexpr uint8_t Control	   = 0x11;
+	constexpr uint8_t Menu		   = 0x12;
+	constexpr uint8_t Pause		   = 0x13;
+	constexpr uint8_t Capital	   = 0x14;
+	constexpr uint8_t Escape	   = 0x1B;
+	constexpr uint8_t Space		   = 0x20;
+	constexpr uint8_t Prior		   = 0x21;
+	constexpr uint8_t Next		   = 0x22;
+	constexpr uint8_t End		   = 0x23;
+	constexpr uint8_t Home		   = 0x24;
+	constexpr uint8_t Left		   = 0x25;
+	constexpr uint8_t Up		   = 0x26;
+	constexpr uint8_t Right		   = 0x27;
+	constexpr uint8_t Down		   = 0x28;
+	constexpr uint8_t Snapshot	   = 0x2C;
+	constexpr uint8_t Insert	   = 0x2D;
+	constexpr uint8_t Delete	   = 0x2E;
+	constexpr uint8_t LWin		   = 0x5B;
+	constexpr uint8_t RWin		   = 0x5C;
+	constexpr uint8_t Apps		   = 0x5D;
+	constexpr uint8_t NumPad0	   = 0x60;
+	constexpr uint8_t F1		   = 0x70;
+	constexpr uint8_t NumLock	   = 0x90;
+	constexpr uint8_t Scroll	   = 0x91;
+	constexpr uint8_t LShift	   = 0xA0;
+	constexpr uint8_t RShift	   = 0xA1;
+	constexpr uint8_t LControl	   = 0xA2;
+	constexpr uint8_t RControl	   = 0xA3;
+	constexpr uint8_t LMenu		   = 0xA4;
+	constexpr uint8_t RMenu		   = 0xA5;
+	constexpr uint8_t VolumeMute   = 0xAD;
+	constexpr uint8_t VolumeDown   = 0xAE;
+	constexpr uint8_t VolumeUp	   = 0xAF;
+} // namespace VirtualKey
@@ -0,0 +1,23 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+// Small, trivially copyable volume request queued by the input paths
+struct VolumeCommand {
+	enum class Type : uint8_t {
+		Set,   // value is the absolute volume (0.0 to 1.0), sent by the pots
+		Adjust // value is added to the current volume, sent by the hotkeys
+	};
+
+	using TimePoint = std::chrono::steady_clock::time_point;
+
+	Type	  type			   = Type::Set;
+	uint16_t  applicationIndex = 0; // Index into the loaded application list
+	float	  value			   = 0.0f;
+
+	// Latency instrumentation: when the serial bytes behind the command were read and when it was queued. Left at the
+	// epoch for commands that are not timed (hotkeys).
+	TimePoint receivedAt = {};
+	TimePoint routedAt	 = {};
+};
@@ -0,0 +1,94 @@
+#include "VolumeScheduler.h"
+
+#include <algorithm>
+
+void VolumeScheduler::Submit(const VolumeCommand& command) {
+	// An index the config does not have (stale, or from a misbehaving control client) must not grow the slots
+	if(command.applicationIndex >= slots.size()) { return; }
+	ApplicationSlot& slot = slots[command.applicationIndex];
+
+	if(command.type == VolumeCommand::Type::Set) {
+		setReceived.fetch_add(1, std::memory_order_relaxed);
+		slot.hasTarget = true;
+		slot.target	   = command.value;
+		slot.delta	   = 0.0f; // The pot position wins over earlier hotkey nudges
+	} else {
+		adjustReceived.fetch_add(1, std::memory_order_relaxed);
+		slot.delta += command.value;
+	}
+
+	if(command.receivedAt != TimePoint{}) {
+		slot.receivedAt = command.receivedAt;
+		slot.routedAt	= command.routedAt;
+	}
+
+	if(!slot.pending) {
+		slot.pending = true;
+		pendingApplications.push_back(command.applicationIndex);
+	}
+}
+
+void VolumeScheduler::Reset(const size_t applicationCount) {
+	slots.assign(applicationCount, {});
+	pendingApplications.clear();
+}
+
+// Function to turn an application's pending state into a single command and clear it
+VolumeCommand VolumeScheduler::Take(const uint16_t applicationIndex) {
+	ApplicationSlot& slot = slots[applicationIndex];
+	VolumeCommand	 command;
+	command.applicationIndex = applicationIndex;
+	if(slot.hasTarget) {
+		command.type  = VolumeCommand::Type::Set;
+		command.value = std::clamp(slot.target + slot.delta, 0.0f, 1.0f);
+	} else {
+		command.type  = VolumeCommand::Type::Adjust;
+		command.value = slot.delta;
+	}
+
+	command.receivedAt = slot.receivedAt;
+	command.routedAt   = slot.routedAt;
+
+	slot.pending	= false;
+	slot.hasTarget	= false;
+	slot.delta		= 0.0f;
+	slot.receivedAt = TimePoint{};
+	slot.routedAt	= TimePoint{};
+	return command;
+}
+
+VolumeScheduler::TimePoint VolumeScheduler::ApplyDue(const TimePoint now, const ApplyFunction& apply) {
+	TimePoint nextDue = TimePoint::max();
+
+	for(size_t i = 0; i < pendingApplications.size();) {
+		const uint16_t	 applicationIndex = pendingApplications[i];
+		ApplicationSlot& slot			  = slots[applicationIndex];
+		const TimePoint	 due			  = slot.lastApplied == TimePoint::min() ? now : slot.lastApplied + minInterval;
+		if(due > now) {
+			nextDue = std::min(nextDue, due);
+			++i;
+			continue;
+		}
+
+		slot.lastApplied = now;
+		apply(Take(applicationIndex));
+		applied.fetch_add(1, std::memory_order_relaxed);
+
+		// Order of pending applications does not matter, so remove by swapping with the last one
+		pendingApplications[i] = pendingApplications.back();
+		pendingApplications.pop_back();
+	}
+	return nextDue;
+}
+
+void VolumeScheduler::Flush(const ApplyFunction& apply) {
+	for(const uint16_t applicationIndex : pendingApplications) {
+		apply(Take(applicationIndex));
+		applied.fetch_add(1, std::memory_order_relaxed);
+	}
+	pendingApplications.clear();
+}
+
+VolumeSchedulerStats VolumeScheduler::Stats() const {
+	return {setReceived.load(std::memory_order_relaxed), adjustReceived.load(std::memory_order_relaxed), applied.load(std::memory_order_relaxed)};
+}
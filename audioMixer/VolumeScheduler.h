@@ -0,0 +1,64 @@
+#pragma once
+
+#include "VolumeCommand.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+struct VolumeSchedulerStats {
+	uint64_t setReceived	= 0;
+	uint64_t adjustReceived = 0;
+	uint64_t applied		= 0; // Backend calls made; received - applied commands were coalesced away
+};
+
+// Keeps one pending target per application and applies it at most once per minInterval, so a pot sweep or an
+// auto-repeating hotkey costs one backend call per interval instead of one per intermediate value.
+// Commands merge in arrival order: a Set replaces whatever is pending, an Adjust adds to it. Commands for applications
+// past the count given to Reset are dropped. Time is passed in by the caller, which lets tests and benchmarks drive the
+// scheduler with a simulated clock.
+class VolumeScheduler {
+public:
+	using TimePoint		= std::chrono::steady_clock::time_point;
+	using ApplyFunction = std::function<void(const VolumeCommand&)>;
+
+	explicit VolumeScheduler(const std::chrono::nanoseconds minInterval) : minInterval(minInterval) {}
+
+	void				 Submit(const VolumeCommand& command);
+
+	// Function to drop every pending update and rate limit and track applicationCount applications, e.g. for a new
+	// config whose application indices mean something else
+	void				 Reset(size_t applicationCount);
+
+	// Apply every pending update whose interval has elapsed; returns when the next one is due (TimePoint::max() if none)
+	TimePoint			 ApplyDue(TimePoint now, const ApplyFunction& apply);
+
+	// Apply everything pending regardless of the rate limit
+	void				 Flush(const ApplyFunction& apply);
+
+	bool				 HasPending() const { return !pendingApplications.empty(); }
+
+	VolumeSchedulerStats Stats() const;
+
+private:
+	struct ApplicationSlot {
+		bool	  pending	  = false;
+		bool	  hasTarget	  = false; // A Set is part of the pending update
+		float	  target	  = 0.0f;
+		float	  delta		  = 0.0f; // Sum of Adjusts received after the last Set
+		TimePoint lastApplied = TimePoint::min();
+		TimePoint receivedAt;		  // Timestamps of the latest timed command merged into the update
+		TimePoint routedAt;
+	};
+
+	VolumeCommand				 Take(uint16_t applicationIndex);
+
+	std::chrono::nanoseconds	 minInterval;
+	std::vector<ApplicationSlot> slots;
+	std::vector<uint16_t>		 pendingApplications;
+	std::atomic<uint64_t>		 setReceived	= 0;
+	std::atomic<uint64_t>		 adjustReceived = 0;
+	std::atomic<uint64_t>		 applied		= 0;
+};
@@ -0,0 +1,15 @@
+#pragma once
+
+#include <string>
+
+// What a pot or hotkey controls: the sessions of an application on one audio device, or a device's own volume.
+//   {"", "chrome.exe"}          chrome.exe on the default output
+//   {"Headset", "chrome.exe"}   chrome.exe on the device named (or with the ID) "Headset"
+//   {"", ""}                    master volume of the default output
+//   {"Microphone (USB)", ""}    gain of that capture device
+struct VolumeTarget {
+	std::string device;			 // Endpoint ID or friendly name (case-insensitive); empty for the default output
+	std::string applicationName; // Executable name (case-insensitive); empty for the device's own volume
+
+	bool		IsEndpoint() const { return applicationName.empty(); }
+};
@@ -0,0 +1,432 @@
+#include "WasapiAudioBackend.h"
+#include "Log.h"
+#include "ProcessSource.h"
+
+#include <algorithm>
+#include <functiondiscoverykeys_devpkey.h>
+
+namespace {
+	// Forwards session expiry/disconnect to the backend so its cache is rebuilt on the next volume change, and drops the
+	// session's PID from the process index so a recycled PID is resolved again
+	class SessionEvents : public IAudioSessionEvents {
+	public:
+		SessionEvents(AudioBackend& backend, ProcessIndex& processIndex, const DWORD processId) : backend(backend), processIndex(processIndex), processId(processId) {}
+
+		HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvInterface) override {
+			if(riid == __uuidof(IUnknown) || riid == __uuidof(IAudioSessionEvents)) {
+				AddRef();
+				*ppvInterface = static_cast<IAudioSessionEvents*>(this);
+				return S_OK;
+			}
+			*ppvInterface = nullptr;
+			return E_NOINTERFACE;
+		}
+
+		ULONG STDMETHODCALLTYPE AddRef() override { return InterlockedIncrement(&refCount); }
+
+		ULONG STDMETHODCALLTYPE Release() override {
+			const ULONG count = InterlockedDecrement(&refCount);
+			if(count == 0) { delete this; }
+			return count;
+		}
+
+		// Title patterns may match differently under the new name
+		HRESULT STDMETHODCALLTYPE OnDisplayNameChanged(LPCWSTR, LPCGUID) override {
+			backend.InvalidateSessions();
+			return S_OK;
+		}
+
+		HRESULT STDMETHODCALLTYPE OnIconPathChanged(LPCWSTR, LPCGUID) override { return S_OK; }
+
+		HRESULT STDMETHODCALLTYPE OnSimpleVolumeChanged(float, BOOL, LPCGUID) override { return S_OK; }
+
+		HRESULT STDMETHODCALLTYPE OnChannelVolumeChanged(DWORD, float[], DWORD, LPCGUID) override { return S_OK; }
+
+		HRESULT STDMETHODCALLTYPE OnGroupingParamChanged(LPCGUID, LPCGUID) override { return S_OK; }
+
+		HRESULT STDMETHODCALLTYPE OnStateChanged(const AudioSessionState newState) override {
+			if(newState == AudioSessionStateExpired) {
+				processIndex.RemoveProcess(processId);
+				backend.InvalidateSessions();
+			}
+			return S_OK;
+		}
+
+		HRESULT STDMETHODCALLTYPE OnSessionDisconnected(AudioSessionDisconnectReason) override {
+			processIndex.RemoveProcess(processId);
+			backend.InvalidateSessions();
+			return S_OK;
+		}
+
+	private:
+		LONG		  refCount = 1;
+		AudioBackend& backend;
+		ProcessIndex& processIndex;
+		DWORD		  processId;
+	};
+
+	// Cached session: owns the control/volume interfaces for as long as the session stays in the cache
+	class WasapiAudioSession : public AudioSession {
+	public:
+		WasapiAudioSession(AudioBackend& backend, ProcessIndex& processIndex, const DWORD processId, IAudioSessionControl* pSessionControl,
+						   ISimpleAudioVolume* pSimpleAudioVolume)
+			: pSessionControl(pSessionControl)
+			, pSimpleAudioVolume(pSimpleAudioVolume)
+			, pSessionEvents(new SessionEvents(backend, processIndex, processId)) {
+			pSessionControl->AddRef();
+			pSimpleAudioVolume->AddRef();
+			pSessionControl->RegisterAudioSessionNotification(pSessionEvents);
+		}
+
+		~WasapiAudioSession() override {
+			pSessionControl->UnregisterAudioSessionNotification(pSessionEvents);
+			pSessionEvents->Release();
+			pSimpleAudioVolume->Release();
+			pSessionControl->Release();
+		}
+
+		bool GetVolume(float& volume) override { return SUCCEEDED(pSimpleAudioVolume->GetMasterVolume(&volume)); }
+
+		bool SetVolume(const float volume) override { return SUCCEEDED(pSimpleAudioVolume->SetMasterVolume(volume, nullptr)); }
+
+	private:
+		IAudioSessionControl* pSessionControl;
+		ISimpleAudioVolume*	  pSimpleAudioVolume;
+		SessionEvents*		  pSessionEvents;
+	};
+	// Cached endpoint: master volume of a render device, or gain of a capture device
+	class WasapiEndpointVolume : public AudioSession {
+	public:
+		explicit WasapiEndpointVolume(IAudioEndpointVolume* pEndpointVolume) : pEndpointVolume(pEndpointVolume) {}
+
+		~WasapiEndpointVolume() override { pEndpointVolume->Release(); }
+
+		bool GetVolume(float& volume) override { return SUCCEEDED(pEndpointVolume->GetMasterVolumeLevelScalar(&volume)); }
+
+		bool SetVolume(const float volume) override { return SUCCEEDED(pEndpointVolume->SetMasterVolumeLevelScalar(volume, nullptr)); }
+
+	private:
+		IAudioEndpointVolume* pEndpointVolume;
+	};
+
+	// Function to convert a WASAPI wide string (endpoint ID or friendly name) to UTF-8
+	std::string ToUtf8(const LPCWSTR text) {
+		const int size = WideCharToMultiByte(CP_UTF8, 0, text, -1, nullptr, 0, nullptr, nullptr);
+		if(size <= 1) { return {}; }
+		std::string result(static_cast<size_t>(size - 1), '\0');
+		WideCharToMultiByte(CP_UTF8, 0, text, -1, result.data(), size, nullptr, nullptr);
+		return result;
+	}
+
+	// Function to convert an endpoint ID back to the wide string IMMDeviceEnumerator::GetDevice takes
+	std::wstring ToWide(const std::string& text) {
+		const int size = MultiByteToWideChar(CP_UTF8, 0, text.c_str(), -1, nullptr, 0);
+		if(size <= 1) { return {}; }
+		std::wstring result(static_cast<size_t>(size - 1), L'\0');
+		MultiByteToWideChar(CP_UTF8, 0, text.c_str(), -1, result.data(), size);
+		return result;
+	}
+} // namespace
+
+// Forwards IAudioSessionNotification::OnSessionCreated to the backend's cache and indexes the new session's process
+class WasapiAudioBackend::SessionNotification : public IAudioSessionNotification {
+public:
+	SessionNotification(AudioBackend& backend, ProcessIndex& processIndex) : backend(backend), processIndex(processIndex) {}
+
+	HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvInterface) override {
+		if(riid == __uuidof(IUnknown) || riid == __uuidof(IAudioSessionNotification)) {
+			AddRef();
+			*ppvInterface = static_cast<IAudioSessionNotification*>(this);
+			return S_OK;
+		}
+		*ppvInterface = nullptr;
+		return E_NOINTERFACE;
+	}
+
+	ULONG STDMETHODCALLTYPE AddRef() override { return InterlockedIncrement(&refCount); }
+
+	ULONG STDMETHODCALLTYPE Release() override {
+		const ULONG count = InterlockedDecrement(&refCount);
+		if(count == 0) { delete this; }
+		return count;
+	}
+
+	HRESULT STDMETHODCALLTYPE OnSessionCreated(IAudioSessionControl* pNewSession) override {
+		IAudioSessionControl2* pSessionControl2 = nullptr;
+		if(pNewSession && SUCCEEDED(pNewSession->QueryInterface(__uuidof(IAudioSessionControl2), reinterpret_cast<void**>(&pSessionControl2)))) {
+			DWORD processId = 0;
+			if(SUCCEEDED(pSessionControl2->GetProcessId(&processId))) {
+				if(const auto processName = QueryProcessName(processId)) { processIndex.AddProcess(processId, *processName); }
+			}
+			pSessionControl2->Release();
+		}
+		backend.InvalidateSessions();
+		return S_OK;
+	}
+
+private:
+	LONG		  refCount = 1;
+	AudioBackend& backend;
+	ProcessIndex& processIndex;
+};
+
+// Forwards IMMNotificationClient device changes to the backend, so the device list is enumerated again on the next volume change
+class WasapiAudioBackend::DeviceNotification : public IMMNotificationClient {
+public:
+	explicit DeviceNotification(AudioBackend& backend) : backend(backend) {}
+
+	HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppvInterface) override {
+		if(riid == __uuidof(IUnknown) || riid == __uuidof(IMMNotificationClient)) {
+			AddRef();
+			*ppvInterface = static_cast<IMMNotificationClient*>(this);
+			return S_OK;
+		}
+		*ppvInterface = nullptr;
+		return E_NOINTERFACE;
+	}
+
+	ULONG STDMETHODCALLTYPE AddRef() override { return InterlockedIncrement(&refCount); }
+
+	ULONG STDMETHODCALLTYPE Release() override {
+		const ULONG count = InterlockedDecrement(&refCount);
+		if(count == 0) { delete this; }
+		return count;
+	}
+
+	HRESULT STDMETHODCALLTYPE OnDeviceStateChanged(LPCWSTR, DWORD) override {
+		backend.InvalidateDevices();
+		return S_OK;
+	}
+
+	HRESULT STDMETHODCALLTYPE OnDeviceAdded(LPCWSTR) override {
+		backend.InvalidateDevices();
+		return S_OK;
+	}
+
+	HRESULT STDMETHODCALLTYPE OnDeviceRemoved(LPCWSTR) override {
+		backend.InvalidateDevices();
+		return S_OK;
+	}
+
+	HRESULT STDMETHODCALLTYPE OnDefaultDeviceChanged(EDataFlow, ERole, LPCWSTR) override {
+		backend.InvalidateDevices();
+		return S_OK;
+	}
+
+	// Only a rename changes what a target can match; the other properties change far too often to enumerate on
+	HRESULT STDMETHODCALLTYPE OnPropertyValueChanged(LPCWSTR, const PROPERTYKEY key) override {
+		if(key.fmtid == PKEY_Device_FriendlyName.fmtid && key.pid == PKEY_Device_FriendlyName.pid) { backend.InvalidateDevices(); }
+		return S_OK;
+	}
+
+private:
+	LONG		  refCount = 1;
+	AudioBackend& backend;
+};
+
+WasapiAudioBackend::~WasapiAudioBackend() {
+	for(auto& [deviceId, manager] : sessionManagers) {
+		ReleaseSessionManager(manager);
+	}
+	if(pDeviceEnumerator) {
+		if(pDeviceNotification) { pDeviceEnumerator->UnregisterEndpointNotificationCallback(pDeviceNotification); }
+		pDeviceEnumerator->Release();
+	}
+	if(pDeviceNotification) { pDeviceNotification->Release(); }
+}
+
+// Function to open the device enumerator once for the lifetime of the backend; endpoints are activated on first use
+bool WasapiAudioBackend::Initialize() {
+	HRESULT hr =
+		CoCreateInstance(__uuidof(MMDeviceEnumerator), nullptr, CLSCTX_ALL, __uuidof(IMMDeviceEnumerator), reinterpret_cast<void**>(&pDeviceEnumerator));
+	if(FAILED(hr)) {
+		LOG_ERROR("Failed to create MMDeviceEnumerator.");
+		return false;
+	}
+
+	pDeviceNotification = new DeviceNotification(*this);
+	hr					= pDeviceEnumerator->RegisterEndpointNotificationCallback(pDeviceNotification);
+	if(FAILED(hr)) { LOG_ERROR("Failed to register device notification, devices will only be refreshed on errors."); }
+
+	return true;
+}
+
+void WasapiAudioBackend::ReleaseSessionManager(SessionManager& manager) {
+	if(manager.pSessionManager) {
+		if(manager.pSessionNotification) { manager.pSessionManager->UnregisterSessionNotification(manager.pSessionNotification); }
+		manager.pSessionManager->Release();
+	}
+	if(manager.pSessionNotification) { manager.pSessionNotification->Release(); }
+	manager = {};
+}
+
+IAudioSessionManager2* WasapiAudioBackend::GetSessionManager(const std::string& deviceId) {
+	if(const auto it = sessionManagers.find(deviceId); it != sessionManagers.end()) { return it->second.pSessionManager; }
+
+	IMMDevice* pDevice = nullptr;
+	HRESULT	   hr	   = pDeviceEnumerator->GetDevice(ToWide(deviceId).c_str(), &pDevice);
+	if(FAILED(hr)) {
+		LOG_ERROR("Failed to open audio device {}.", deviceId);
+		return nullptr;
+	}
+
+	SessionManager manager;
+	hr = pDevice->Activate(__uuidof(IAudioSessionManager2), CLSCTX_ALL, nullptr, reinterpret_cast<void**>(&manager.pSessionManager));
+	pDevice->Release();
+	if(FAILED(hr)) {
+		LOG_ERROR("Failed to get IAudioSessionManager2 for {}.", deviceId);
+		return nullptr;
+	}
+
+	manager.pSessionNotification = new SessionNotification(*this, processIndex);
+	hr							 = manager.pSessionManager->RegisterSessionNotification(manager.pSessionNotification);
+	if(FAILED(hr)) { LOG_ERROR("Failed to register session notification, sessions will only be refreshed on errors."); }
+
+	sessionManagers[deviceId] = manager;
+	return manager.pSessionManager;
+}
+
+std::optional<std::string> WasapiAudioBackend::GetProcessName(const DWORD processId) {
+	if(auto processName = processIndex.FindName(processId)) { return processName; }
+
+	auto processName = QueryProcessName(processId);
+	if(processName) { processIndex.AddProcess(processId, *processName); }
+	return processName;
+}
+
+std::string WasapiAudioBackend::GetProcessPath(const uint32_t processId) { return QueryProcessPath(processId).value_or(""); }
+
+// Function to list every active endpoint with its ID, friendly name, flow and endpoint volume
+bool WasapiAudioBackend::EnumerateDevices(std::vector<AudioDeviceEntry>& entries) {
+	std::string defaultId;
+	IMMDevice*	pDefaultDevice = nullptr;
+	if(SUCCEEDED(pDeviceEnumerator->GetDefaultAudioEndpoint(eRender, eConsole, &pDefaultDevice))) {
+		LPWSTR pDefaultId = nullptr;
+		if(SUCCEEDED(pDefaultDevice->GetId(&pDefaultId))) {
+			defaultId = ToUtf8(pDefaultId);
+			CoTaskMemFree(pDefaultId);
+		}
+		pDefaultDevice->Release();
+	}
+
+	IMMDeviceCollection* pCollection = nullptr;
+	HRESULT				 hr			 = pDeviceEnumerator->EnumAudioEndpoints(eAll, DEVICE_STATE_ACTIVE, &pCollection);
+	if(FAILED(hr)) {
+		LOG_ERROR("Failed to enumerate audio endpoints.");
+		return false;
+	}
+
+	UINT deviceCount = 0;
+	pCollection->GetCount(&deviceCount);
+	for(UINT i = 0; i < deviceCount; ++i) {
+		IMMDevice* pDevice = nullptr;
+		if(FAILED(pCollection->Item(i, &pDevice))) { continue; }
+
+		AudioDeviceEntry entry;
+		LPWSTR			 pId = nullptr;
+		if(SUCCEEDED(pDevice->GetId(&pId))) {
+			entry.id = ToUtf8(pId);
+			CoTaskMemFree(pId);
+		}
+		entry.isDefault = !entry.id.empty() && entry.id == defaultId;
+
+		IPropertyStore* pProperties = nullptr;
+		if(SUCCEEDED(pDevice->OpenPropertyStore(STGM_READ, &pProperties))) {
+			PROPVARIANT friendlyName;
+			PropVariantInit(&friendlyName);
+			if(SUCCEEDED(pProperties->GetValue(PKEY_Device_FriendlyName, &friendlyName)) && friendlyName.vt == VT_LPWSTR) {
+				entry.name = ToUtf8(friendlyName.pwszVal);
+			}
+			PropVariantClear(&friendlyName);
+			pProperties->Release();
+		}
+
+		IMMEndpoint* pEndpoint = nullptr;
+		if(SUCCEEDED(pDevice->QueryInterface(__uuidof(IMMEndpoint), reinterpret_cast<void**>(&pEndpoint)))) {
+			EDataFlow flow = eRender;
+			if(SUCCEEDED(pEndpoint->GetDataFlow(&flow)) && flow == eCapture) { entry.flow = AudioDeviceFlow::Capture; }
+			pEndpoint->Release();
+		}
+
+		IAudioEndpointVolume* pEndpointVolume = nullptr;
+		if(SUCCEEDED(pDevice->Activate(__uuidof(IAudioEndpointVolume), CLSCTX_ALL, nullptr, reinterpret_cast<void**>(&pEndpointVolume)))) {
+			entry.volume = std::make_shared<WasapiEndpointVolume>(pEndpointVolume);
+		}
+		pDevice->Release();
+
+		if(!entry.id.empty()) { entries.push_back(std::move(entry)); }
+	}
+	pCollection->Release();
+
+	// Session managers of endpoints that went away (or were disabled) are released with their notifications
+	std::erase_if(sessionManagers, [&entries](auto& manager) {
+		if(std::ranges::any_of(entries, [&manager](const AudioDeviceEntry& entry) { return entry.id == manager.first; })) { return false; }
+		ReleaseSessionManager(manager.second);
+		return true;
+	});
+	return true;
+}
+
+// Function to enumerate every session on an endpoint (also arms OnSessionCreated, which only fires after an enumeration)
+bool WasapiAudioBackend::EnumerateSessions(const AudioDeviceEntry& device, std::vector<AudioSessionEntry>& sessions) {
+	IAudioSessionManager2* pSessionManager = GetSessionManager(device.id);
+	if(!pSessionManager) { return false; }
+
+	IAudioSessionEnumerator* pSessionEnumerator = nullptr;
+	HRESULT					 hr					= pSessionManager->GetSessionEnumerator(&pSessionEnumerator);
+	if(FAILED(hr)) {
+		LOG_ERROR("Failed to get session enumerator.");
+		return false;
+	}
+
+	int sessionCount = 0;
+	hr				 = pSessionEnumerator->GetCount(&sessionCount);
+	if(FAILED(hr)) {
+		LOG_ERROR("Failed to get session count.");
+		pSessionEnumerator->Release();
+		return false;
+	}
+
+	// Full process listing only every PROCESS_REFRESH_INTERVAL; session events keep the index current in between
+	const auto now = std::chrono::steady_clock::now();
+	if(processIndex.Size() == 0 || now - lastProcessRefresh >= PROCESS_REFRESH_INTERVAL) {
+		std::vector<ProcessInfo> processes;
+		if(EnumerateProcesses(processes)) { processIndex.Rebuild(processes); }
+		lastProcessRefresh = now;
+	}
+
+	for(int i = 0; i < sessionCount; ++i) {
+		IAudioSessionControl* pSessionControl = nullptr;
+		hr									  = pSessionEnumerator->GetSession(i, &pSessionControl);
+		if(FAILED(hr)) { continue; }
+
+		IAudioSessionControl2* pSessionControl2 = nullptr;
+		hr = pSessionControl->QueryInterface(__uuidof(IAudioSessionControl2), reinterpret_cast<void**>(&pSessionControl2));
+		if(SUCCEEDED(hr)) {
+			DWORD sessionProcessId = 0;
+			hr					   = pSessionControl2->GetProcessId(&sessionProcessId);
+			const auto processName = SUCCEEDED(hr) ? GetProcessName(sessionProcessId) : std::nullopt;
+			if(processName) {
+				ISimpleAudioVolume* pSimpleAudioVolume = nullptr;
+				hr = pSessionControl->QueryInterface(__uuidof(ISimpleAudioVolume), reinterpret_cast<void**>(&pSimpleAudioVolume));
+				if(SUCCEEDED(hr)) {
+					std::string displayName;
+					LPWSTR		pDisplayName = nullptr;
+					if(SUCCEEDED(pSessionControl->GetDisplayName(&pDisplayName))) {
+						displayName = ToUtf8(pDisplayName);
+						CoTaskMemFree(pDisplayName);
+					}
+					sessions.push_back({*processName, sessionProcessId,
+										std::make_shared<WasapiAudioSession>(*this, processIndex, sessionProcessId, pSessionControl, pSimpleAudioVolume),
+										std::move(displayName)});
+					pSimpleAudioVolume->Release();
+				}
+			}
+			pSessionControl2->Release();
+		}
+		pSessionControl->Release();
+	}
+
+	pSessionEnumerator->Release();
+	return true;
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include "AudioBackend.h"
+#include "ProcessIndex.h"
+
+#include <audiopolicy.h>
+#include <chrono>
+#include <endpointvolume.h>
+#include <mmdeviceapi.h>
+#include <optional>
+#include <unordered_map>
+#include <windows.h>
+
+// WASAPI backend over every active render and capture endpoint. Endpoints are listed once through IMMDeviceEnumerator
+// and listed again only when an IMMNotificationClient reports a device change; each endpoint's IAudioEndpointVolume
+// controls its master volume or mic gain. An endpoint's IAudioSessionManager2 is activated the first time one of its
+// sessions is needed and kept, together with every ISimpleAudioVolume, between volume changes; session created/expired
+// notifications tell the base class when the cached handles are stale.
+// Session PIDs are named through a ProcessIndex that is updated per session event and only fully re-listed every
+// PROCESS_REFRESH_INTERVAL, instead of taking a Toolhelp snapshot of every process on each cache rebuild.
+// Initialize() and every volume call must happen on threads that called AttachCurrentThread() (joins the COM MTA).
+class WasapiAudioBackend : public AudioBackend {
+public:
+	~WasapiAudioBackend() override;
+
+	void AttachCurrentThread() override { CoInitializeEx(nullptr, COINIT_MULTITHREADED); }
+
+	void DetachCurrentThread() override { CoUninitialize(); }
+
+	bool Initialize();
+
+protected:
+	bool		EnumerateDevices(std::vector<AudioDeviceEntry>& entries) override;
+	bool		EnumerateSessions(const AudioDeviceEntry& device, std::vector<AudioSessionEntry>& sessions) override;
+	std::string GetProcessPath(uint32_t processId) override;
+
+private:
+	class SessionNotification;
+	class DeviceNotification;
+
+	// Session manager of one endpoint, with the notification that reports its new sessions
+	struct SessionManager {
+		IAudioSessionManager2* pSessionManager		= nullptr;
+		SessionNotification*   pSessionNotification = nullptr;
+	};
+
+	static constexpr std::chrono::seconds PROCESS_REFRESH_INTERVAL{60};
+
+	// Function to get an endpoint's session manager, activating it on first use; nullptr on failure
+	IAudioSessionManager2*				  GetSessionManager(const std::string& deviceId);
+
+	// Function to unregister and release a session manager
+	static void							  ReleaseSessionManager(SessionManager& manager);
+
+	// Function to name a session's process, resolving (and indexing) PIDs the index has not seen yet
+	std::optional<std::string>			  GetProcessName(DWORD processId);
+
+	IMMDeviceEnumerator*							pDeviceEnumerator	= nullptr;
+	DeviceNotification*								pDeviceNotification	= nullptr;
+	std::unordered_map<std::string, SessionManager>	sessionManagers; // By endpoint ID; only used from the enumerate calls, under the base class lock
+	ProcessIndex									processIndex;
+	std::chrono::steady_clock::time_point			lastProcessRefresh;
+};
@@ -0,0 +1,78 @@
+#include "FileWatcher.h"
+#include "Log.h"
+
+#include <filesystem>
+#include <windows.h>
+
+namespace {
+	class Win32FileWatcher : public FileWatcher {
+	public:
+		Win32FileWatcher(const HANDLE hDirectory, std::wstring fileName) : hDirectory(hDirectory), fileName(std::move(fileName)) {
+			overlapped.hEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+		}
+
+		~Win32FileWatcher() override {
+			if(readPending) {
+				CancelIo(hDirectory);
+				DWORD unused = 0;
+				GetOverlappedResult(hDirectory, &overlapped, &unused, TRUE);
+			}
+			CloseHandle(overlapped.hEvent);
+			CloseHandle(hDirectory);
+		}
+
+		WaitResult WaitForChange(const int timeoutMs) override {
+			if(!readPending) {
+				ResetEvent(overlapped.hEvent);
+				if(!ReadDirectoryChangesW(hDirectory, buffer, sizeof(buffer), FALSE, FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_SIZE,
+										  nullptr, &overlapped, nullptr)) {
+					return WaitResult::Error;
+				}
+				readPending = true;
+			}
+
+			switch(WaitForSingleObject(overlapped.hEvent, static_cast<DWORD>(timeoutMs))) {
+				case WAIT_OBJECT_0: break;
+				case WAIT_TIMEOUT: return WaitResult::Timeout;
+				default: return WaitResult::Error;
+			}
+
+			readPending		= false;
+			DWORD bytesRead = 0;
+			if(!GetOverlappedResult(hDirectory, &overlapped, &bytesRead, FALSE)) { return WaitResult::Error; }
+			if(bytesRead == 0) { return WaitResult::Changed; } // Notification buffer overflowed; assume the file changed
+
+			// Other files in the directory change too; only report events for ours
+			bool changed = false;
+			for(const BYTE* p = buffer;;) {
+				const auto*		   info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(p);
+				const std::wstring name(info->FileName, info->FileNameLength / sizeof(WCHAR));
+				if(CompareStringOrdinal(name.c_str(), -1, fileName.c_str(), -1, TRUE) == CSTR_EQUAL) { changed = true; }
+				if(info->NextEntryOffset == 0) { break; }
+				p += info->NextEntryOffset;
+			}
+			return changed ? WaitResult::Changed : WaitResult::Timeout;
+		}
+
+	private:
+		HANDLE		 hDirectory;
+		std::wstring fileName;
+		OVERLAPPED	 overlapped	 = {};
+		bool		 readPending = false;
+		alignas(DWORD) BYTE buffer[4096];
+	};
+} // namespace
+
+// Function to watch a file's directory for writes and renames onto the file
+std::unique_ptr<FileWatcher> WatchFile(const std::string& path) {
+	const std::filesystem::path filePath  = std::filesystem::absolute(path);
+	const std::wstring			directory = filePath.parent_path().wstring();
+
+	HANDLE						hDirectory = CreateFileW(directory.c_str(), FILE_LIST_DIRECTORY, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr,
+														 OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+	if(hDirectory == INVALID_HANDLE_VALUE) {
+		LOG_ERROR("Error: Unable to watch config directory. Error: {}", GetLastError());
+		return nullptr;
+	}
+	return std::make_unique<Win32FileWatcher>(hDirectory, filePath.filename().wstring());
+}
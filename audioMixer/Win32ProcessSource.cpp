@@ -0,0 +1,40 @@
+#include "ProcessSource.h"
+
+#include <windows.h>
+#include <tlhelp32.h>
+
+bool EnumerateProcesses(std::vector<ProcessInfo>& processes) {
+	HANDLE hSnapshot = CreateToolhelp32Snapshot(TH32CS_SNAPPROCESS, 0);
+	if(hSnapshot == INVALID_HANDLE_VALUE) { return false; }
+
+	PROCESSENTRY32 pe32;
+	pe32.dwSize = sizeof(PROCESSENTRY32);
+	if(Process32First(hSnapshot, &pe32)) {
+		do {
+			processes.push_back({pe32.th32ProcessID, pe32.szExeFile});
+		} while(Process32Next(hSnapshot, &pe32));
+	}
+	CloseHandle(hSnapshot);
+	return true;
+}
+
+std::optional<std::string> QueryProcessPath(const uint32_t processId) {
+	HANDLE hProcess = OpenProcess(PROCESS_QUERY_LIMITED_INFORMATION, FALSE, processId);
+	if(!hProcess) { return std::nullopt; }
+
+	char	   path[MAX_PATH];
+	DWORD	   size = MAX_PATH;
+	const BOOL ok	= QueryFullProcessImageNameA(hProcess, 0, path, &size);
+	CloseHandle(hProcess);
+	if(!ok) { return std::nullopt; }
+	return std::string(path, size);
+}
+
+std::optional<std::string> QueryProcessName(const uint32_t processId) {
+	const auto fullPath = QueryProcessPath(processId);
+	if(!fullPath) { return std::nullopt; }
+
+	// Keep only the file name, to match PROCESSENTRY32::szExeFile
+	const size_t separator = fullPath->find_last_of("\\/");
+	return separator == std::string::npos ? *fullPath : fullPath->substr(separator + 1);
+}
@@ -0,0 +1,117 @@
+#include "SerialPort.h"
+#include "Log.h"
+
+#include <windows.h>
+
+namespace {
+	class Win32SerialPort : public SerialPort {
+	public:
+		explicit Win32SerialPort(const HANDLE hSerial) : hSerial(hSerial) {
+			waitEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+			readEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+
+			// Setting the low bit keeps these operations out of an I/O completion port the handle may be associated with
+			// (see IocpSerialEventLoop.cpp); they complete through their events as before
+			waitOverlapped.hEvent = reinterpret_cast<HANDLE>(reinterpret_cast<ULONG_PTR>(waitEvent) | 1);
+			readOverlapped.hEvent = reinterpret_cast<HANDLE>(reinterpret_cast<ULONG_PTR>(readEvent) | 1);
+		}
+
+		~Win32SerialPort() override {
+			if(waitPending) {
+				CancelIo(hSerial);
+				DWORD unused = 0;
+				GetOverlappedResult(hSerial, &waitOverlapped, &unused, TRUE);
+			}
+			CloseHandle(waitEvent);
+			CloseHandle(readEvent);
+			CloseHandle(hSerial);
+		}
+
+		WaitResult WaitForData(const int timeoutMs) override {
+			// Bytes that arrived while we were busy do not raise another EV_RXCHAR
+			DWORD	errors	= 0;
+			COMSTAT comStat = {};
+			if(!ClearCommError(hSerial, &errors, &comStat)) { return WaitResult::Error; }
+			if(comStat.cbInQue > 0) { return WaitResult::Data; }
+
+			if(!waitPending) {
+				ResetEvent(waitEvent);
+				if(WaitCommEvent(hSerial, &eventMask, &waitOverlapped)) { return WaitResult::Data; }
+				if(GetLastError() != ERROR_IO_PENDING) { return WaitResult::Error; }
+				waitPending = true;
+			}
+
+			switch(WaitForSingleObject(waitEvent, static_cast<DWORD>(timeoutMs))) {
+				case WAIT_OBJECT_0: {
+					waitPending	 = false;
+					DWORD unused = 0;
+					return GetOverlappedResult(hSerial, &waitOverlapped, &unused, FALSE) ? WaitResult::Data : WaitResult::Error;
+				}
+				case WAIT_TIMEOUT: return WaitResult::Timeout;
+				default: return WaitResult::Error;
+			}
+		}
+
+		int ReadAvailable(uint8_t* buffer, const size_t size) override {
+			// The port timeouts make ReadFile return immediately with whatever is buffered
+			DWORD bytesRead = 0;
+			ResetEvent(readEvent);
+			if(!ReadFile(hSerial, buffer, static_cast<DWORD>(size), &bytesRead, &readOverlapped)) {
+				if(GetLastError() != ERROR_IO_PENDING) { return -1; }
+				if(!GetOverlappedResult(hSerial, &readOverlapped, &bytesRead, TRUE)) { return -1; }
+			}
+			return static_cast<int>(bytesRead);
+		}
+
+		std::optional<NativeHandle> GetNativeHandle() const override { return hSerial; }
+
+	private:
+		HANDLE	   hSerial;
+		HANDLE	   waitEvent	  = nullptr;
+		HANDLE	   readEvent	  = nullptr;
+		OVERLAPPED waitOverlapped = {};
+		OVERLAPPED readOverlapped = {};
+		DWORD	   eventMask	  = 0;
+		bool	   waitPending	  = false;
+	};
+} // namespace
+
+// Function to open a COM port for overlapped I/O
+std::unique_ptr<SerialPort> OpenSerialPort(const std::string& portName, const int baudRate) {
+	HANDLE hSerial = CreateFile(portName.c_str(), GENERIC_READ | GENERIC_WRITE, 0, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_OVERLAPPED, nullptr);
+	if(hSerial == INVALID_HANDLE_VALUE) {
+		LOG_ERROR("Error: Unable to open COM port.");
+		return nullptr;
+	}
+
+	// Set the serial port parameters
+	DCB dcbSerialParams		  = {0};
+	dcbSerialParams.DCBlength = sizeof(dcbSerialParams);
+
+	if(!GetCommState(hSerial, &dcbSerialParams)) {
+		LOG_ERROR("Error: Unable to get serial port state.");
+		CloseHandle(hSerial);
+		return nullptr;
+	}
+
+	dcbSerialParams.BaudRate = static_cast<DWORD>(baudRate);
+	dcbSerialParams.ByteSize = 8;
+	dcbSerialParams.StopBits = ONESTOPBIT;
+	dcbSerialParams.Parity	 = NOPARITY;
+
+	if(!SetCommState(hSerial, &dcbSerialParams)) {
+		LOG_ERROR("Error: Unable to set serial port parameters.");
+		CloseHandle(hSerial);
+		return nullptr;
+	}
+
+	// Return immediately with whatever is buffered; waiting is done with WaitCommEvent
+	COMMTIMEOUTS timeouts				= {0};
+	timeouts.ReadIntervalTimeout		= MAXDWORD;
+	timeouts.ReadTotalTimeoutConstant	= 0;
+	timeouts.ReadTotalTimeoutMultiplier = 0;
+	SetCommTimeouts(hSerial, &timeouts);
+	SetCommMask(hSerial, EV_RXCHAR);
+
+	return std::make_unique<Win32SerialPort>(hSerial);
+}
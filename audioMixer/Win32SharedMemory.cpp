@@ -0,0 +1,64 @@
+#include "SharedMemory.h"
+#include "Log.h"
+
+#include <windows.h>
+
+namespace {
+	class Win32SharedMemory : public SharedMemory {
+	public:
+		Win32SharedMemory(const HANDLE mapping, void* data, const size_t size) : mapping(mapping), data(data), size(size) {}
+
+		// The name goes away with the last handle to the mapping
+		~Win32SharedMemory() override {
+			UnmapViewOfFile(data);
+			CloseHandle(mapping);
+		}
+
+		void*  Data() override { return data; }
+
+		size_t Size() const override { return size; }
+
+	private:
+		HANDLE mapping;
+		void*  data;
+		size_t size;
+	};
+} // namespace
+
+// Function to create a pagefile-backed mapping; names under Local\ are only visible in the current session
+std::unique_ptr<SharedMemory> CreateSharedMemory(const std::string& name, const size_t size) {
+	const HANDLE mapping = CreateFileMapping(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, static_cast<DWORD>(static_cast<uint64_t>(size) >> 32),
+											 static_cast<DWORD>(size), name.c_str());
+	if(mapping == nullptr) {
+		LOG_ERROR("Error: Unable to create shared memory {}. Error: {}", name, GetLastError());
+		return nullptr;
+	}
+	if(GetLastError() == ERROR_ALREADY_EXISTS) {
+		LOG_ERROR("Error: Shared memory {} is already in use.", name);
+		CloseHandle(mapping);
+		return nullptr;
+	}
+
+	void* data = MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+	if(data == nullptr) {
+		LOG_ERROR("Error: Unable to map shared memory {}. Error: {}", name, GetLastError());
+		CloseHandle(mapping);
+		return nullptr;
+	}
+	return std::make_unique<Win32SharedMemory>(mapping, data, size);
+}
+
+// Function to map an existing mapping read-only
+std::unique_ptr<SharedMemory> OpenSharedMemory(const std::string& name, const size_t size) {
+	const HANDLE mapping = OpenFileMapping(FILE_MAP_READ, FALSE, name.c_str());
+	if(mapping == nullptr) { return nullptr; }
+
+	void*					 data = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	MEMORY_BASIC_INFORMATION info = {};
+	if(data == nullptr || VirtualQuery(data, &info, sizeof(info)) == 0 || info.RegionSize < size) {
+		if(data) { UnmapViewOfFile(data); }
+		CloseHandle(mapping);
+		return nullptr;
+	}
+	return std::make_unique<Win32SharedMemory>(mapping, data, size);
+}
@@ -0,0 +1,516 @@
+#include "ApplicationMatcher.h"
+#include "Benchmark.h"
+#include "LatencyHistogram.h"
+#include "MixerController.h"
+#include "MockAudioBackend.h"
+#include "MpscQueue.h"
+#include "VolumeScheduler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+	constexpr size_t SESSION_COUNT = 64;
+
+	// Function to fill the mock with SESSION_COUNT sessions spread over a few applications
+	void AddSessions(MockAudioBackend& backend) {
+		for(size_t i = 0; i < SESSION_COUNT; ++i) {
+			backend.AddSession("app" + std::to_string(i % 16) + ".exe", 0.5f);
+		}
+	}
+
+	// Volume change with the session handles cached between calls
+	BENCHMARK("AudioBackend/set_volume_cached", [](BenchmarkRun& run) {
+		run.StopTimer();
+		MockAudioBackend backend;
+		AddSessions(backend);
+		backend.SetVolume({"", "app0.exe"}, 0.5f);
+		const VolumeTarget target{"", "App3.exe"};
+		const uint64_t	   enumerations = backend.EnumerationCount();
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			DoNotOptimize(backend.SetVolume(target, static_cast<float>(i % 100) / 100.0f));
+		}
+
+		run.StopTimer();
+		run.AddMetric("enumerations", static_cast<double>(backend.EnumerationCount() - enumerations));
+	});
+
+	// The same change when every call has to enumerate the sessions again, as before the cache
+	BENCHMARK("AudioBackend/set_volume_uncached", [](BenchmarkRun& run) {
+		run.StopTimer();
+		MockAudioBackend backend;
+		AddSessions(backend);
+		const VolumeTarget target{"", "App3.exe"};
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			backend.InvalidateSessions();
+			DoNotOptimize(backend.SetVolume(target, static_cast<float>(i % 100) / 100.0f));
+		}
+
+		run.StopTimer();
+		run.AddMetric("enumerations", static_cast<double>(backend.EnumerationCount()));
+	});
+
+	// Applications one frame changes: two pots moved, one of them bound to two applications
+	const VolumeTarget FRAME_TARGETS[] = {{"", "App3.exe"}, {"", "app4.exe"}, {"", "APP9.exe"}};
+
+	// Volumes of one frame applied with one call per application, as the worker did before batching
+	BENCHMARK("AudioBackend/frame_per_application", [](BenchmarkRun& run) {
+		run.StopTimer();
+		MockAudioBackend backend;
+		AddSessions(backend);
+		backend.SetVolume({"", "app0.exe"}, 0.5f);
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			for(const VolumeTarget& target : FRAME_TARGETS) {
+				DoNotOptimize(backend.SetVolume(target, static_cast<float>(i % 100) / 100.0f));
+			}
+		}
+
+		run.StopTimer();
+		run.AddMetric("session_calls_per_frame", static_cast<double>(backend.SetVolumeCount() - SESSION_COUNT / 16) / run.Iterations());
+	});
+
+	// The same frame as one batch: one lock and one cache check for all three applications
+	BENCHMARK("AudioBackend/frame_batch", [](BenchmarkRun& run) {
+		run.StopTimer();
+		MockAudioBackend backend;
+		AddSessions(backend);
+		backend.SetVolume({"", "app0.exe"}, 0.5f);
+		TargetVolume updates[std::size(FRAME_TARGETS)];
+		for(size_t i = 0; i < std::size(FRAME_TARGETS); ++i) {
+			updates[i].target = &FRAME_TARGETS[i];
+		}
+		size_t applied = 0;
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			for(TargetVolume& update : updates) {
+				update.volume = static_cast<float>(i % 100) / 100.0f;
+			}
+			applied += backend.SetVolumes(updates);
+		}
+
+		run.StopTimer();
+		run.AddMetric("session_calls_per_frame", static_cast<double>(backend.SetVolumeCount() - SESSION_COUNT / 16) / run.Iterations());
+		run.AddMetric("applied_per_frame", static_cast<double>(applied) / run.Iterations());
+	});
+
+	// A batch where the first target's session expired without the notification: the failure marks the device stale, but
+	// the second target still uses the sessions the batch started with, and the device is enumerated once, for the next batch
+	BENCHMARK("AudioBackend/session_fails_mid_batch", [](BenchmarkRun& run) {
+		run.StopTimer();
+		MockAudioBackend backend;
+		AddSessions(backend);
+		const VolumeTarget targets[] = {{"", "gone.exe"}, {"", "app1.exe"}};
+		TargetVolume	   updates[]			 = {{&targets[0], 0.5f}, {&targets[1], 0.5f}};
+		uint64_t		   midBatchEnumerations	 = 0;
+		uint64_t		   nextBatchEnumerations = 0;
+		size_t			   applied				 = 0;
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			const uint32_t processId = backend.AddSession("gone.exe", 0.5f);
+			backend.SetVolumes(updates);
+			backend.ExpireSession(processId, false);
+
+			run.StartTimer();
+			const uint64_t enumerations = backend.EnumerationCount();
+			applied += backend.SetVolumes(updates);
+			midBatchEnumerations += backend.EnumerationCount() - enumerations;
+			run.StopTimer();
+
+			const uint64_t nextEnumerations = backend.EnumerationCount();
+			backend.SetVolumes(updates);
+			nextBatchEnumerations += backend.EnumerationCount() - nextEnumerations;
+		}
+
+		run.Check(midBatchEnumerations == 0, "a session failing in a batch does not enumerate its device halfway through the batch");
+		run.Check(nextBatchEnumerations == run.Iterations(), "the device is enumerated once, for the next batch");
+		run.Check(applied == run.Iterations(), "the other target in the batch is still applied");
+		run.AddMetric("mid_batch_enumerations", static_cast<double>(midBatchEnumerations) / run.Iterations());
+		run.AddMetric("next_batch_enumerations", static_cast<double>(nextBatchEnumerations) / run.Iterations());
+	});
+
+	// Targets spread over three devices: applications on the default output and on a headset (by ID), the default
+	// output's master volume and a microphone's gain (by friendly name)
+	const VolumeTarget DEVICE_TARGETS[] = {{"", "app1.exe"}, {"headset", "app2.exe"}, {"", ""}, {"usb microphone", ""}};
+
+	// Function to plug in a headset with sessions of its own and a microphone
+	void AddDevices(MockAudioBackend& backend) {
+		backend.AddDevice("headset", "Headset (Mock Audio)");
+		backend.AddDevice("mic", "USB Microphone", AudioDeviceFlow::Capture, 0.8f);
+		for(size_t i = 0; i < SESSION_COUNT / 4; ++i) {
+			backend.AddSession("app" + std::to_string(i % 4) + ".exe", 0.5f, "headset");
+		}
+	}
+
+	// Function to apply one frame's volumes to DEVICE_TARGETS; returns how many were applied
+	size_t ApplyDeviceFrame(MockAudioBackend& backend, const uint64_t frame) {
+		TargetVolume updates[std::size(DEVICE_TARGETS)];
+		for(size_t i = 0; i < std::size(DEVICE_TARGETS); ++i) {
+			updates[i] = {&DEVICE_TARGETS[i], static_cast<float>((frame + i) % 100) / 100.0f};
+		}
+		return backend.SetVolumes(updates);
+	}
+
+	// A frame touching every kind of target: after the first frame neither devices nor sessions are enumerated again
+	BENCHMARK("AudioBackend/multi_device_frame", [](BenchmarkRun& run) {
+		run.StopTimer();
+		MockAudioBackend backend;
+		AddSessions(backend);
+		AddDevices(backend);
+		ApplyDeviceFrame(backend, 0);
+		const uint64_t deviceEnumerations = backend.DeviceEnumerationCount();
+		const uint64_t enumerations		  = backend.EnumerationCount();
+		size_t		   applied			  = 0;
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			applied += ApplyDeviceFrame(backend, i);
+		}
+
+		run.StopTimer();
+		run.AddMetric("applied_per_frame", static_cast<double>(applied) / run.Iterations());
+		run.AddMetric("device_enumerations", static_cast<double>(backend.DeviceEnumerationCount() - deviceEnumerations));
+		run.AddMetric("session_enumerations", static_cast<double>(backend.EnumerationCount() - enumerations));
+	});
+
+	// The same frames while the headset is unplugged for one frame in every 256: the device list is enumerated once per
+	// notification, the headset's targets fail while it is gone and work again once it is back
+	BENCHMARK("AudioBackend/multi_device_hotplug", [](BenchmarkRun& run) {
+		run.StopTimer();
+		MockAudioBackend backend;
+		AddSessions(backend);
+		AddDevices(backend);
+		ApplyDeviceFrame(backend, 0);
+		const uint64_t deviceEnumerations = backend.DeviceEnumerationCount();
+		size_t		   applied			  = 0;
+		uint64_t	   unplugs			  = 0;
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			if(i % 256 == 1) {
+				backend.RemoveDevice("headset");
+				++unplugs;
+			} else if(i % 256 == 2) {
+				AddDevices(backend);
+			}
+			applied += ApplyDeviceFrame(backend, i);
+		}
+
+		run.StopTimer();
+		run.AddMetric("applied_per_frame", static_cast<double>(applied) / run.Iterations());
+		run.AddMetric("device_enumerations_per_unplug", unplugs ? static_cast<double>(backend.DeviceEnumerationCount() - deviceEnumerations) / unplugs : 0.0);
+	});
+
+	constexpr size_t PATTERN_SESSION_COUNT = 300;
+
+	// Targets a config with hundreds of patterns could have: a path glob, an exact title, a name glob and a regex
+	const VolumeTarget PATTERN_TARGETS[] = {{"", "path:C:\\Program Files\\Vendor3\\*"}, {"", "title:Game 7"}, {"", "app1*.exe"}, {"", "/^svc(host)?\\.exe$/"}};
+
+	// Function to give the mock PATTERN_SESSION_COUNT sessions with paths and titles, and a matcher with as many patterns;
+	// returns the first session's process id
+	uint32_t AddPatternSessions(MockAudioBackend& backend) {
+		auto		matcher = std::make_shared<ApplicationMatcher>();
+		std::string error;
+		for(const VolumeTarget& target : PATTERN_TARGETS) {
+			matcher->AddPattern(target.applicationName, error);
+		}
+		for(size_t i = 0; matcher->PatternCount() < PATTERN_SESSION_COUNT; ++i) {
+			const std::string n = std::to_string(i);
+			matcher->AddPattern(i % 2 ? "path:C:\\Program Files\\Vendor" + n + "\\*" : "title:Voice*" + n, error);
+		}
+		matcher->Build();
+		backend.SetApplicationMatcher(std::move(matcher));
+
+		uint32_t firstProcessId = 0;
+		for(size_t i = 0; i < PATTERN_SESSION_COUNT; ++i) {
+			const std::string n			= std::to_string(i);
+			const uint32_t	  processId = backend.AddSession(i % 10 ? "app" + n + ".exe" : "svchost.exe", 0.5f);
+			backend.SetSessionDetails(processId, "C:\\Program Files\\Vendor" + std::to_string(i % 50) + "\\app.exe", "Game " + std::to_string(i % 20));
+			if(i == 0) { firstProcessId = processId; }
+		}
+		return firstProcessId;
+	}
+
+	// Function to apply one frame's volumes to PATTERN_TARGETS; returns how many were applied
+	size_t ApplyPatternFrame(MockAudioBackend& backend, const uint64_t frame) {
+		TargetVolume updates[std::size(PATTERN_TARGETS)];
+		for(size_t i = 0; i < std::size(PATTERN_TARGETS); ++i) {
+			updates[i] = {&PATTERN_TARGETS[i], static_cast<float>((frame + i) % 100) / 100.0f};
+		}
+		return backend.SetVolumes(updates);
+	}
+
+	// Pattern targets cost the same per frame as plain names: the patterns ran when the sessions were enumerated
+	BENCHMARK("AudioBackend/pattern_targets_frame", [](BenchmarkRun& run) {
+		run.StopTimer();
+		MockAudioBackend backend;
+		AddPatternSessions(backend);
+		ApplyPatternFrame(backend, 0);
+		const uint64_t matches = backend.MatchCount();
+		size_t		   applied = 0;
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			applied += ApplyPatternFrame(backend, i);
+		}
+
+		run.StopTimer();
+		run.AddMetric("applied_per_frame", static_cast<double>(applied) / run.Iterations());
+		run.AddMetric("pattern_matches", static_cast<double>(backend.MatchCount() - matches));
+	});
+
+	// One session replaced before every frame: only the new session is matched, the others keep their cached result
+	BENCHMARK("AudioBackend/pattern_session_churn", [](BenchmarkRun& run) {
+		run.StopTimer();
+		MockAudioBackend backend;
+		uint32_t		 oldest = AddPatternSessions(backend);
+		ApplyPatternFrame(backend, 0);
+		const uint64_t matches = backend.MatchCount();
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			backend.ExpireSession(oldest++);
+			const uint32_t processId = backend.AddSession("app" + std::to_string(i % 100) + ".exe", 0.5f);
+			backend.SetSessionDetails(processId, "C:\\Program Files\\Vendor3\\new.exe", "Game 7");
+			ApplyPatternFrame(backend, i);
+		}
+
+		run.StopTimer();
+		run.AddMetric("matches_per_new_session", static_cast<double>(backend.MatchCount() - matches) / run.Iterations());
+	});
+
+	// A pot sweep and a held hotkey on 8 applications, one command per simulated millisecond, applied at most every 16ms
+	BENCHMARK("VolumeScheduler/coalesce_8_apps", [](BenchmarkRun& run) {
+		run.StopTimer();
+		VolumeScheduler			   scheduler(std::chrono::milliseconds(16));
+		VolumeScheduler::TimePoint now;
+		uint64_t				   applied = 0;
+		const auto				   apply   = [&](const VolumeCommand&) { ++applied; };
+		scheduler.Reset(8);
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			const bool			hotkey = i % 4 == 0;
+			const VolumeCommand command{.type			  = hotkey ? VolumeCommand::Type::Adjust : VolumeCommand::Type::Set,
+										.applicationIndex = static_cast<uint16_t>(i % 8),
+										.value			  = hotkey ? 0.1f : static_cast<float>(i % 100) / 100.0f};
+			scheduler.Submit(command);
+			now += std::chrono::milliseconds(1);
+			scheduler.ApplyDue(now, apply);
+		}
+		scheduler.Flush(apply);
+
+		run.StopTimer();
+		run.AddMetric("commands_per_backend_call", static_cast<double>(run.Iterations()) / static_cast<double>(applied));
+	});
+
+	// Function to wait up to a second for the worker to get somewhere; false if it did not
+	bool WaitUntil(const std::function<bool()>& done) {
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+		while(!done()) {
+			if(std::chrono::steady_clock::now() > deadline) { return false; }
+			std::this_thread::sleep_for(std::chrono::microseconds(100));
+		}
+		return true;
+	}
+
+	// A config reload while an update is held back by the rate limit: the new config's application at the same index
+	// must not get it
+	BENCHMARK(
+		"AudioWorker/reload_drops_pending_updates",
+		[](BenchmarkRun& run) {
+			run.StopTimer();
+			MockAudioBackend backend;
+			uint64_t		 staleApplied = 0;
+			run.StartTimer();
+
+			for(uint64_t i = 0; i < run.Iterations(); ++i) {
+				std::atomic<uint64_t>	   generation = 1;
+				std::vector<float>		   appliedValues;
+				const auto				   apply	  = [&appliedValues](const std::span<const VolumeCommand> commands) {
+					 for(const VolumeCommand& command : commands) {
+						 appliedValues.push_back(command.value);
+					 }
+				};
+				const auto				   liveConfig = [&generation] { return AudioWorker::ConfigInfo{generation.load(), 2}; };
+				AudioWorker				   worker(backend, apply, liveConfig, std::chrono::seconds(10));
+				worker.Start();
+				worker.Submit({.type = VolumeCommand::Type::Set, .applicationIndex = 0, .value = 0.2f});
+				WaitUntil([&worker] { return worker.SchedulerStats().applied == 1; });
+				worker.Submit({.type = VolumeCommand::Type::Set, .applicationIndex = 0, .value = 0.7f}); // Held back for 10s
+				WaitUntil([&worker] { return worker.SchedulerStats().setReceived == 2; });
+
+				generation = 2;
+				worker.Submit({.type = VolumeCommand::Type::Set, .applicationIndex = 1, .value = 0.5f});
+				worker.Stop();
+				staleApplied += std::ranges::count(appliedValues, 0.7f);
+			}
+
+			run.StopTimer();
+			run.Check(staleApplied == 0, "an update pending when the config is reloaded is dropped");
+		},
+		20);
+
+	// Several threads enqueueing at once, as the keyboard hook and serial thread do; the consumer drains concurrently
+	BENCHMARK("MpscQueue/4_producers", [](BenchmarkRun& run) {
+		run.StopTimer();
+		constexpr size_t	  PRODUCER_COUNT = 4;
+		auto				  queue			 = std::make_unique<MpscQueue<VolumeCommand, 1024>>();
+		LatencyHistogram	  enqueueLatency;
+		std::atomic<bool>	  start			 = false;
+		std::atomic<uint64_t> fullCount		 = 0;
+		const uint64_t		  perProducer	 = (run.Iterations() + PRODUCER_COUNT - 1) / PRODUCER_COUNT;
+
+		std::vector<std::thread> producers;
+		for(size_t p = 0; p < PRODUCER_COUNT; ++p) {
+			producers.emplace_back([&, p] {
+				while(!start) {
+					std::this_thread::yield();
+				}
+				const VolumeCommand command{.type = VolumeCommand::Type::Set, .applicationIndex = static_cast<uint16_t>(p), .value = 0.5f};
+				for(uint64_t i = 0; i < perProducer; ++i) {
+					const auto started = std::chrono::steady_clock::now();
+					while(!queue->TryPush(command)) {
+						fullCount.fetch_add(1, std::memory_order_relaxed);
+						std::this_thread::yield(); // Let the consumer run on machines with fewer cores than threads
+					}
+					enqueueLatency.Record(std::chrono::steady_clock::now() - started);
+				}
+			});
+		}
+
+		run.StartTimer();
+		start = true;
+		VolumeCommand command;
+		uint64_t	  popped = 0;
+		while(popped < perProducer * PRODUCER_COUNT) {
+			if(queue->TryPop(command)) {
+				++popped;
+			} else {
+				std::this_thread::yield();
+			}
+		}
+		run.StopTimer();
+
+		for(std::thread& producer : producers) {
+			producer.join();
+		}
+		run.AddMetric("enqueue_p50_ns", static_cast<double>(enqueueLatency.Percentile(50).count()));
+		run.AddMetric("enqueue_p99_ns", static_cast<double>(enqueueLatency.Percentile(99).count()));
+		run.AddMetric("enqueue_max_ns", static_cast<double>(enqueueLatency.Max().count()));
+		run.AddMetric("queue_full_retries", static_cast<double>(fullCount));
+	});
+
+	// Function to build the config of the controller benchmarks: 8 applications, one pot each, two hotkeys each
+	std::unique_ptr<MixerConfig> MakeConfig() {
+		auto config						  = std::make_unique<MixerConfig>();
+		config->maxVolumeUpdatesPerSecond = 1000000; // Measure the path, not the rate limit
+		for(int i = 0; i < 8; ++i) {
+			ApplicationConfig app;
+			app.applicationName		   = "app" + std::to_string(i) + ".exe";
+			app.target.applicationName = app.applicationName;
+			app.potNumber			   = i;
+			ParseKeyCombination("Ctrl+Alt+F" + std::to_string(i + 1), app.volumeUpKeyCombination);
+			ParseKeyCombination("Ctrl+Shift+F" + std::to_string(i + 1), app.volumeDownKeyCombination);
+			config->applications.push_back(app);
+		}
+		CompileConfig(*config);
+		return config;
+	}
+
+	// Serial thread side of a pot move: route a delta frame and queue the volume change, then the worker applies it
+	BENCHMARK("MixerController/pot_frame_to_mock_backend", [](BenchmarkRun& run) {
+		run.StopTimer();
+		MockAudioBackend backend;
+		AddSessions(backend);
+		MixerController mixer(backend);
+		mixer.PublishConfig(MakeConfig());
+		mixer.Start();
+		run.StartTimer();
+
+		ChannelValue update;
+		MixerFrame	 frame;
+		frame.type = MIXER_FRAME_DELTA;
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			update.channel	 = static_cast<uint8_t>(i % 8);
+			update.value	 = static_cast<uint16_t>(i % (MIXER_VALUE_MAX + 1));
+			frame.sequence	 = static_cast<uint8_t>(i);
+			frame.receivedAt = frame.parsedAt = std::chrono::steady_clock::now();
+			frame.updates	 = std::span<const ChannelValue>(&update, 1);
+			mixer.ApplyPotFrame(frame);
+		}
+		mixer.Stop(); // Includes applying whatever is still queued
+
+		run.StopTimer();
+		run.AddMetric("received_to_applied_p50_ns", static_cast<double>(mixer.Latency().receivedToApplied.Percentile(50).count()));
+		run.AddMetric("received_to_applied_p99_ns", static_cast<double>(mixer.Latency().receivedToApplied.Percentile(99).count()));
+		run.AddMetric("backend_calls", static_cast<double>(backend.SetVolumeCount()));
+	});
+
+	// Every pot of the board moving at once: the frame's 8 volume changes reach the backend as batches, not one call each
+	BENCHMARK("MixerController/all_pots_frame_to_mock_backend", [](BenchmarkRun& run) {
+		run.StopTimer();
+		MockAudioBackend backend;
+		AddSessions(backend);
+		MixerController mixer(backend);
+		mixer.PublishConfig(MakeConfig());
+		mixer.Start();
+		run.StartTimer();
+
+		ChannelValue updates[8];
+		MixerFrame	 frame;
+		frame.type = MIXER_FRAME_DELTA;
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			for(uint8_t channel = 0; channel < 8; ++channel) {
+				updates[channel] = {channel, static_cast<uint16_t>((i + channel) % (MIXER_VALUE_MAX + 1))};
+			}
+			frame.sequence	 = static_cast<uint8_t>(i);
+			frame.receivedAt = frame.parsedAt = std::chrono::steady_clock::now();
+			frame.updates	 = updates;
+			mixer.ApplyPotFrame(frame);
+		}
+		mixer.Stop();
+
+		run.StopTimer();
+		run.AddMetric("received_to_applied_p50_ns", static_cast<double>(mixer.Latency().receivedToApplied.Percentile(50).count()));
+		run.AddMetric("backend_batches", static_cast<double>(backend.BatchCount()));
+		// Every application has SESSION_COUNT / 16 sessions in the mock
+		const double applicationsApplied = static_cast<double>(backend.SetVolumeCount()) / (SESSION_COUNT / 16);
+		run.AddMetric("applications_per_batch", backend.BatchCount() ? applicationsApplied / backend.BatchCount() : 0.0);
+	});
+
+	// Keyboard hook side of a hotkey: Ctrl held, then alternately Alt+F-key (volume up) and Shift+F-key (volume down)
+	BENCHMARK("MixerController/hotkey_to_mock_backend", [](BenchmarkRun& run) {
+		run.StopTimer();
+		MockAudioBackend backend;
+		AddSessions(backend);
+		MixerController mixer(backend);
+		mixer.PublishConfig(MakeConfig());
+		mixer.Start();
+		mixer.KeyDown(VirtualKey::LControl);
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			const uint32_t modifier = i % 2 ? VirtualKey::LShift : VirtualKey::LMenu;
+			const uint32_t vkCode	= 0x70 + static_cast<uint32_t>(i / 2 % 8); // F1-F8
+			mixer.KeyDown(modifier);
+			mixer.KeyDown(vkCode);
+			mixer.KeyUp(vkCode);
+			mixer.KeyUp(modifier);
+		}
+		mixer.Stop();
+
+		run.StopTimer();
+		run.AddMetric("backend_calls", static_cast<double>(backend.SetVolumeCount()));
+	});
+} // namespace
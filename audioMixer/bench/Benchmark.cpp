@@ -0,0 +1,203 @@
+#include "Benchmark.h"
+#include "Log.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <streambuf>
+
+namespace {
+	struct RegisteredBenchmark {
+		std::string		  name;
+		BenchmarkFunction function;
+		uint64_t		  fixedIterations = 0;
+	};
+
+	struct BenchmarkResult {
+		std::string									name;
+		uint64_t									iterations = 0;
+		double										nsPerOp	   = 0.0;
+		std::vector<std::pair<std::string, double>> metrics;
+		std::vector<std::string>					failures; // Failed checks of every run, calibration included
+	};
+
+	constexpr int REPETITIONS = 5;
+
+	std::vector<RegisteredBenchmark>& Registry() {
+		static std::vector<RegisteredBenchmark> registry;
+		return registry;
+	}
+
+	// Swallows everything written to it, so the logging in the code under test does not end up in the measurements.
+	// Progress is reported on std::clog, which keeps writing to stderr while std::cerr is redirected.
+	class NullBuffer : public std::streambuf {
+	protected:
+		int				overflow(const int c) override { return traits_type::not_eof(c); }
+		std::streamsize xsputn(const char*, const std::streamsize count) override { return count; }
+	};
+
+	// Function to run a benchmark once with the given iteration count
+	BenchmarkRun RunOnce(const RegisteredBenchmark& benchmark, const uint64_t iterations) {
+		static NullBuffer nullBuffer;
+		std::streambuf*	  coutBuffer = std::cout.rdbuf(&nullBuffer);
+		std::streambuf*	  cerrBuffer = std::cerr.rdbuf(&nullBuffer);
+
+		BenchmarkRun run(iterations);
+		run.StartTimer();
+		benchmark.function(run);
+		run.StopTimer();
+
+		std::cout.rdbuf(coutBuffer);
+		std::cerr.rdbuf(cerrBuffer);
+		return run;
+	}
+
+	// Function to keep the failed checks of a run, once each
+	void AddFailures(const BenchmarkRun& run, std::vector<std::string>& failures) {
+		for(const std::string& failure : run.Failures()) {
+			if(std::find(failures.begin(), failures.end(), failure) == failures.end()) { failures.push_back(failure); }
+		}
+	}
+
+	// Function to run a benchmark once with a single iteration, for its checks alone
+	BenchmarkResult Check(const RegisteredBenchmark& benchmark) {
+		const BenchmarkRun run = RunOnce(benchmark, 1);
+		return {benchmark.name, 1, static_cast<double>(run.Elapsed().count()), run.Metrics(), run.Failures()};
+	}
+
+	// Function to measure a benchmark: calibrate the iteration count, then report the median of REPETITIONS runs
+	BenchmarkResult Measure(const RegisteredBenchmark& benchmark, const std::chrono::nanoseconds minTime) {
+		std::vector<std::string> failures;
+		uint64_t				 iterations = benchmark.fixedIterations > 0 ? benchmark.fixedIterations : 1;
+		if(benchmark.fixedIterations == 0) {
+			while(true) {
+				const BenchmarkRun run = RunOnce(benchmark, iterations);
+				AddFailures(run, failures);
+				if(run.Elapsed() >= minTime || iterations >= (uint64_t{1} << 40)) { break; }
+
+				// Aim a little past the minimum so the next run is usually the last, but grow at most 10x per step
+				const double scale = run.Elapsed().count() > 0 ? 1.4 * static_cast<double>(minTime.count()) / static_cast<double>(run.Elapsed().count()) : 10.0;
+				iterations		   = std::max(iterations + 1, static_cast<uint64_t>(static_cast<double>(iterations) * std::min(scale, 10.0)));
+			}
+		}
+
+		std::vector<double> nsPerOp;
+		BenchmarkRun		lastRun(iterations);
+		for(int i = 0; i < REPETITIONS; ++i) {
+			lastRun = RunOnce(benchmark, iterations);
+			AddFailures(lastRun, failures);
+			nsPerOp.push_back(static_cast<double>(lastRun.Elapsed().count()) / static_cast<double>(iterations));
+		}
+		std::sort(nsPerOp.begin(), nsPerOp.end());
+
+		return {benchmark.name, iterations, nsPerOp[nsPerOp.size() / 2], lastRun.Metrics(), std::move(failures)};
+	}
+
+	std::string JsonString(const std::string& value) {
+		std::string escaped = "\"";
+		for(const char c : value) {
+			if(c == '"' || c == '\\') { escaped += '\\'; }
+			escaped += c;
+		}
+		return escaped + "\"";
+	}
+
+	// Function to write the results as {"benchmarks":[{...}, ...]}
+	void WriteJson(std::ostream& out, const std::vector<BenchmarkResult>& results) {
+		out << std::setprecision(6) << "{\"benchmarks\":[";
+		for(size_t i = 0; i < results.size(); ++i) {
+			const BenchmarkResult& result = results[i];
+			out << (i > 0 ? ",\n" : "\n") << "{\"name\":" << JsonString(result.name) << ",\"iterations\":" << result.iterations
+				<< ",\"ns_per_op\":" << result.nsPerOp << ",\"ops_per_second\":" << (result.nsPerOp > 0 ? 1e9 / result.nsPerOp : 0.0) << ",\"metrics\":{";
+			for(size_t m = 0; m < result.metrics.size(); ++m) {
+				out << (m > 0 ? "," : "") << JsonString(result.metrics[m].first) << ":" << result.metrics[m].second;
+			}
+			out << "}}";
+		}
+		out << "\n]}\n";
+	}
+
+	void PrintUsage() {
+		std::cerr << "Usage: audioMixerBench [--filter <substring>] [--min-time-ms <ms>] [--json <file>] [--check]" << std::endl;
+	}
+} // namespace
+
+void BenchmarkRun::StartTimer() {
+	if(timing) { return; }
+	timing	= true;
+	started = Clock::now();
+}
+
+void BenchmarkRun::StopTimer() {
+	if(!timing) { return; }
+	elapsed += Clock::now() - started;
+	timing = false;
+}
+
+BenchmarkRegistration::BenchmarkRegistration(const char* name, BenchmarkFunction function, const uint64_t fixedIterations) {
+	Registry().push_back({name, std::move(function), fixedIterations});
+}
+
+int RunBenchmarks(const int argc, char** argv) {
+	std::string				 filter;
+	std::string				 jsonPath;
+	std::chrono::nanoseconds minTime   = std::chrono::milliseconds(100);
+	bool					 checkOnly = false;
+	for(int i = 1; i < argc; ++i) {
+		if(std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+			filter = argv[++i];
+		} else if(std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+			jsonPath = argv[++i];
+		} else if(std::strcmp(argv[i], "--min-time-ms") == 0 && i + 1 < argc) {
+			minTime = std::chrono::milliseconds(std::atoi(argv[++i]));
+		} else if(std::strcmp(argv[i], "--check") == 0) {
+			checkOnly = true;
+		} else {
+			PrintUsage();
+			return 2;
+		}
+	}
+
+	// The code under test logs as it would in the app, but the records are drained without being written anywhere
+	Log::Start(BenchmarkLogOptions());
+
+	std::vector<BenchmarkResult> results;
+	size_t						 failed = 0;
+	for(const RegisteredBenchmark& benchmark : Registry()) {
+		if(!filter.empty() && benchmark.name.find(filter) == std::string::npos) { continue; }
+
+		const BenchmarkResult result = checkOnly ? Check(benchmark) : Measure(benchmark, minTime);
+		for(const std::string& failure : result.failures) {
+			std::clog << "FAILED " << result.name << ": " << failure << std::endl;
+		}
+		if(!result.failures.empty()) { ++failed; }
+		if(checkOnly) { continue; }
+
+		std::clog << std::left << std::setw(56) << result.name << std::right << std::setw(14) << std::fixed << std::setprecision(1) << result.nsPerOp
+				  << " ns/op" << std::setw(14) << result.iterations << " iterations";
+		for(const auto& [metric, value] : result.metrics) {
+			std::clog << "  " << metric << "=" << value;
+		}
+		std::clog << std::endl;
+		results.push_back(result);
+	}
+	if(checkOnly) {
+		std::clog << (failed ? std::to_string(failed) + " benchmark(s) failed their checks." : "All checks passed.") << std::endl;
+		return failed ? 1 : 0;
+	}
+
+	if(jsonPath.empty()) {
+		WriteJson(std::cout, results);
+	} else {
+		std::ofstream outFile(jsonPath);
+		if(!outFile.is_open()) {
+			std::cerr << "Unable to write " << jsonPath << "." << std::endl;
+			return 1;
+		}
+		WriteJson(outFile, results);
+	}
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "Log.h"
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Minimal benchmark harness with no dependencies beyond the standard library. Each benchmark is a function that runs
+// its measured loop run.Iterations() times. The whole body is timed unless it pauses the timer around its setup with
+// StopTimer/StartTimer. The runner calibrates the iteration count to the minimum run time, repeats the run and reports the median.
+// Benchmarks can also Check what they measure; a failed check fails the runner, and --check runs every benchmark once
+// for its checks alone.
+class BenchmarkRun {
+public:
+	explicit BenchmarkRun(const uint64_t iterations) : iterations(iterations) {}
+
+	uint64_t											Iterations() const { return iterations; }
+
+	// Pause and resume the measurement
+	void												StartTimer();
+	void												StopTimer();
+
+	// Extra result reported with the benchmark (latency percentiles, counters, ratios)
+	void												AddMetric(const std::string& name, const double value) { metrics.emplace_back(name, value); }
+
+	// Record a failure if condition is false; the runner reports it and exits non-zero
+	void												Check(const bool condition, const std::string& what) { if(!condition) { failures.push_back(what); } }
+
+	std::chrono::nanoseconds							Elapsed() const { return elapsed; }
+
+	const std::vector<std::pair<std::string, double>>& Metrics() const { return metrics; }
+
+	const std::vector<std::string>&						Failures() const { return failures; }
+
+private:
+	using Clock = std::chrono::steady_clock;
+
+	uint64_t									iterations;
+	std::chrono::nanoseconds					elapsed = std::chrono::nanoseconds(0);
+	Clock::time_point							started;
+	bool										timing = false;
+	std::vector<std::pair<std::string, double>> metrics;
+	std::vector<std::string>					failures;
+};
+
+using BenchmarkFunction = std::function<void(BenchmarkRun& run)>;
+
+// Logger settings the runner starts with: records are drained by the writer thread but not written anywhere
+inline LogOptions BenchmarkLogOptions() {
+	LogOptions options;
+	options.console = false;
+	return options;
+}
+
+// Registers a benchmark at static initialisation. fixedIterations skips calibration for benchmarks whose iterations
+// are slow (file system round trips) or whose body already measures a fixed workload.
+struct BenchmarkRegistration {
+	BenchmarkRegistration(const char* name, BenchmarkFunction function, uint64_t fixedIterations = 0);
+};
+
+// Function to run every registered benchmark matching the command line; returns the process exit code
+int RunBenchmarks(int argc, char** argv);
+
+// Keep a value alive so the optimiser cannot drop the computation that produced it
+template <typename T> inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__) || defined(__clang__)
+	asm volatile("" : : "r,m"(value) : "memory");
+#else
+	static volatile const void* sink;
+	sink = &value;
+#endif
+}
+
+#define BENCHMARK_CONCAT_INNER(a, b) a##b
+#define BENCHMARK_CONCAT(a, b)		 BENCHMARK_CONCAT_INNER(a, b)
+
+// BENCHMARK("Name", [](BenchmarkRun& run) { ... });
+#define BENCHMARK(...)				 static const BenchmarkRegistration BENCHMARK_CONCAT(benchmarkRegistration, __LINE__)(__VA_ARGS__)
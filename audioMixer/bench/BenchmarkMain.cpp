@@ -0,0 +1,6 @@
+#include "Benchmark.h"
+
+// Usage: audioMixerBench [--filter <substring>] [--min-time-ms <ms>] [--json <file>] [--check]
+// Progress goes to stderr; the JSON results go to the --json file, or stdout if none is given. With --check every
+// benchmark runs once and only failed checks are reported.
+int main(int argc, char** argv) { return RunBenchmarks(argc, argv); }
@@ -0,0 +1,205 @@
+#include "Benchmark.h"
+#include "ConfigReloader.h"
+#include "LatencyHistogram.h"
+#include "MixerConfig.h"
+#include "MixerController.h"
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+	constexpr const char* KEY_NAMES[] = {"Ctrl", "Alt", "Shift", "F1", "F12", "PageUp", "NumPad5", "VolumeUp", "Space", "Esc", "A", "7"};
+
+	// Function to build an audio_conf.json with the given number of applications, each with a pot and two hotkeys
+	std::string MakeConfigJson(const size_t applicationCount) {
+		std::ostringstream json;
+		json << "{\n  \"channel_count\": 8,\n  \"max_volume_updates_per_second\": 60,\n  \"applications\": [\n";
+		for(size_t i = 0; i < applicationCount; ++i) {
+			json << "    {\"application_name\": \"app" << i << ".exe\", \"pot_number\": " << (i % 8) << ", \"volume_up_key\": \"Ctrl+Alt+F" << (i % 24 + 1)
+				 << "\", \"volume_down_key\": \"Ctrl+Shift+NumPad" << (i % 10) << "\"}" << (i + 1 < applicationCount ? ",\n" : "\n");
+		}
+		json << "  ]\n}\n";
+		return json.str();
+	}
+
+	// Temporary config file, removed when the benchmark is done with it
+	class TempConfigFile {
+	public:
+		explicit TempConfigFile(const std::string& name) : path((std::filesystem::temp_directory_path() / name).string()) {}
+
+		~TempConfigFile() {
+			std::error_code error;
+			std::filesystem::remove(path, error);
+		}
+
+		void			   Write(const std::string& contents) const { std::ofstream(path, std::ios::trunc) << contents; }
+
+		const std::string& Path() const { return path; }
+
+	private:
+		std::string path;
+	};
+
+	// Function to read a config from text; returns what ReadConfig does
+	bool ReadConfigText(const TempConfigFile& file, const std::string& contents) {
+		file.Write(contents);
+		MixerConfig config;
+		return ReadConfig(file.Path(), config);
+	}
+
+	void ReadConfigBenchmark(BenchmarkRun& run, const size_t applicationCount) {
+		run.StopTimer();
+		const TempConfigFile file("audioMixerBench_read_" + std::to_string(applicationCount) + ".json");
+		file.Write(MakeConfigJson(applicationCount));
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			MixerConfig config;
+			DoNotOptimize(ReadConfig(file.Path(), config));
+		}
+	}
+
+	void LoadConfigBenchmark(BenchmarkRun& run, const size_t applicationCount) {
+		run.StopTimer();
+		const TempConfigFile file("audioMixerBench_load_" + std::to_string(applicationCount) + ".json");
+		file.Write(MakeConfigJson(applicationCount));
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			DoNotOptimize(LoadConfig(file.Path()));
+		}
+	}
+
+	BENCHMARK("ReadConfig/8_apps", [](BenchmarkRun& run) { ReadConfigBenchmark(run, 8); });
+	BENCHMARK("ReadConfig/256_apps", [](BenchmarkRun& run) { ReadConfigBenchmark(run, 256); });
+	BENCHMARK("LoadConfig/8_apps", [](BenchmarkRun& run) { LoadConfigBenchmark(run, 8); });
+	BENCHMARK("LoadConfig/256_apps", [](BenchmarkRun& run) { LoadConfigBenchmark(run, 256); });
+
+	// Channel numbers past what the boards can send are rejected before they size the routing table
+	BENCHMARK("ReadConfig/out_of_range_channels", [](BenchmarkRun& run) {
+		run.StopTimer();
+		const TempConfigFile file("audioMixerBench_channels.json");
+		const std::string	 app	  = "{\"application_name\": \"app.exe\", \"pot_number\": ";
+		uint64_t			 rejected = 0;
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			rejected += !ReadConfigText(file, "{\"channel_count\": 1000000000, \"applications\": []}");
+			rejected += !ReadConfigText(file, "{\"applications\": [" + app + "1000000000}]}");
+			rejected += !ReadConfigText(file, "{\"applications\": [" + app + "-2}]}");
+		}
+
+		run.StopTimer();
+		run.Check(rejected == 3 * run.Iterations(), "a huge channel_count or pot_number, or a pot_number below -1, is rejected");
+		const std::string lastChannel = std::to_string(MIXER_MAX_CHANNELS - 1);
+		run.Check(ReadConfigText(file, "{\"channel_count\": " + std::to_string(MIXER_MAX_CHANNELS) + ", \"applications\": [" + app + lastChannel + "}]}"),
+				  "channel_count and pot_number up to the last channel are accepted");
+	});
+
+	BENCHMARK("GetVirtualKeyCode", [](BenchmarkRun& run) {
+		run.StopTimer();
+		const std::vector<std::string> keyNames(std::begin(KEY_NAMES), std::end(KEY_NAMES));
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			DoNotOptimize(GetVirtualKeyCode(keyNames[i % keyNames.size()]));
+		}
+	});
+
+	BENCHMARK("ParseKeyCombination", [](BenchmarkRun& run) {
+		const std::string combinations[] = {"Ctrl+Alt+F5", "Ctrl+Shift+NumPad3", "Alt+VolumeUp", "Ctrl+Alt+Shift+PageDown"};
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			KeyMask keys;
+			DoNotOptimize(ParseKeyCombination(combinations[i % std::size(combinations)], keys));
+			DoNotOptimize(keys);
+		}
+	});
+
+	BENCHMARK("FormatKeyCombination", [](BenchmarkRun& run) {
+		run.StopTimer();
+		KeyMask keys;
+		ParseKeyCombination("Ctrl+Alt+Shift+PageDown", keys);
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			DoNotOptimize(FormatKeyCombination(keys));
+		}
+	});
+
+	// Read side of the live config as the keyboard hook and serial thread see it
+	BENCHMARK("ConfigRcu/read", [](BenchmarkRun& run) {
+		run.StopTimer();
+		MixerController::ConfigPointer config;
+		config.Publish(std::make_unique<MixerConfig>());
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			const auto liveConfig = config.Read(MixerController::CONFIG_READER_INPUT);
+			DoNotOptimize(liveConfig->generation);
+		}
+	});
+
+	// Same, while another thread publishes a new config as fast as it can
+	BENCHMARK("ConfigRcu/read_while_publishing", [](BenchmarkRun& run) {
+		run.StopTimer();
+		MixerController::ConfigPointer config;
+		config.Publish(std::make_unique<MixerConfig>());
+		std::atomic<bool>	  publishing = true;
+		std::atomic<uint64_t> published	 = 0;
+		std::thread			  publisher([&] {
+			  while(publishing) {
+				  config.Publish(std::make_unique<MixerConfig>());
+				  ++published;
+			  }
+		  });
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			const auto liveConfig = config.Read(MixerController::CONFIG_READER_SERIAL);
+			DoNotOptimize(liveConfig->generation);
+		}
+
+		run.StopTimer();
+		publishing = false;
+		publisher.join();
+		run.AddMetric("publishes", static_cast<double>(published));
+	});
+
+	// Time from rewriting audio_conf.json to the reloaded config being published (includes ConfigReloader::DEBOUNCE_MS)
+	BENCHMARK(
+		"ConfigReloader/reload_latency",
+		[](BenchmarkRun& run) {
+			run.StopTimer();
+			const TempConfigFile file("audioMixerBench_reload.json");
+			file.Write(MakeConfigJson(32));
+
+			std::atomic<uint64_t> publishedCount = 0;
+			ConfigReloader		  reloader(file.Path(), [&](std::unique_ptr<MixerConfig>) { ++publishedCount; });
+			if(!reloader.Start()) { return; }
+
+			LatencyHistogram latency;
+			for(uint64_t i = 0; i < run.Iterations(); ++i) {
+				const uint64_t expected = publishedCount + 1;
+				const auto	   written	= std::chrono::steady_clock::now();
+				run.StartTimer();
+				file.Write(MakeConfigJson(32 + i % 2));
+				while(publishedCount < expected) {
+					std::this_thread::sleep_for(std::chrono::microseconds(100));
+				}
+				run.StopTimer();
+				latency.Record(std::chrono::steady_clock::now() - written);
+			}
+
+			reloader.Stop();
+			run.AddMetric("p50_us", latency.Percentile(50).count() / 1e3);
+			run.AddMetric("max_us", latency.Max().count() / 1e3);
+			run.AddMetric("debounce_us", ConfigReloader::DEBOUNCE_MS * 1e3);
+		},
+		5);
+} // namespace
@@ -0,0 +1,287 @@
+#include "Benchmark.h"
+#include "ControlProtocol.h"
+#include "ControlServer.h"
+#include "LatencyHistogram.h"
+#include "MockAudioBackend.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+	constexpr size_t APPLICATION_COUNT = MIXER_MAX_CHANNELS;
+
+	// What the frontend does, scripted: subscribe, send volumes, decode snapshots and deltas
+	class ScriptedClient {
+	public:
+		explicit ScriptedClient(const std::string& endpoint) : connection(ConnectLocal(endpoint)) {}
+
+		bool IsConnected() const { return connection != nullptr; }
+
+		void Subscribe() { Send(ControlProtocol::SUBSCRIBE, {ControlProtocol::VERSION}); }
+
+		void SetVolume(const uint16_t applicationIndex, const uint16_t volume) {
+			Send(ControlProtocol::SET_VOLUME, {static_cast<uint8_t>(applicationIndex), static_cast<uint8_t>(applicationIndex >> 8), static_cast<uint8_t>(volume),
+											   static_cast<uint8_t>(volume >> 8)});
+		}
+
+		// Function to wait for the next message; returns false after timeoutMs or once the server closed the connection
+		bool Receive(uint8_t& type, std::vector<uint8_t>& payload, const int timeoutMs) {
+			const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+			while(true) {
+				if(input.size() >= ControlProtocol::HEADER_SIZE) {
+					const size_t size = ControlProtocol::PayloadSize(input.data());
+					if(input.size() >= ControlProtocol::HEADER_SIZE + size) {
+						type = input[0];
+						payload.assign(input.begin() + ControlProtocol::HEADER_SIZE, input.begin() + ControlProtocol::HEADER_SIZE + size);
+						input.erase(input.begin(), input.begin() + ControlProtocol::HEADER_SIZE + size);
+						return true;
+					}
+				}
+
+				uint8_t	  buffer[4096];
+				const int bytesRead = connection->Read(buffer, sizeof(buffer));
+				if(bytesRead < 0) { return false; }
+				if(bytesRead > 0) {
+					input.insert(input.end(), buffer, buffer + bytesRead);
+					continue;
+				}
+				if(std::chrono::steady_clock::now() > deadline) { return false; }
+				std::this_thread::sleep_for(std::chrono::microseconds(100));
+			}
+		}
+
+		// Function to apply a snapshot or delta to the client's copy of the state
+		void Apply(const uint8_t type, const std::vector<uint8_t>& payload) {
+			if(type == ControlProtocol::SNAPSHOT) {
+				const size_t channelCount = ControlProtocol::GetU16(payload.data() + 5);
+				applicationCount		  = ControlProtocol::GetU16(payload.data() + 7);
+				for(size_t channel = 0; channel < channelCount; ++channel) {
+					channels[channel] = ControlProtocol::GetU16(payload.data() + 9 + 2 * channel);
+				}
+				++snapshotCount;
+			} else if(type == ControlProtocol::DELTA) {
+				const size_t   channelEntries = ControlProtocol::GetU16(payload.data());
+				const size_t   volumeEntries  = ControlProtocol::GetU16(payload.data() + 2);
+				const uint8_t* entry		  = payload.data() + 4;
+				for(size_t i = 0; i < channelEntries + volumeEntries; ++i, entry += ControlProtocol::DELTA_ENTRY_SIZE) {
+					std::array<uint16_t, MixerState::MAX_CHANNELS>& values = i < channelEntries ? channels : volumes;
+					values[ControlProtocol::GetU16(entry)]				   = ControlProtocol::GetU16(entry + 2);
+				}
+				++deltaCount;
+			}
+		}
+
+		std::array<uint16_t, MixerState::MAX_CHANNELS>	   channels{};
+		std::array<uint16_t, MixerState::MAX_APPLICATIONS> volumes{};
+		size_t											   applicationCount = 0;
+		uint64_t										   snapshotCount	= 0;
+		uint64_t										   deltaCount		= 0;
+
+	private:
+		void Send(const ControlProtocol::MessageType type, std::initializer_list<uint8_t> payload) {
+			std::vector<uint8_t> message;
+			const size_t		 start = ControlProtocol::BeginMessage(message, type);
+			message.insert(message.end(), payload);
+			ControlProtocol::EndMessage(message, start);
+			for(size_t written = 0; written < message.size();) {
+				const int result = connection->Write(message.data() + written, message.size() - written);
+				if(result < 0) { return; }
+				written += static_cast<size_t>(result);
+			}
+		}
+
+		std::unique_ptr<LocalConnection> connection;
+		std::vector<uint8_t>			 input;
+	};
+
+	// Function to pick a socket path no other run uses
+	std::string BenchmarkEndpoint() { return (std::filesystem::temp_directory_path() / ("audioMixerBench_control_" + std::to_string(getpid()) + ".sock")).string(); }
+
+	// Function to build a config with one application per channel, each with a mock session
+	std::unique_ptr<MixerConfig> MakeConfig(MockAudioBackend& backend) {
+		auto config						  = std::make_unique<MixerConfig>();
+		config->maxVolumeUpdatesPerSecond = 1000000; // Measure the path, not the rate limit
+		for(size_t channel = 0; channel < APPLICATION_COUNT; ++channel) {
+			ApplicationConfig app;
+			app.applicationName		   = "app" + std::to_string(channel) + ".exe";
+			app.target.applicationName = app.applicationName;
+			app.potNumber			   = static_cast<int>(channel);
+			config->applications.push_back(app);
+			backend.AddSession(app.applicationName, 0.5f);
+		}
+		CompileConfig(*config);
+		return config;
+	}
+
+	// Frontend round trip: SET_VOLUME sent, applied by the audio worker, and reported back in a delta. Includes up to one
+	// update interval of the server batching changes.
+	BENCHMARK(
+		"ControlServer/set_volume_round_trip",
+		[](BenchmarkRun& run) {
+			run.StopTimer();
+			MockAudioBackend backend;
+			MixerController	 mixer(backend);
+			mixer.PublishConfig(MakeConfig(backend));
+			mixer.Start();
+			ControlServer server(mixer, BenchmarkEndpoint());
+			if(!server.Start()) { return; }
+
+			ScriptedClient		 client(BenchmarkEndpoint());
+			uint8_t				 type = 0;
+			std::vector<uint8_t> payload;
+			if(!client.IsConnected()) { return; }
+			client.Subscribe();
+			if(!client.Receive(type, payload, 1000)) { return; }
+			client.Apply(type, payload);
+
+			LatencyHistogram roundTrip;
+			uint64_t		 lost = 0;
+			for(uint64_t i = 0; i < run.Iterations(); ++i) {
+				const uint16_t applicationIndex = static_cast<uint16_t>(i % APPLICATION_COUNT);
+				const uint16_t volume			= static_cast<uint16_t>((i * 37) % ControlProtocol::VOLUME_SCALE);
+				const auto	   sentAt			= std::chrono::steady_clock::now();
+				run.StartTimer();
+				client.SetVolume(applicationIndex, volume);
+				bool received = false;
+				while(!received && client.Receive(type, payload, 1000)) {
+					client.Apply(type, payload);
+					received = client.volumes[applicationIndex] == volume;
+				}
+				run.StopTimer();
+				if(!received) {
+					++lost;
+					continue;
+				}
+				roundTrip.Record(std::chrono::steady_clock::now() - sentAt);
+			}
+
+			server.Stop();
+			mixer.Stop();
+			run.AddMetric("snapshot_applications", static_cast<double>(client.applicationCount));
+			run.AddMetric("round_trip_p50_ms", roundTrip.Percentile(50).count() / 1e6);
+			run.AddMetric("round_trip_p99_ms", roundTrip.Percentile(99).count() / 1e6);
+			run.AddMetric("updates_lost", static_cast<double>(lost));
+		},
+		200);
+
+	// SET_VOLUME for an application the config does not have: refused, and the connection stays usable
+	BENCHMARK(
+		"ControlServer/set_volume_unknown_application",
+		[](BenchmarkRun& run) {
+			run.StopTimer();
+			MockAudioBackend backend;
+			MixerController	 mixer(backend);
+			mixer.PublishConfig(MakeConfig(backend));
+			mixer.Start();
+			ControlServer server(mixer, BenchmarkEndpoint());
+			if(!server.Start()) { return; }
+
+			ScriptedClient		 client(BenchmarkEndpoint());
+			uint8_t				 type = 0;
+			std::vector<uint8_t> payload;
+			if(!client.IsConnected()) { return; }
+			client.Subscribe();
+			if(!client.Receive(type, payload, 1000)) { return; }
+			client.Apply(type, payload);
+
+			uint64_t refused = 0;
+			uint64_t applied = 0;
+			for(uint64_t i = 0; i < run.Iterations(); ++i) {
+				const uint16_t volume = static_cast<uint16_t>(1 + i % (ControlProtocol::VOLUME_SCALE - 1));
+				run.StartTimer();
+				client.SetVolume(0xFFFF, volume);
+				client.SetVolume(0, volume);
+				bool received = false;
+				while(!received && client.Receive(type, payload, 1000)) {
+					if(type == ControlProtocol::REFUSED && payload.size() == 2 && payload[0] == ControlProtocol::SET_VOLUME &&
+					   payload[1] == ControlProtocol::UNKNOWN_APPLICATION) {
+						++refused;
+					}
+					client.Apply(type, payload);
+					received = client.volumes[0] == volume;
+				}
+				run.StopTimer();
+				if(received) { ++applied; }
+			}
+
+			server.Stop();
+			mixer.Stop();
+			run.Check(refused == run.Iterations(), "SET_VOLUME for an unknown application is refused");
+			run.Check(applied == run.Iterations(), "the connection stays open and the next SET_VOLUME is applied");
+		},
+		200);
+
+	// Pot frames routed while one client keeps up and another never reads. Compare the time per frame with
+	// MixerController/pot_frame_to_mock_backend: the stalled client must not slow the pot path down, and the reading client
+	// must still end up with the latest values.
+	BENCHMARK("ControlServer/pot_frames_with_stalled_client", [](BenchmarkRun& run) {
+		run.StopTimer();
+		MockAudioBackend backend;
+		MixerController	 mixer(backend);
+		mixer.PublishConfig(MakeConfig(backend));
+		mixer.Start();
+		ControlServer server(mixer, BenchmarkEndpoint(), std::chrono::milliseconds(1));
+		if(!server.Start()) { return; }
+
+		ScriptedClient stalledClient(BenchmarkEndpoint());
+		ScriptedClient client(BenchmarkEndpoint());
+		if(!stalledClient.IsConnected() || !client.IsConnected()) { return; }
+		stalledClient.Subscribe();
+		client.Subscribe();
+
+		std::array<uint16_t, MIXER_MAX_CHANNELS> expected{};
+		std::atomic<bool>						 caughtUp	 = false;
+		std::atomic<bool>						 keepReading = true;
+
+		// The reading client decodes everything it is sent and checks it against the last frame
+		std::thread reader([&] {
+			uint8_t				 type = 0;
+			std::vector<uint8_t> payload;
+			while(keepReading) {
+				if(!client.Receive(type, payload, 10)) { continue; }
+				client.Apply(type, payload);
+				caughtUp = std::equal(expected.begin(), expected.end(), client.channels.begin());
+			}
+		});
+
+		std::array<ChannelValue, MIXER_MAX_CHANNELS> updates;
+		MixerFrame									 frame;
+		frame.type	  = MIXER_FRAME_FULL;
+		frame.updates = updates;
+		run.StartTimer();
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			for(uint8_t channel = 0; channel < MIXER_MAX_CHANNELS; ++channel) {
+				updates[channel] = {channel, static_cast<uint16_t>((i + channel) % (MIXER_VALUE_MAX + 1))};
+			}
+			frame.receivedAt = frame.parsedAt = std::chrono::steady_clock::now();
+			mixer.ApplyPotFrame(frame);
+		}
+		run.StopTimer();
+
+		// The reading client should see the last frame within a few update intervals
+		caughtUp = false;
+		for(const ChannelValue& update : updates) {
+			expected[update.channel] = update.value;
+		}
+		const auto lastFrameAt = std::chrono::steady_clock::now();
+		while(!caughtUp && std::chrono::steady_clock::now() - lastFrameAt < std::chrono::seconds(2)) {
+			std::this_thread::sleep_for(std::chrono::microseconds(200));
+		}
+		const auto catchUp = std::chrono::steady_clock::now() - lastFrameAt;
+
+		keepReading = false;
+		reader.join();
+		run.AddMetric("clients_connected", static_cast<double>(server.ClientCount()));
+		run.AddMetric("reader_caught_up", caughtUp ? 1.0 : 0.0);
+		run.AddMetric("reader_catch_up_ms", std::chrono::duration<double, std::milli>(catchUp).count());
+		run.AddMetric("reader_deltas", static_cast<double>(client.deltaCount));
+		server.Stop();
+		mixer.Stop();
+	});
+} // namespace
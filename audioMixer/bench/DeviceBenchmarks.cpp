@@ -0,0 +1,183 @@
+#include "Benchmark.h"
+#include "LatencyHistogram.h"
+#include "MixerController.h"
+#include "MockAudioBackend.h"
+#include "SerialDeviceManager.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <fcntl.h>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+	constexpr size_t BOARD_COUNT		 = 4;
+	constexpr size_t CHANNELS_PER_BOARD = 5;
+
+	// A pseudo-terminal standing in for a mixer board: the device manager opens the slave by path, the benchmark writes
+	// frames to the master. Closing the master looks like the board being unplugged.
+	class FakeBoard {
+	public:
+		FakeBoard() {
+			master = posix_openpt(O_RDWR | O_NOCTTY);
+			if(master >= 0 && grantpt(master) == 0 && unlockpt(master) == 0) { slavePath = ptsname(master); }
+		}
+
+		~FakeBoard() { Unplug(); }
+
+		bool			   IsOpen() const { return !slavePath.empty(); }
+
+		const std::string& SlavePath() const { return slavePath; }
+
+		// Function to close the master, which the slave sees as a hang-up
+		void Unplug() {
+			if(master >= 0) { close(master); }
+			master = -1;
+		}
+
+		// Function to send one delta frame moving a single channel
+		void SendDelta(const uint8_t channel, const uint16_t value) {
+			uint8_t		 frame[MIXER_MAX_FRAME_SIZE];
+			const size_t size = mixer_encode_delta(frame, sequence++, 0, &channel, &value, 1);
+			for(size_t written = 0; written < size;) {
+				const ssize_t result = write(master, frame + written, size - written);
+				if(result <= 0) { return; }
+				written += static_cast<size_t>(result);
+			}
+		}
+
+	private:
+		int			master	 = -1;
+		std::string slavePath;
+		uint8_t		sequence = 0;
+	};
+
+	// Function to build a config with BOARD_COUNT boards mapped one after another and one application per global channel
+	std::unique_ptr<MixerConfig> MakeConfig(const std::vector<std::string>& portNames) {
+		auto config						  = std::make_unique<MixerConfig>();
+		config->maxVolumeUpdatesPerSecond = 1000000; // Measure the path, not the rate limit
+		for(size_t i = 0; i < portNames.size(); ++i) {
+			config->devices.push_back({portNames[i], 115200, i * CHANNELS_PER_BOARD, CHANNELS_PER_BOARD});
+		}
+		for(size_t channel = 0; channel < portNames.size() * CHANNELS_PER_BOARD; ++channel) {
+			ApplicationConfig app;
+			app.applicationName		   = "app" + std::to_string(channel) + ".exe";
+			app.target.applicationName = app.applicationName;
+			app.potNumber			   = static_cast<int>(channel);
+			config->applications.push_back(app);
+		}
+		CompileConfig(*config);
+		return config;
+	}
+
+	// Function to wait until a condition holds; returns false after timeoutMs
+	template <typename Condition> bool WaitFor(Condition&& condition, const int timeoutMs) {
+		const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+		while(!condition()) {
+			if(std::chrono::steady_clock::now() > deadline) { return false; }
+			std::this_thread::sleep_for(std::chrono::microseconds(200));
+		}
+		return true;
+	}
+
+	// Four boards fed concurrently, all serviced by one event loop thread and routed into one global channel namespace
+	BENCHMARK("SerialDeviceManager/4_ptys_concurrent", [](BenchmarkRun& run) {
+		run.StopTimer();
+		std::vector<std::unique_ptr<FakeBoard>> boards;
+		std::vector<std::string>				portNames;
+		for(size_t i = 0; i < BOARD_COUNT; ++i) {
+			boards.push_back(std::make_unique<FakeBoard>());
+			if(!boards.back()->IsOpen()) { return; }
+			portNames.push_back(boards.back()->SlavePath());
+		}
+
+		MockAudioBackend backend;
+		for(size_t channel = 0; channel < BOARD_COUNT * CHANNELS_PER_BOARD; ++channel) {
+			backend.AddSession("app" + std::to_string(channel) + ".exe", 0.5f);
+		}
+		MixerController mixer(backend);
+		mixer.PublishConfig(MakeConfig(portNames));
+		mixer.Start();
+
+		std::atomic<uint64_t> framesReceived = 0;
+		std::atomic<bool>	  keepRunning	 = true;
+		SerialDeviceManager	  deviceManager(mixer.ReadLiveConfig(MixerController::CONFIG_READER_INPUT)->devices,
+											[&](const MixerFrame& frame, const DeviceConfig& device) {
+												mixer.ApplyPotFrame(frame, device.firstChannel, device.channelCount);
+												++framesReceived;
+											});
+		std::thread			  loopThread([&] { deviceManager.Run(keepRunning); });
+		const bool			  connected = WaitFor([&] { return deviceManager.ConnectedCount() == BOARD_COUNT; }, 2000);
+
+		const uint64_t perBoard = (run.Iterations() + BOARD_COUNT - 1) / BOARD_COUNT;
+		const uint64_t expected = perBoard * BOARD_COUNT;
+		run.StartTimer();
+		if(connected) {
+			std::vector<std::thread> feeders;
+			for(size_t b = 0; b < BOARD_COUNT; ++b) {
+				feeders.emplace_back([&, b] {
+					for(uint64_t i = 0; i < perBoard; ++i) {
+						boards[b]->SendDelta(static_cast<uint8_t>(i % CHANNELS_PER_BOARD), static_cast<uint16_t>(i % (MIXER_VALUE_MAX + 1)));
+					}
+				});
+			}
+			for(std::thread& feeder : feeders) {
+				feeder.join();
+			}
+			WaitFor([&] { return framesReceived == expected; }, 5000);
+		}
+		run.StopTimer();
+
+		keepRunning = false;
+		loopThread.join();
+		mixer.Stop();
+		run.AddMetric("frames_lost", static_cast<double>(expected - framesReceived));
+		run.AddMetric("backend_calls", static_cast<double>(backend.SetVolumeCount()));
+	});
+
+	// Time from a board reappearing to the manager having reopened it, with the port path kept stable by a symlink as a
+	// udev rule or a fixed COM port number would
+	BENCHMARK(
+		"SerialDeviceManager/hot_plug_reconnect",
+		[](BenchmarkRun& run) {
+			run.StopTimer();
+			const std::filesystem::path link = std::filesystem::temp_directory_path() / ("audioMixerBench_board_" + std::to_string(getpid()));
+			auto						board = std::make_unique<FakeBoard>();
+			if(!board->IsOpen()) { return; }
+			std::filesystem::create_symlink(board->SlavePath(), link);
+
+			std::atomic<bool>	keepRunning = true;
+			SerialDeviceManager deviceManager({{link.string(), 115200, 0, CHANNELS_PER_BOARD}}, [](const MixerFrame&, const DeviceConfig&) {});
+			std::thread			loopThread([&] { deviceManager.Run(keepRunning); });
+			WaitFor([&] { return deviceManager.ConnectedCount() == 1; }, 2000);
+
+			LatencyHistogram reconnectLatency;
+			for(uint64_t i = 0; i < run.Iterations(); ++i) {
+				board->Unplug();
+				if(!WaitFor([&] { return deviceManager.ConnectedCount() == 0; }, 2000)) { break; }
+
+				// Plug a new board in under the same name
+				board = std::make_unique<FakeBoard>();
+				const std::filesystem::path newLink = link.string() + ".new";
+				std::filesystem::create_symlink(board->SlavePath(), newLink);
+				std::filesystem::rename(newLink, link);
+
+				const auto pluggedIn = std::chrono::steady_clock::now();
+				run.StartTimer();
+				const bool reconnected = WaitFor([&] { return deviceManager.ConnectedCount() == 1; }, 10000);
+				run.StopTimer();
+				if(!reconnected) { break; }
+				reconnectLatency.Record(std::chrono::steady_clock::now() - pluggedIn);
+			}
+
+			keepRunning = false;
+			loopThread.join();
+			std::filesystem::remove(link);
+			run.AddMetric("connections", static_cast<double>(deviceManager.ConnectCount()));
+			run.AddMetric("reconnect_max_ms", reconnectLatency.Max().count() / 1e6);
+		},
+		3);
+} // namespace
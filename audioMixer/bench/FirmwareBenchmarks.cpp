@@ -0,0 +1,260 @@
+#include "Benchmark.h"
+#include "LatencyHistogram.h"
+#include "period_stats.h"
+#include "pot_filter.h"
+#include "tx_policy.h"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <functional>
+#include <random>
+
+// Simulated knob traces run through the firmware's transmit policy (audioMixerFirmware/main/tx_policy.c) on a virtual
+// clock: how long a move takes to reach the host and how many frames the link carries while nothing moves. The pot filter
+// (pot_filter.c) is driven with noisy raw samples the same way.
+namespace {
+	constexpr uint8_t  POT_COUNT	   = 5;
+	constexpr uint32_t BATCH_PERIOD_US = 3200; // One DMA conversion frame of 64 samples at 20 kHz
+	constexpr uint16_t FILTER_STEP	   = 24;   // Filtered values move in hysteresis steps
+	constexpr uint16_t RESTING_VALUE   = 2048;
+
+	// Settings the firmware ships with (sdkconfig)
+	constexpr tx_policy_config_t SHIPPED_CONFIG = {5, 1500, 1000, 10000, 48};
+
+	using Values = std::array<uint16_t, POT_COUNT>;
+	using Trace	 = std::function<void(uint64_t timeUs, Values& values)>;
+
+	struct TraceResult {
+		LatencyHistogram latency; // From a filtered value changing on the board to the host having it
+		uint64_t		 batches	  = 0;
+		uint64_t		 frames		  = 0;
+		uint64_t		 heartbeats	  = 0;
+		uint64_t		 wakeups	  = 0; // Switches from idle to the fast rate
+		uint64_t		 movingUs	  = 0; // Time during which some value differed from the previous batch
+		uint64_t		 movingFrames = 0; // Frames sent during that time
+	};
+
+	// Function to feed a trace to the policy batch by batch and play the host's side of the frames it picks
+	void RunTrace(const Trace& trace, const uint64_t durationUs, TraceResult& result) {
+		tx_policy_t policy;
+		tx_policy_init(&policy, POT_COUNT);
+
+		Values	 values				  = {};
+		Values	 previous			  = {};
+		Values	 host				  = {}; // Values the host has been sent
+		uint64_t changedAt[POT_COUNT] = {}; // When the board's value last diverged from the host's
+		bool	 diverged[POT_COUNT]  = {};
+		uint8_t	 changedChannels[POT_COUNT];
+		uint16_t changedValues[POT_COUNT];
+		uint8_t	 changedCount		  = 0;
+		for(uint64_t timeUs = 0; timeUs < durationUs; timeUs += BATCH_PERIOD_US) {
+			trace(timeUs, values);
+			for(uint8_t pot = 0; pot < POT_COUNT; ++pot) {
+				if(values[pot] != host[pot] && !diverged[pot]) {
+					diverged[pot]  = true;
+					changedAt[pot] = timeUs;
+				}
+			}
+
+			const tx_policy_mode_t modeBefore = policy.mode;
+			const tx_send_t		   send		  = tx_policy_update(&policy, &SHIPPED_CONFIG, static_cast<uint32_t>(timeUs / 1000), values.data(), changedChannels,
+															 changedValues, &changedCount);
+			const bool			   moving	  = values != previous;
+			previous						  = values;
+			++result.batches;
+			if(moving) { result.movingUs += BATCH_PERIOD_US; }
+			if(modeBefore == TX_POLICY_IDLE && policy.mode == TX_POLICY_ACTIVE) { ++result.wakeups; }
+			if(send == TX_SEND_NONE) { continue; }
+
+			++result.frames;
+			if(moving) { ++result.movingFrames; }
+			if(send == TX_SEND_HEARTBEAT) { ++result.heartbeats; }
+			for(uint8_t i = 0; i < changedCount; ++i) {
+				host[send == TX_SEND_FULL ? i : changedChannels[i]] = changedValues[i];
+			}
+			for(uint8_t pot = 0; pot < POT_COUNT; ++pot) {
+				if(diverged[pot] && host[pot] == values[pot]) {
+					diverged[pot] = false;
+					result.latency.Record(std::chrono::microseconds(timeUs - changedAt[pot]));
+				}
+			}
+		}
+	}
+
+	// Function to report a trace's latency and frame counts
+	void AddTraceMetrics(BenchmarkRun& run, const TraceResult& result) {
+		run.AddMetric("latency_p50_ms", result.latency.Percentile(50).count() / 1e6);
+		run.AddMetric("latency_max_ms", result.latency.Max().count() / 1e6);
+		run.AddMetric("frames", static_cast<double>(result.frames));
+		run.AddMetric("heartbeats", static_cast<double>(result.heartbeats));
+		run.AddMetric("wakeups", static_cast<double>(result.wakeups));
+		run.AddMetric("ns_per_batch", static_cast<double>(run.Elapsed().count()) / result.batches);
+	}
+
+	// Settings the firmware ships with (sdkconfig: CONFIG_MIXER_OVERSAMPLE, CONFIG_MIXER_HYSTERESIS)
+	constexpr pot_filter_config_t SHIPPED_FILTER = {32, 24};
+	constexpr int				  SAMPLE_NOISE	 = 6;	 // Raw counts of noise on every sample, either way
+	constexpr size_t			  HOLD_SAMPLES	 = 2000; // Samples a pot rests at each end of the sweep
+
+	// A pot swept slowly from the middle down to its stop, up to the other stop and back, with noise on every raw sample:
+	// both ends have to come out of the filter exactly, and noise at a stop must not move the output
+	BENCHMARK("PotFilter/full_sweep", [](BenchmarkRun& run) {
+		std::vector<uint16_t> samples;
+		std::vector<bool>	  holding; // Resting at a stop, past the filter window
+		const auto			  add = [&](const int value, const bool hold) {
+			 samples.push_back(static_cast<uint16_t>(value));
+			 holding.push_back(hold);
+		};
+		for(int value = RESTING_VALUE; value > 0; --value) {
+			add(value, false);
+		}
+		for(size_t i = 0; i < HOLD_SAMPLES; ++i) {
+			add(0, i >= SHIPPED_FILTER.window);
+		}
+		for(int value = 0; value < MIXER_VALUE_MAX; ++value) {
+			add(value, false);
+		}
+		for(size_t i = 0; i < HOLD_SAMPLES; ++i) {
+			add(MIXER_VALUE_MAX, i >= SHIPPED_FILTER.window);
+		}
+		for(int value = MIXER_VALUE_MAX; value > RESTING_VALUE; --value) {
+			add(value, false);
+		}
+
+		// The ADC clips at the stops, so noise there only goes one way
+		std::mt19937					   random(42);
+		std::uniform_int_distribution<int> noise(-SAMPLE_NOISE, SAMPLE_NOISE);
+		for(uint16_t& sample : samples) {
+			sample = static_cast<uint16_t>(std::clamp(sample + noise(random), 0, MIXER_VALUE_MAX));
+		}
+		run.StartTimer();
+
+		uint16_t lowest			= MIXER_VALUE_MAX;
+		uint16_t highest		= 0;
+		uint64_t changes		= 0;
+		uint64_t changesHolding = 0;
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			pot_filter_channel_t channel;
+			pot_filter_init(&channel);
+			for(size_t j = 0; j < samples.size(); ++j) {
+				if(!pot_filter_push(&channel, &SHIPPED_FILTER, samples[j])) { continue; }
+				const uint16_t output = pot_filter_output(&channel);
+				lowest				  = std::min(lowest, output);
+				highest				  = std::max(highest, output);
+				++changes;
+				if(holding[j]) { ++changesHolding; }
+			}
+		}
+
+		run.StopTimer();
+		run.Check(lowest == 0, "a pot turned fully down reports 0");
+		run.Check(highest == MIXER_VALUE_MAX, "a pot turned fully up reports MIXER_VALUE_MAX");
+		run.Check(changesHolding == 0, "noise on a pot resting at a stop does not move the output");
+		run.AddMetric("lowest", lowest);
+		run.AddMetric("highest", highest);
+		run.AddMetric("changes_per_sweep", static_cast<double>(changes) / run.Iterations());
+		run.AddMetric("ns_per_sample", static_cast<double>(run.Elapsed().count()) / (run.Iterations() * samples.size()));
+	});
+
+	// Filtered value of a pot turned from RESTING_VALUE at countsPerSecond for movingUs, starting at startUs
+	uint16_t Turned(const uint64_t timeUs, const uint64_t startUs, const uint64_t movingUs, const uint32_t countsPerSecond) {
+		const uint64_t turnedUs = timeUs < startUs ? 0 : (timeUs - startUs < movingUs ? timeUs - startUs : movingUs);
+		const uint64_t counts	= turnedUs * countsPerSecond / 1000000;
+		return static_cast<uint16_t>(RESTING_VALUE + counts / FILTER_STEP * FILTER_STEP);
+	}
+
+	// One pot turned quickly across half its range after a long rest, then left alone: the first change has to wake the
+	// link, the rest go out at the fast rate, and the link decays back to heartbeats afterwards
+	BENCHMARK(
+		"TxPolicy/knob_turn_after_idle",
+		[](BenchmarkRun& run) {
+			constexpr uint64_t START_US	 = 30'000'000;
+			constexpr uint64_t MOVING_US = 250'000;
+			TraceResult		   result;
+			RunTrace(
+				[](const uint64_t timeUs, Values& values) {
+					values.fill(RESTING_VALUE);
+					values[0] = Turned(timeUs, START_US, MOVING_US, 8000);
+				},
+				60'000'000, result);
+			run.StopTimer();
+
+			AddTraceMetrics(run, result);
+			run.AddMetric("frames_per_s_moving", result.movingUs ? result.movingFrames * 1e6 / result.movingUs : 0.0);
+		},
+		1);
+
+	// An hour with every pot still apart from a one-step drift on one pot every 7.3 s, below the wake threshold: the link
+	// stays idle and the drift rides on the heartbeats
+	BENCHMARK(
+		"TxPolicy/idle_hour_with_drift",
+		[](BenchmarkRun& run) {
+			TraceResult result;
+			RunTrace(
+				[](const uint64_t timeUs, Values& values) {
+					values.fill(RESTING_VALUE);
+					if(timeUs / 7'300'000 % 2 == 1) { values[2] = RESTING_VALUE + FILTER_STEP; }
+				},
+				3'600'000'000, result);
+			run.StopTimer();
+
+			AddTraceMetrics(run, result);
+			run.AddMetric("frames_per_minute", result.frames / 60.0);
+		},
+		1);
+
+	// Every pot swept back and forth continuously: the frame rate the policy settles at under constant motion
+	BENCHMARK(
+		"TxPolicy/all_pots_sweeping",
+		[](BenchmarkRun& run) {
+			TraceResult result;
+			RunTrace(
+				[](const uint64_t timeUs, Values& values) {
+					for(uint8_t pot = 0; pot < POT_COUNT; ++pot) {
+						const uint64_t phase = (timeUs / 1000 + pot * 800) % (2 * MIXER_VALUE_MAX);
+						const uint64_t sweep = phase < MIXER_VALUE_MAX ? phase : 2 * MIXER_VALUE_MAX - phase;
+						values[pot]			 = static_cast<uint16_t>(sweep / FILTER_STEP * FILTER_STEP);
+					}
+				},
+				60'000'000, result);
+			run.StopTimer();
+
+			AddTraceMetrics(run, result);
+			run.AddMetric("frames_per_s", result.frames / 60.0);
+		},
+		1);
+
+	// A known jittered period sequence around BATCH_PERIOD_US, recorded in two batches and merged the way the transmit task
+	// folds batches into a stats frame: the frame must carry the exact mean period and mean and largest jitter
+	BENCHMARK(
+		"PeriodStats/jittered_sequence",
+		[](BenchmarkRun& run) {
+			constexpr uint32_t PERIODS[] = {3200, 3250, 3150, 3400, 3000, 3200, 3330, 3070}; // Jitter 0 50 50 200 200 0 130 130
+			constexpr size_t   HALF		 = std::size(PERIODS) / 2;
+			period_stats_t	   first;
+			period_stats_t	   second;
+			period_stats_reset(&first);
+			period_stats_reset(&second);
+			for(size_t i = 0; i < std::size(PERIODS); ++i) {
+				period_stats_add(i < HALF ? &first : &second, PERIODS[i], BATCH_PERIOD_US);
+			}
+			period_stats_merge(&first, &second);
+
+			uint32_t counters[MIXER_STAT_COUNT] = {};
+			period_stats_fill(&first, counters);
+			run.StopTimer();
+
+			run.Check(counters[MIXER_STAT_BATCHES] == std::size(PERIODS), "every period is counted once");
+			run.Check(counters[MIXER_STAT_PERIOD_MEAN_US] == 3200, "the mean period is 3200 us");
+			run.Check(counters[MIXER_STAT_JITTER_MEAN_US] == 95, "the mean jitter is 95 us");
+			run.Check(counters[MIXER_STAT_JITTER_MAX_US] == 200, "the largest jitter is 200 us");
+
+			period_stats_t empty;
+			period_stats_reset(&empty);
+			period_stats_fill(&empty, counters);
+			run.Check(counters[MIXER_STAT_BATCHES] == 0 && counters[MIXER_STAT_PERIOD_MEAN_US] == 0 && counters[MIXER_STAT_JITTER_MAX_US] == 0,
+					  "a window without batches reports zeros");
+		},
+		1);
+} // namespace
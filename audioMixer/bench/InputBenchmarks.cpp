@@ -0,0 +1,346 @@
+#include "ApplicationMatcher.h"
+#include "Benchmark.h"
+#include "ChannelRouter.h"
+#include "FrameParser.h"
+#include "KeyBindingMatcher.h"
+#include "ProcessIndex.h"
+
+#include <random>
+#include <regex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace {
+	constexpr size_t CHANNEL_COUNT = 32;
+	constexpr size_t FRAME_COUNT   = 1024; // Frames per encoded stream, cycled through by the parser benchmarks
+
+	// Encoded frames back to back, as the firmware would send them
+	struct FrameStream {
+		std::vector<uint8_t> bytes;
+		std::vector<size_t>	 offsets; // Frame i is bytes[offsets[i]..offsets[i + 1])
+	};
+
+	// Function to encode FRAME_COUNT frames: deltas of two moving channels, or full frames of every channel
+	FrameStream EncodeStream(const bool fullFrames) {
+		FrameStream	 stream;
+		std::mt19937 random(42);
+		uint16_t	 values[CHANNEL_COUNT] = {};
+		uint8_t		 frame[MIXER_MAX_FRAME_SIZE];
+		for(size_t i = 0; i < FRAME_COUNT; ++i) {
+			const auto sequence = static_cast<uint8_t>(i);
+			const auto sampled	= static_cast<uint32_t>(i * 5000);
+			size_t	   size		= 0;
+			if(fullFrames) {
+				for(uint16_t& value : values) {
+					value = static_cast<uint16_t>(random() % (MIXER_VALUE_MAX + 1));
+				}
+				size = mixer_encode_full(frame, sequence, sampled, values, CHANNEL_COUNT);
+			} else {
+				uint8_t	 channels[2]	= {static_cast<uint8_t>(random() % CHANNEL_COUNT), static_cast<uint8_t>(random() % CHANNEL_COUNT)};
+				uint16_t deltaValues[2] = {static_cast<uint16_t>(random() % (MIXER_VALUE_MAX + 1)), static_cast<uint16_t>(random() % (MIXER_VALUE_MAX + 1))};
+				size					= mixer_encode_delta(frame, sequence, sampled, channels, deltaValues, 2);
+			}
+			stream.offsets.push_back(stream.bytes.size());
+			stream.bytes.insert(stream.bytes.end(), frame, frame + size);
+		}
+		stream.offsets.push_back(stream.bytes.size());
+		return stream;
+	}
+
+	// One frame per iteration, each fed as its own read like the serial thread sees them at the board's frame rate
+	void ParserBenchmark(BenchmarkRun& run, const bool fullFrames) {
+		run.StopTimer();
+		const FrameStream stream = EncodeStream(fullFrames);
+		uint64_t		  values = 0;
+		FrameParser		  parser([&](const MixerFrame& frame) {
+			  for(const ChannelValue& update : frame.updates) {
+				  values += update.value;
+			  }
+		  });
+		const auto		  receivedAt = std::chrono::steady_clock::now();
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			const size_t frame = i % FRAME_COUNT;
+			parser.Feed(stream.bytes.data() + stream.offsets[frame], stream.offsets[frame + 1] - stream.offsets[frame], receivedAt);
+		}
+
+		run.StopTimer();
+		DoNotOptimize(values);
+		run.AddMetric("frames_per_second", static_cast<double>(parser.Stats().framesReceived) / (static_cast<double>(run.Elapsed().count()) / 1e9));
+		run.AddMetric("frames_corrupt", static_cast<double>(parser.Stats().framesCorrupt));
+	}
+
+	BENCHMARK("FrameParser/delta_frame", [](BenchmarkRun& run) { ParserBenchmark(run, false); });
+	BENCHMARK("FrameParser/full_frame", [](BenchmarkRun& run) { ParserBenchmark(run, true); });
+
+	// One full frame of 32 channels routed to 100 targets, every channel moving
+	BENCHMARK("ChannelRouter/32_channels_100_targets", [](BenchmarkRun& run) {
+		run.StopTimer();
+		std::vector<int> targetChannels;
+		for(int target = 0; target < 100; ++target) {
+			targetChannels.push_back(target % CHANNEL_COUNT);
+		}
+		ChannelRouter router;
+		router.Build(targetChannels, CHANNEL_COUNT);
+		uint64_t routed = 0;
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			for(size_t channel = 0; channel < CHANNEL_COUNT; ++channel) {
+				router.Route(channel, static_cast<uint16_t>(i + channel), [&](const uint16_t target, const uint16_t value) { routed += target + value; });
+			}
+		}
+		DoNotOptimize(routed);
+	});
+
+	constexpr size_t BINDING_COUNT = 256;
+
+	// Function to build BINDING_COUNT distinct modifier + key combinations
+	std::vector<KeyMask> MakeBindings() {
+		constexpr uint32_t	 modifiers[] = {VirtualKey::Control, VirtualKey::Menu, VirtualKey::Shift};
+		std::vector<KeyMask> bindings;
+		for(size_t i = 0; i < BINDING_COUNT; ++i) {
+			KeyMask keys;
+			keys.set(modifiers[i % 3]);
+			if(i % 2) { keys.set(modifiers[(i + 1) % 3]); }
+			keys.set(0x30 + i / 6 % 42); // Digits, letters and the gap between them
+			bindings.push_back(keys);
+		}
+		return bindings;
+	}
+
+	// Key-down with Ctrl held against hundreds of bindings, through the per-key index
+	BENCHMARK("KeyBindingMatcher/bitset_256_bindings", [](BenchmarkRun& run) {
+		run.StopTimer();
+		KeyBindingMatcher matcher;
+		for(const KeyMask& keys : MakeBindings()) {
+			matcher.AddBinding(keys, 0, 0.1f);
+		}
+		matcher.Build();
+		KeyboardState keyboard;
+		keyboard.KeyDown(VirtualKey::LControl);
+		uint64_t triggered = 0;
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			const uint32_t vkCode = 0x30 + static_cast<uint32_t>(i % 42);
+			keyboard.KeyDown(vkCode);
+			matcher.ForEachTriggered(vkCode, keyboard.PressedKeys(), [&](const KeyBinding&) { ++triggered; });
+			keyboard.KeyUp(vkCode);
+		}
+		DoNotOptimize(triggered);
+	});
+
+	// The matching the hook did before the bitset matcher: held keys in a hash set, every binding checked per key-down
+	BENCHMARK("KeyBindingMatcher/unordered_set_baseline_256_bindings", [](BenchmarkRun& run) {
+		run.StopTimer();
+		std::vector<std::vector<uint32_t>> bindings;
+		for(const KeyMask& keys : MakeBindings()) {
+			std::vector<uint32_t>& binding = bindings.emplace_back();
+			for(uint32_t vk = 0; vk < keys.size(); ++vk) {
+				if(keys.test(vk)) { binding.push_back(vk); }
+			}
+		}
+		std::unordered_set<uint32_t> pressedKeys = {VirtualKey::LControl, VirtualKey::Control};
+		uint64_t					 triggered	 = 0;
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			const uint32_t vkCode = 0x30 + static_cast<uint32_t>(i % 42);
+			pressedKeys.insert(vkCode);
+			for(const auto& binding : bindings) {
+				bool allHeld = true;
+				for(const uint32_t key : binding) {
+					if(!pressedKeys.contains(key)) {
+						allHeld = false;
+						break;
+					}
+				}
+				if(allHeld) { ++triggered; }
+			}
+			pressedKeys.erase(vkCode);
+		}
+		DoNotOptimize(triggered);
+	});
+
+	constexpr size_t PATTERN_COUNT = 300;
+	constexpr size_t SUBJECT_COUNT = 300;
+
+	// Function to build a config's worth of patterns: prefixed and suffixed globs on names and paths, exact titles,
+	// title globs and a few regexes
+	std::vector<std::string> MakePatterns() {
+		std::vector<std::string> patterns;
+		for(size_t i = 0; i < PATTERN_COUNT; ++i) {
+			const std::string n = std::to_string(i);
+			switch(i % 6) {
+				case 0: patterns.push_back("path:C:\\Program Files\\Vendor" + n + "\\*"); break;
+				case 1: patterns.push_back("title:Game " + n); break;
+				case 2: patterns.push_back("app" + n + "*.exe"); break;
+				case 3: patterns.push_back("*-helper" + n + ".exe"); break;
+				case 4: patterns.push_back("title:Voice*" + n); break;
+				default: patterns.push_back(i % 30 == 5 ? "/^svc" + n + "(host)?\\.exe$/" : "tool" + n + "-??.exe"); break;
+			}
+		}
+		return patterns;
+	}
+
+	struct Subject {
+		std::string processName;
+		std::string processPath;
+		std::string displayName;
+	};
+
+	// Function to build sessions of which about one in three matches a pattern
+	std::vector<Subject> MakeSubjects() {
+		std::vector<Subject> subjects;
+		for(size_t i = 0; i < SUBJECT_COUNT; ++i) {
+			const std::string n = std::to_string(i);
+			switch(i % 3) {
+				case 0: subjects.push_back({"App" + n + "Launcher.exe", "C:\\Program Files\\Vendor" + n + "\\bin\\app.exe", "Game " + n}); break;
+				case 1: subjects.push_back({"proc-helper" + n + ".exe", "D:\\Games\\proc" + n + "\\proc.exe", "Voice chat " + n}); break;
+				default: subjects.push_back({"other" + n + ".exe", "C:\\Windows\\other" + n + ".exe", "Other " + n}); break;
+			}
+		}
+		return subjects;
+	}
+
+	// Every pattern against hundreds of new sessions, through the compiled hashes and tries
+	BENCHMARK("ApplicationMatcher/300_patterns_300_sessions", [](BenchmarkRun& run) {
+		run.StopTimer();
+		ApplicationMatcher matcher;
+		std::string		   error;
+		for(const std::string& pattern : MakePatterns()) {
+			matcher.AddPattern(pattern, error);
+		}
+		matcher.Build();
+		const std::vector<Subject> subjects = MakeSubjects();
+		std::vector<uint32_t>	   matches;
+		uint64_t				   matched = 0;
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			for(const Subject& subject : subjects) {
+				matches.clear();
+				matcher.Match({subject.processName, subject.processPath, subject.displayName}, matches);
+				matched += matches.size();
+			}
+		}
+
+		run.StopTimer();
+		run.AddMetric("matches_per_pass", static_cast<double>(matched) / run.Iterations());
+	});
+
+	// Path regexes written with Windows separators, anchored (through the trie) and not
+	BENCHMARK("ApplicationMatcher/path_regex_separators", [](BenchmarkRun& run) {
+		run.StopTimer();
+		ApplicationMatcher matcher;
+		std::string		   error;
+		matcher.AddPattern("path:/^c:\\\\program files\\\\vendor\\d+\\\\/", error);
+		matcher.AddPattern("path:/\\\\bin\\\\app\\.exe$/", error);
+		matcher.Build();
+		const Subject		  subject = {"app.exe", "C:\\Program Files\\Vendor3\\bin\\app.exe", "App"};
+		std::vector<uint32_t> matches;
+		uint64_t			  matched = 0;
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			matches.clear();
+			matcher.Match({subject.processName, subject.processPath, subject.displayName}, matches);
+			matched += matches.size();
+		}
+
+		run.StopTimer();
+		run.Check(matched == 2 * run.Iterations(), "path regexes with escaped backslashes match a Windows path");
+	});
+
+	// The same patterns checked one by one against every session, with the regexes compiled up front
+	BENCHMARK("ApplicationMatcher/linear_scan_baseline_300_patterns", [](BenchmarkRun& run) {
+		run.StopTimer();
+		struct LinearPattern {
+			size_t						field = 0; // 0 name, 1 path, 2 title
+			std::string					glob;
+			std::unique_ptr<std::regex> regex;
+		};
+		std::vector<LinearPattern> patterns;
+		for(const std::string& text : MakePatterns()) {
+			LinearPattern& pattern = patterns.emplace_back();
+			const size_t   prefix  = text.starts_with("path:") ? 5 : text.starts_with("title:") ? 6 : 0;
+			pattern.field		   = text.starts_with("path:") ? 1 : prefix ? 2 : 0;
+			if(text[prefix] == '/') {
+				pattern.regex = std::make_unique<std::regex>(text.substr(prefix + 1, text.size() - prefix - 2), std::regex::icase | std::regex::optimize);
+			} else {
+				pattern.glob = ApplicationMatcher::NormalizePattern(text).substr(prefix);
+			}
+		}
+		const std::vector<Subject> subjects = MakeSubjects();
+		uint64_t				   matched	= 0;
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			for(const Subject& subject : subjects) {
+				const std::string texts[] = {ApplicationMatcher::NormalizePattern(subject.processName),
+											 ApplicationMatcher::NormalizePattern("path:" + subject.processPath).substr(5),
+											 ApplicationMatcher::NormalizePattern(subject.displayName)};
+				for(const LinearPattern& pattern : patterns) {
+					const std::string& text = texts[pattern.field];
+					if(pattern.regex ? std::regex_search(text, *pattern.regex) : ApplicationMatcher::GlobMatches(pattern.glob, text)) { ++matched; }
+				}
+			}
+		}
+
+		run.StopTimer();
+		run.AddMetric("matches_per_pass", static_cast<double>(matched) / run.Iterations());
+	});
+
+	constexpr uint32_t PROCESS_COUNT = 500;
+
+	// Function to build a synthetic process table; generation shifts a tenth of the PIDs to simulate churn
+	std::vector<ProcessInfo> MakeProcesses(const uint32_t generation) {
+		std::vector<ProcessInfo> processes;
+		for(uint32_t i = 0; i < PROCESS_COUNT; ++i) {
+			const uint32_t processId = i % 10 == 0 ? 100000 + generation * PROCESS_COUNT + i : 1000 + i;
+			processes.push_back({processId, "Process" + std::to_string(i % 200) + ".exe"});
+		}
+		return processes;
+	}
+
+	BENCHMARK("ProcessIndex/find_name_500_processes", [](BenchmarkRun& run) {
+		run.StopTimer();
+		ProcessIndex index;
+		index.Rebuild(MakeProcesses(0));
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			DoNotOptimize(index.FindName(1000 + static_cast<uint32_t>(i % PROCESS_COUNT)));
+		}
+	});
+
+	BENCHMARK("ProcessIndex/for_each_process_id", [](BenchmarkRun& run) {
+		run.StopTimer();
+		ProcessIndex index;
+		index.Rebuild(MakeProcesses(0));
+		const std::string names[] = {"process7.EXE", "Process150.exe", "missing.exe"};
+		uint64_t		  found	  = 0;
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			index.ForEachProcessId(names[i % 3], [&](const uint32_t processId) { found += processId; });
+		}
+		DoNotOptimize(found);
+	});
+
+	// Periodic full refresh where 10% of the processes changed since the last listing
+	BENCHMARK("ProcessIndex/rebuild_500_processes_10pct_churn", [](BenchmarkRun& run) {
+		run.StopTimer();
+		const std::vector<ProcessInfo> listings[] = {MakeProcesses(0), MakeProcesses(1)};
+		ProcessIndex				   index;
+		run.StartTimer();
+
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			index.Rebuild(listings[i % 2]);
+		}
+		DoNotOptimize(index.Size());
+	});
+} // namespace
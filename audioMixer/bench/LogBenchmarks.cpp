@@ -0,0 +1,111 @@
+#include "Benchmark.h"
+#include "Log.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+// Cost of a log line on the thread that writes it: the std::cout/std::endl statements the control path used to have
+// against the asynchronous logger that replaced them. Both write to /dev/null, so the numbers are the formatting,
+// locking and syscalls the calling thread pays and not the speed of a console.
+namespace {
+	constexpr uint64_t BURST_SIZE = 128; // Records logged between two drains, well within one ring
+
+	// Restarts the logger writing every record to a file for one benchmark, then goes back to the runner's settings
+	class ScopedFileLog {
+	public:
+		ScopedFileLog(const std::string& path, const uint32_t rateLimitPerSecond) {
+			LogOptions options		   = BenchmarkLogOptions();
+			options.filePath		   = path;
+			options.rateLimitPerSecond = rateLimitPerSecond;
+			Log::Stop();
+			Log::Start(options);
+		}
+
+		~ScopedFileLog() {
+			Log::Stop();
+			Log::Start(BenchmarkLogOptions());
+		}
+	};
+
+	// Baseline: what MixerController::ApplyPotFrame printed for every routed pot change
+	BENCHMARK("Log/iostream_endl", [](BenchmarkRun& run) {
+		run.StopTimer();
+		std::ofstream	  out("/dev/null");
+		const std::string applicationName = "spotify.exe";
+		run.StartTimer();
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			out << "Set volume for " << applicationName << " from " << (i % 100) * 1.0f << " to " << (i % 100 + 1) * 1.0f << "%" << std::endl;
+		}
+	});
+
+	// The same line through the logger. The timer only covers the call sites; the writer drains between bursts so the ring
+	// never fills, and its share is reported as writer_ns_per_record.
+	BENCHMARK("Log/async_record", [](BenchmarkRun& run) {
+		run.StopTimer();
+		const ScopedFileLog		 log("/dev/null", 0);
+		const std::string		 applicationName = "spotify.exe";
+		const uint64_t			 droppedBefore	 = Log::DroppedCount();
+		std::chrono::nanoseconds writerTime(0);
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			if(i % BURST_SIZE == 0) {
+				const auto flushStarted = std::chrono::steady_clock::now();
+				Log::Flush();
+				writerTime += std::chrono::steady_clock::now() - flushStarted;
+				run.StartTimer();
+			}
+			LOG_INFO("Set volume for {} from {} to {}%", applicationName, (i % 100) * 1.0f, (i % 100 + 1) * 1.0f);
+			if(i % BURST_SIZE == BURST_SIZE - 1) { run.StopTimer(); }
+		}
+		run.StopTimer();
+		const auto flushStarted = std::chrono::steady_clock::now();
+		Log::Flush();
+		writerTime += std::chrono::steady_clock::now() - flushStarted;
+
+		run.AddMetric("writer_ns_per_record", static_cast<double>(writerTime.count()) / run.Iterations());
+		run.AddMetric("dropped", static_cast<double>(Log::DroppedCount() - droppedBefore));
+	});
+
+	// An error repeated in a tight loop (a port that keeps failing to open) at the default rate limit: after the first
+	// records of each second the call site only counts what it suppressed
+	BENCHMARK("Log/rate_limited_repeat", [](BenchmarkRun& run) {
+		run.StopTimer();
+		const ScopedFileLog log("/dev/null", LogOptions().rateLimitPerSecond);
+		const std::string	portName	  = "/dev/ttyUSB0";
+		const uint64_t		droppedBefore = Log::DroppedCount();
+		run.StartTimer();
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			LOG_ERROR("Error: Unable to open serial port {}.", portName);
+		}
+		run.StopTimer();
+		Log::Flush();
+
+		run.AddMetric("dropped", static_cast<double>(Log::DroppedCount() - droppedBefore));
+	});
+
+	// The writer sleeps without a timeout, so a lone record has to wake it: each one must reach the file without a Flush
+	BENCHMARK(
+		"Log/record_wakes_writer",
+		[](BenchmarkRun& run) {
+			run.StopTimer();
+			const std::filesystem::path path = std::filesystem::temp_directory_path() / "audioMixerBench_log.txt";
+			std::error_code				error;
+			std::filesystem::remove(path, error);
+			{
+				const ScopedFileLog log(path.string(), 0);
+				for(uint64_t i = 0; i < run.Iterations(); ++i) {
+					const std::uintmax_t sizeBefore = std::filesystem::file_size(path, error);
+					LOG_INFO("Record {}", i);
+					const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(1);
+					while(std::filesystem::file_size(path, error) == sizeBefore && std::chrono::steady_clock::now() < deadline) {
+						std::this_thread::sleep_for(std::chrono::microseconds(100));
+					}
+					run.Check(std::filesystem::file_size(path, error) > sizeBefore, "a record logged without a Flush was not written within 1s");
+				}
+			}
+			std::filesystem::remove(path, error);
+		},
+		20);
+} // namespace
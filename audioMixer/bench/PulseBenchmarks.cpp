@@ -0,0 +1,175 @@
+#include "Benchmark.h"
+#include "PulseAudioBackend.h"
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+
+// PulseAudioBackend against a real server. A throwaway one with a null sink as its default:
+//   pulseaudio -n --daemonize=yes --exit-idle-time=-1 --load=module-native-protocol-unix --load=module-null-sink
+// (pactl load-module module-null-sink works too on a desktop already running PulseAudio or pipewire-pulse). The playback
+// streams are synthetic: corked streams with application.process.binary set, which the server lists as sink inputs
+// without anything being played. Without a server the benchmarks only report server_unavailable=1.
+//
+// The reconnect backoff is exercised by hand against the same server: start audioMixer, stop the server with
+// "pulseaudio -k" and expect "Reconnecting to the PulseAudio server in 500 ms." doubling up to 30000 ms, then start it
+// again and expect "Reconnected to the PulseAudio server." within one delay, with the sessions back in the list.
+namespace {
+	constexpr size_t STREAM_COUNT = 8;
+
+	// A second client owning the synthetic streams, so the backend sees them arrive like any other application's
+	class SyntheticStreams {
+	public:
+		SyntheticStreams() {
+			mainloop = pa_threaded_mainloop_new();
+			context	 = pa_context_new(pa_threaded_mainloop_get_api(mainloop), "audioMixerBench streams");
+			pa_context_set_state_callback(context, ContextStateCallback, mainloop);
+			pa_threaded_mainloop_start(mainloop);
+
+			pa_threaded_mainloop_lock(mainloop);
+			if(pa_context_connect(context, nullptr, PA_CONTEXT_NOAUTOSPAWN, nullptr) >= 0) {
+				pa_context_state_t state = pa_context_get_state(context);
+				while(PA_CONTEXT_IS_GOOD(state) && state != PA_CONTEXT_READY) {
+					pa_threaded_mainloop_wait(mainloop);
+					state = pa_context_get_state(context);
+				}
+				connected = state == PA_CONTEXT_READY;
+			}
+			pa_threaded_mainloop_unlock(mainloop);
+		}
+
+		~SyntheticStreams() {
+			pa_threaded_mainloop_lock(mainloop);
+			for(pa_stream* stream : streams) {
+				pa_stream_disconnect(stream);
+				pa_stream_unref(stream);
+			}
+			pa_context_disconnect(context);
+			pa_threaded_mainloop_unlock(mainloop);
+			pa_threaded_mainloop_stop(mainloop);
+			pa_context_unref(context);
+			pa_threaded_mainloop_free(mainloop);
+		}
+
+		bool IsConnected() const { return connected; }
+
+		// Function to open a corked stream owned by "binary" on the default sink; returns once the server has created it
+		bool Add(const std::string& binary) {
+			constexpr pa_sample_spec SPEC = {PA_SAMPLE_S16LE, 48000, 2};
+
+			pa_proplist* properties = pa_proplist_new();
+			pa_proplist_sets(properties, PA_PROP_APPLICATION_PROCESS_BINARY, binary.c_str());
+
+			pa_threaded_mainloop_lock(mainloop);
+			pa_stream* stream = pa_stream_new_with_proplist(context, binary.c_str(), &SPEC, nullptr, properties);
+			pa_proplist_free(properties);
+			if(!stream) {
+				pa_threaded_mainloop_unlock(mainloop);
+				return false;
+			}
+			streams.push_back(stream);
+			pa_stream_set_state_callback(stream, StreamStateCallback, mainloop);
+
+			pa_stream_state_t state = PA_STREAM_FAILED;
+			if(pa_stream_connect_playback(stream, nullptr, nullptr, PA_STREAM_START_CORKED, nullptr, nullptr) >= 0) {
+				state = pa_stream_get_state(stream);
+				while(PA_STREAM_IS_GOOD(state) && state != PA_STREAM_READY) {
+					pa_threaded_mainloop_wait(mainloop);
+					state = pa_stream_get_state(stream);
+				}
+			}
+			pa_threaded_mainloop_unlock(mainloop);
+			return state == PA_STREAM_READY;
+		}
+
+	private:
+		static void ContextStateCallback(pa_context*, void* userdata) { pa_threaded_mainloop_signal(static_cast<pa_threaded_mainloop*>(userdata), 0); }
+
+		static void StreamStateCallback(pa_stream*, void* userdata) { pa_threaded_mainloop_signal(static_cast<pa_threaded_mainloop*>(userdata), 0); }
+
+		pa_threaded_mainloop*	mainloop  = nullptr;
+		pa_context*				context	  = nullptr;
+		bool					connected = false;
+		std::vector<pa_stream*> streams;
+	};
+
+	std::string StreamBinary(const size_t index) { return "bench-app-" + std::to_string(index); }
+
+	// One frame of four pots against STREAM_COUNT live streams. Every volume change comes back as a change event; the
+	// subscription applies it to the local copy without invalidating the sessions, so nothing is enumerated again.
+	BENCHMARK(
+		"PulseAudio/frame_batch",
+		[](BenchmarkRun& run) {
+			run.StopTimer();
+			PulseAudioBackend backend;
+			SyntheticStreams  streams;
+			if(!backend.Initialize() || !streams.IsConnected()) {
+				run.AddMetric("server_unavailable", 1);
+				return;
+			}
+			for(size_t i = 0; i < STREAM_COUNT; ++i) {
+				streams.Add(StreamBinary(i));
+			}
+
+			std::vector<VolumeTarget> targets;
+			for(size_t i = 0; i < 4; ++i) {
+				targets.push_back({"", StreamBinary(i * 2)});
+			}
+			TargetVolume updates[4];
+			for(size_t i = 0; i < std::size(updates); ++i) {
+				updates[i].target = &targets[i];
+			}
+
+			// Let the streams' creation events settle, then load the session cache once
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			backend.SetVolumes(updates);
+			const uint64_t enumerations = backend.EnumerationCount();
+			const uint64_t events		= backend.EventCount();
+			size_t		   applied		= 0;
+			run.StartTimer();
+
+			for(uint64_t i = 0; i < run.Iterations(); ++i) {
+				for(size_t j = 0; j < std::size(updates); ++j) {
+					updates[j].volume = static_cast<float>((i + j) % 100) / 100.0f;
+				}
+				applied += backend.SetVolumes(updates);
+			}
+
+			run.StopTimer();
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+			run.AddMetric("applied_per_frame", static_cast<double>(applied) / run.Iterations());
+			run.AddMetric("session_enumerations", static_cast<double>(backend.EnumerationCount() - enumerations));
+			run.AddMetric("events_per_frame", static_cast<double>(backend.EventCount() - events) / run.Iterations());
+		},
+		5000);
+
+	// Time from a stream being created to the first volume change that reaches it: one subscription event and one info
+	// request on the mainloop thread, then one enumeration of the local copy on the next volume change
+	BENCHMARK(
+		"PulseAudio/stream_appears",
+		[](BenchmarkRun& run) {
+			run.StopTimer();
+			PulseAudioBackend backend;
+			SyntheticStreams  streams;
+			if(!backend.Initialize() || !streams.IsConnected()) {
+				run.AddMetric("server_unavailable", 1);
+				return;
+			}
+			const uint64_t enumerations = backend.EnumerationCount();
+
+			for(uint64_t i = 0; i < run.Iterations(); ++i) {
+				const VolumeTarget target{"", "bench-new-" + std::to_string(i)};
+				if(!streams.Add(target.applicationName)) { break; }
+				const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+				run.StartTimer();
+				while(!backend.SetVolume(target, 0.5f) && std::chrono::steady_clock::now() < deadline) {
+					std::this_thread::yield();
+				}
+				run.StopTimer();
+			}
+
+			run.AddMetric("session_enumerations_per_stream", static_cast<double>(backend.EnumerationCount() - enumerations) / run.Iterations());
+		},
+		20);
+} // namespace
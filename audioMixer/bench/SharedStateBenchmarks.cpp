@@ -0,0 +1,135 @@
+#include "Benchmark.h"
+#include "SharedStateWriter.h"
+
+#include <atomic>
+#include <string>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+	// Function to pick a segment name no other run uses
+	std::string BenchmarkSegmentName() { return "/audioMixerBench_state_" + std::to_string(getpid()); }
+
+	// Function to write one frame in which every channel has the same value, derived from the frame number
+	void WriteFrame(SharedStateWriter& writer, const uint64_t frame) {
+		const uint16_t value = static_cast<uint16_t>(frame % SharedState::NO_VALUE);
+		writer.BeginFrame();
+		for(size_t channel = 0; channel < SharedState::MAX_CHANNELS; ++channel) {
+			writer.SetChannel(channel, value, true);
+		}
+		writer.EndFrame(static_cast<uint32_t>(frame), SharedState::MAX_CHANNELS);
+	}
+
+	// Function to check that a snapshot is one whole frame: every channel holds the value of the frame it claims to be
+	bool IsConsistent(const SharedState::ChannelSnapshot& snapshot) {
+		const uint16_t value = static_cast<uint16_t>(snapshot.lastDeviceTimestampUs % SharedState::NO_VALUE);
+		if(snapshot.framesReceived != snapshot.lastDeviceTimestampUs || snapshot.updatesReceived != snapshot.framesReceived * SharedState::MAX_CHANNELS) {
+			return false;
+		}
+		for(size_t channel = 0; channel < SharedState::MAX_CHANNELS; ++channel) {
+			if(snapshot.value[channel] != value || snapshot.routedValue[channel] != value) { return false; }
+		}
+		return true;
+	}
+
+	struct ReaderResult {
+		uint64_t reads	  = 0;
+		uint64_t copies	  = 0; // Section copies, retries included
+		uint64_t torn	  = 0; // Snapshots mixing two frames; must stay 0
+		uint64_t failures = 0; // Reads that gave up because the writer kept the section busy
+	};
+
+	// Function to run in a separate process: map the segment read-only and take snapshots while the writer runs
+	ReaderResult ReadSnapshots(const std::string& name, const uint64_t count) {
+		ReaderResult						result;
+		SharedState::ChannelSnapshot		snapshot{};
+		const std::unique_ptr<SharedMemory> memory = OpenSharedMemory(name, sizeof(SharedState::Layout));
+		const SharedState::Layout*			layout = memory ? SharedState::ValidateSharedState(memory->Data(), memory->Size()) : nullptr;
+		if(!layout) {
+			result.failures = count;
+			return result;
+		}
+
+		uint64_t lastFrame = 0;
+		for(; result.reads < count; ++result.reads) {
+			const bool read = SharedState::ReadConsistent(layout->channels.sequence, [&] {
+				++result.copies;
+				snapshot.lastDeviceTimestampUs = layout->channels.lastDeviceTimestampUs.load(std::memory_order_relaxed);
+				snapshot.framesReceived		   = layout->channels.framesReceived.load(std::memory_order_relaxed);
+				snapshot.updatesReceived	   = layout->channels.updatesReceived.load(std::memory_order_relaxed);
+				SharedState::LoadArray(snapshot.value, layout->channels.value);
+				SharedState::LoadArray(snapshot.routedValue, layout->channels.routedValue);
+			});
+			if(!read) {
+				++result.failures;
+				continue;
+			}
+
+			// Frames only move forward
+			if(!IsConsistent(snapshot) || snapshot.framesReceived < lastFrame) { ++result.torn; }
+			lastFrame = snapshot.framesReceived;
+		}
+		return result;
+	}
+
+	// Cost of a consistent snapshot of the channel section while nothing writes it: a copy and two loads, no syscall
+	BENCHMARK("SharedState/read_channels_idle", [](BenchmarkRun& run) {
+		run.StopTimer();
+		std::unique_ptr<SharedStateWriter> writer = CreateSharedStateWriter(BenchmarkSegmentName());
+		if(!writer) { return; }
+		WriteFrame(*writer, 1);
+		SharedState::ChannelSnapshot snapshot{};
+		run.StartTimer();
+		for(uint64_t i = 0; i < run.Iterations(); ++i) {
+			DoNotOptimize(SharedState::ReadChannels(writer->Layout(), snapshot));
+		}
+		run.StopTimer();
+		run.AddMetric("consistent", IsConsistent(snapshot) ? 1.0 : 0.0);
+	});
+
+	// Reader/writer stress test: a writer thread rewrites every channel as fast as it can while a reader in another
+	// process, with its own read-only mapping, takes snapshots and checks that none of them mixes two frames
+	BENCHMARK("SharedState/seqlock_stress_cross_process", [](BenchmarkRun& run) {
+		run.StopTimer();
+		const std::string				   name	  = BenchmarkSegmentName();
+		std::unique_ptr<SharedStateWriter> writer = CreateSharedStateWriter(name);
+		if(!writer) { return; }
+		WriteFrame(*writer, 1);
+
+		// The reader reports back through a pipe; forked before the writer thread exists
+		int resultPipe[2];
+		if(pipe(resultPipe) != 0) { return; }
+		run.StartTimer();
+		const pid_t reader = fork();
+		if(reader == 0) {
+			close(resultPipe[0]);
+			const ReaderResult result = ReadSnapshots(name, run.Iterations());
+			_exit(write(resultPipe[1], &result, sizeof(result)) == sizeof(result) ? 0 : 1);
+		}
+		close(resultPipe[1]);
+
+		std::atomic<bool> keepWriting	= true;
+		uint64_t		  framesWritten = 1;
+
+		std::thread writerThread([&] {
+			while(keepWriting) {
+				WriteFrame(*writer, ++framesWritten);
+			}
+		});
+
+		ReaderResult result;
+		const bool	 received = reader > 0 && read(resultPipe[0], &result, sizeof(result)) == sizeof(result);
+		run.StopTimer();
+		keepWriting = false;
+		writerThread.join();
+		close(resultPipe[0]);
+		if(reader > 0) { waitpid(reader, nullptr, 0); }
+
+		run.AddMetric("reader_ok", received ? 1.0 : 0.0);
+		run.AddMetric("torn_reads", static_cast<double>(result.torn));
+		run.AddMetric("failed_reads", static_cast<double>(result.failures));
+		run.AddMetric("retries_per_read", result.reads ? static_cast<double>(result.copies - result.reads) / result.reads : 0.0);
+		run.AddMetric("frames_written", static_cast<double>(framesWritten));
+	});
+} // namespace
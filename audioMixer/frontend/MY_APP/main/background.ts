@@ -1,7 +1,7 @@
 import path from 'path'
 import { app, ipcMain } from 'electron'
 import serve from 'electron-serve'
-import { createWindow } from './helpers'
+import { connectMixer, createWindow } from './helpers'
 
 const isProd = process.env.NODE_ENV === 'production'
 
@@ -29,6 +29,8 @@ if (isProd) {
     await mainWindow.loadURL(`http://localhost:${port}/home`)
     mainWindow.webContents.openDevTools()
   }
+
+  connectMixer(mainWindow)
 })()
 
 app.on('window-all-closed', () => {
@@ -1 +1,2 @@
 export * from './create-window'
+export * from './mixer-client'
@@ -0,0 +1,169 @@
+import net from 'net'
+import os from 'os'
+import path from 'path'
+import { BrowserWindow, ipcMain } from 'electron'
+
+// Message format shared with the host, see audioMixer/ControlProtocol.h
+const HEADER_SIZE = 4
+const PROTOCOL_VERSION = 1
+const NO_VALUE = 0xffff
+const VOLUME_SCALE = 10000
+
+const SUBSCRIBE = 0x01
+const SET_VOLUME = 0x02
+const SNAPSHOT = 0x81
+const DELTA = 0x82
+
+const RECONNECT_DELAY_MS = 1000
+
+export type MixerApplication = {
+  name: string
+  channel: number | null // Pot channel, null if not bound
+  volume: number | null // 0 to 1, null until the host has set it
+}
+
+export type MixerState = {
+  connected: boolean
+  configGeneration: number
+  channels: (number | null)[] // Last pot value per channel (0 to 4095), null if not moved yet
+  applications: MixerApplication[]
+}
+
+// Same endpoint the host picks in DefaultLocalEndpoint()
+const defaultEndpoint = () => {
+  if (process.platform === 'win32') {
+    return '\\\\.\\pipe\\audioMixer'
+  }
+  if (process.env.XDG_RUNTIME_DIR) {
+    return path.join(process.env.XDG_RUNTIME_DIR, 'audioMixer.sock')
+  }
+  return path.join('/tmp', `audioMixer-${os.userInfo().uid}.sock`)
+}
+
+const encodeMessage = (type: number, payload: Buffer) => {
+  const header = Buffer.alloc(HEADER_SIZE)
+  header.writeUInt8(type, 0)
+  header.writeUIntLE(payload.length, 1, 3)
+  return Buffer.concat([header, payload])
+}
+
+const optional = (value: number) => (value === NO_VALUE ? null : value)
+
+// Keeps a subscription to the host open and forwards every state change to the window as 'mixer-state'. The renderer
+// sets volumes with ipc.send('mixer-set-volume', { application, volume }).
+export const connectMixer = (window: BrowserWindow, endpoint = defaultEndpoint()) => {
+  let state: MixerState = { connected: false, configGeneration: 0, channels: [], applications: [] }
+  let socket: net.Socket | null = null
+  let input = Buffer.alloc(0)
+  let stopped = false
+
+  const publish = () => {
+    if (!window.isDestroyed()) {
+      window.webContents.send('mixer-state', state)
+    }
+  }
+
+  const applySnapshot = (payload: Buffer) => {
+    const configGeneration = payload.readUInt32LE(1)
+    const channelCount = payload.readUInt16LE(5)
+    const applicationCount = payload.readUInt16LE(7)
+    let offset = 9
+    const channels: (number | null)[] = []
+    for (let i = 0; i < channelCount; ++i, offset += 2) {
+      channels.push(optional(payload.readUInt16LE(offset)))
+    }
+    const applications: MixerApplication[] = []
+    for (let i = 0; i < applicationCount; ++i) {
+      const channel = optional(payload.readUInt16LE(offset))
+      const volume = optional(payload.readUInt16LE(offset + 2))
+      const nameLength = payload.readUInt8(offset + 4)
+      const name = payload.toString('utf8', offset + 5, offset + 5 + nameLength)
+      applications.push({ name, channel, volume: volume === null ? null : volume / VOLUME_SCALE })
+      offset += 5 + nameLength
+    }
+    state = { connected: true, configGeneration, channels, applications }
+  }
+
+  const applyDelta = (payload: Buffer) => {
+    const channelEntries = payload.readUInt16LE(0)
+    const volumeEntries = payload.readUInt16LE(2)
+    const channels = [...state.channels]
+    const applications = [...state.applications]
+    let offset = 4
+    for (let i = 0; i < channelEntries + volumeEntries; ++i, offset += 4) {
+      const index = payload.readUInt16LE(offset)
+      const value = optional(payload.readUInt16LE(offset + 2))
+      if (i < channelEntries) {
+        channels[index] = value
+      } else if (index < applications.length) {
+        applications[index] = { ...applications[index], volume: value === null ? null : value / VOLUME_SCALE }
+      }
+    }
+    state = { ...state, channels, applications }
+  }
+
+  // One publish per chunk read, however many messages it held
+  const onData = (data: Buffer) => {
+    input = Buffer.concat([input, data])
+    let changed = false
+    while (input.length >= HEADER_SIZE) {
+      const size = input.readUIntLE(1, 3)
+      if (input.length < HEADER_SIZE + size) {
+        break
+      }
+      const type = input.readUInt8(0)
+      const payload = input.subarray(HEADER_SIZE, HEADER_SIZE + size)
+      if (type === SNAPSHOT) {
+        applySnapshot(payload)
+        changed = true
+      } else if (type === DELTA) {
+        applyDelta(payload)
+        changed = true
+      }
+      input = input.subarray(HEADER_SIZE + size)
+    }
+    if (changed) {
+      publish()
+    }
+  }
+
+  // The host may start after the frontend or restart with a new config, so keep trying
+  const connect = () => {
+    if (stopped) {
+      return
+    }
+    input = Buffer.alloc(0)
+    socket = net.connect(endpoint, () => {
+      socket?.write(encodeMessage(SUBSCRIBE, Buffer.from([PROTOCOL_VERSION])))
+    })
+    socket.on('data', onData)
+    socket.on('error', () => {})
+    socket.on('close', () => {
+      socket = null
+      if (state.connected) {
+        state = { ...state, connected: false }
+        publish()
+      }
+      setTimeout(connect, RECONNECT_DELAY_MS)
+    })
+  }
+
+  const onSetVolume = (_event: Electron.IpcMainEvent, arg: { application: number; volume: number }) => {
+    if (!socket || !state.connected) {
+      return
+    }
+    const payload = Buffer.alloc(4)
+    payload.writeUInt16LE(arg.application, 0)
+    payload.writeUInt16LE(Math.round(Math.min(Math.max(arg.volume, 0), 1) * VOLUME_SCALE), 2)
+    socket.write(encodeMessage(SET_VOLUME, payload))
+  }
+
+  ipcMain.on('mixer-set-volume', onSetVolume)
+  connect()
+
+  return () => {
+    stopped = true
+    ipcMain.removeListener('mixer-set-volume', onSetVolume)
+    socket?.destroy()
+  }
+}
@@ -1,16 +1,136 @@
-#include "esp_adc/adc_oneshot.h"
 #include "esp_system.h"
 #include "freertos/FreeRTOS.h"
+#include "freertos/message_buffer.h"
 #include "freertos/task.h"
-#include <driver/uart.h>
-#include <math.h>
+#include "mixer_protocol.h"
+#include "period_stats.h"
+#include "pot_filter.h"
+#include "tx_policy.h"
+#include "sdkconfig.h"
+#include <inttypes.h>
 #include <stdio.h>
+#include <string.h>
 
-// Define the number of potentiometers
+#if CONFIG_IDF_TARGET_LINUX
+	#include <stdlib.h>
+	#include <time.h>
+#else
+	#include "esp_adc/adc_continuous.h"
+	#include "esp_attr.h"
+	#include "esp_timer.h"
+	#include <driver/uart.h>
+#endif
+
+// Define the number of potentiometers (the host sizes its routing table from the frame, up to MIXER_MAX_CHANNELS)
 #define NUM_POTS 5
+_Static_assert(NUM_POTS <= MIXER_MAX_CHANNELS, "NUM_POTS exceeds the protocol's channel limit");
+
+#define ADC_MAX_VALUE  MIXER_VALUE_MAX // 12-bit resolution for ADC
+
+#define UART_PORT	   UART_NUM_0 // UART0 is typically connected to the USB-to-serial
+#define BAUD_RATE	   115200	  // Set the baud rate
+
+#define USE_UART	   0 // Set to 1 to send data over UART, 0 to print to console
+
+#define READ_LEN	   128			  // Bytes per DMA conversion frame; 3.2 ms at 20 kHz, so batches outpace the active frame rate
+#define MAX_SAMPLES	   (READ_LEN / 2) // ESP32 conversion results are 2 bytes each
+
+// Sampling and filtering run on one core, framing and transmitting on the other, so UART back-pressure or console
+// output never delays the next sample. The two tasks meet in a message buffer of sample batches.
+#if CONFIG_FREERTOS_UNICORE || CONFIG_IDF_TARGET_LINUX
+	#define SAMPLE_TASK_CORE tskNO_AFFINITY
+	#define TX_TASK_CORE	 tskNO_AFFINITY
+#else
+	#define SAMPLE_TASK_CORE APP_CPU_NUM // The DMA interrupt is allocated on the core that starts the ADC
+	#define TX_TASK_CORE	 PRO_CPU_NUM // Shares its core with the UART interrupt and the console
+#endif
+
+#define SAMPLE_TASK_PRIORITY (configMAX_PRIORITIES - 2)
+#define TX_TASK_PRIORITY	 5
+#define TASK_STACK_SIZE		 4096
+#define RING_BATCHES		 8 // Batches the transmit task may fall behind by before the sampling task drops them
+
+// Filter settings from menuconfig ("Audio Mixer")
+static const pot_filter_config_t filter_config = {
+	.window		= CONFIG_MIXER_OVERSAMPLE,
+	.hysteresis = CONFIG_MIXER_HYSTERESIS,
+};
+
+// Frame rate and idle decay from menuconfig ("Audio Mixer")
+static const tx_policy_config_t tx_config = {
+	.active_interval_ms	   = CONFIG_MIXER_ACTIVE_INTERVAL_MS,
+	.quiet_ms			   = CONFIG_MIXER_QUIET_MS,
+	.heartbeat_interval_ms = CONFIG_MIXER_HEARTBEAT_INTERVAL_MS,
+	.keyframe_interval_ms  = CONFIG_MIXER_KEYFRAME_INTERVAL_MS,
+	.motion_threshold	   = CONFIG_MIXER_MOTION_THRESHOLD,
+};
+
+// One DMA conversion frame after filtering, as handed from the sampling task to the transmit task
+typedef struct {
+	uint32_t	   sampled_at_us;
+	uint32_t	   ring_overruns; // Batches dropped so far because the ring was full
+	period_stats_t periods;		  // Sample periods measured since the last batch the transmit task received
+	uint16_t	   values[NUM_POTS];
+} sample_batch_t;
+
+static MessageBufferHandle_t sample_ring  = NULL;
+static volatile uint32_t	 adc_overruns = 0; // Conversion frames the ADC driver dropped because the sampling task was late
+
+// Microseconds on the board's clock; stamped into every frame so the host can measure latency from the sample onwards
+static uint32_t timestamp_us(void) {
+#if CONFIG_IDF_TARGET_LINUX
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)((uint64_t)ts.tv_sec * 1000000u + (uint64_t)ts.tv_nsec / 1000u);
+#else
+	return (uint32_t)esp_timer_get_time();
+#endif
+}
+
+// Milliseconds on the board's clock for the transmit policy; unlike timestamp_us it wraps only every ~49 days
+static uint32_t timestamp_ms(void) {
+#if CONFIG_IDF_TARGET_LINUX
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint32_t)((uint64_t)ts.tv_sec * 1000u + (uint64_t)ts.tv_nsec / 1000000u);
+#else
+	return (uint32_t)(esp_timer_get_time() / 1000);
+#endif
+}
+
+#if CONFIG_IDF_TARGET_LINUX
+// Host build: a sweep on every channel plus ADC-like noise stands in for the potentiometers. The knobs turn for
+// SIM_MOVE_MS out of every SIM_CYCLE_MS and rest in between, so both transmit modes get exercised.
+#define SIM_CYCLE_MS 8000
+#define SIM_MOVE_MS	 3000
 
+static void adc_start(void) {}
+
+// The simulated source delivers one batch per tick
+static uint32_t adc_batch_period_us(size_t count) {
+	(void)count;
+	return portTICK_PERIOD_MS * 1000u;
+}
+
+static size_t adc_read_samples(uint8_t* pots, uint16_t* samples, size_t max_samples) {
+	static uint32_t tick = 0;
+	vTaskDelay(1);
+	const uint32_t now_ms	 = timestamp_ms();
+	const uint32_t cycle_ms	 = now_ms % SIM_CYCLE_MS;
+	const uint32_t turned_ms = (now_ms / SIM_CYCLE_MS) * SIM_MOVE_MS + (cycle_ms < SIM_MOVE_MS ? cycle_ms : SIM_MOVE_MS); // One count per ms turned
+	for(size_t i = 0; i < max_samples; ++i, ++tick) {
+		const uint8_t  pot	 = (uint8_t)(tick % NUM_POTS);
+		const uint32_t phase = (turned_ms + pot * 800) % (2 * ADC_MAX_VALUE);
+		const int	   sweep = phase < ADC_MAX_VALUE ? (int)phase : (int)(2 * ADC_MAX_VALUE - phase);
+		const int	   noisy = sweep + (rand() % 33) - 16;
+		pots[i]				 = pot;
+		samples[i]			 = (uint16_t)(noisy < 0 ? 0 : (noisy > ADC_MAX_VALUE ? ADC_MAX_VALUE : noisy));
+	}
+	return max_samples;
+}
+#else
 // Define ADC channels for each potentiometer
-const adc_channel_t pot_adc_channels[NUM_POTS] = {
+static const adc_channel_t pot_adc_channels[NUM_POTS] = {
 	ADC_CHANNEL_0, // GPIO36
 	ADC_CHANNEL_3, // GPIO39
 	ADC_CHANNEL_6, // GPIO34
@@ -18,73 +138,225 @@ const adc_channel_t pot_adc_channels[NUM_POTS] = {
 	ADC_CHANNEL_4, // GPIO32
 };
 
-#define ADC_RESOLUTION 4096.0 // 12-bit resolution for ADC
+_Static_assert(sizeof(pot_adc_channels) / sizeof(pot_adc_channels[0]) == NUM_POTS, "one ADC channel per potentiometer");
 
-#define UART_PORT	   UART_NUM_0 // UART0 is typically connected to the USB-to-serial
-#define BAUD_RATE	   115200	  // Set the baud rate
+static adc_continuous_handle_t adc_handle = NULL;
+static int8_t				   pot_for_adc_channel[SOC_ADC_MAX_CHANNEL_NUM]; // ADC channel -> potentiometer index, -1 if unused
 
-#define USE_UART	   0 // Set to 1 to send data over UART, 0 to print to console
+// Called from the ADC interrupt when the driver's pool is full and a conversion frame is lost
+static bool IRAM_ATTR adc_on_pool_overflow(adc_continuous_handle_t handle, const adc_continuous_evt_data_t* data, void* user_data) {
+	++adc_overruns;
+	return false;
+}
 
-void app_main(void) {
-#if USE_UART
-	const uart_config_t uart_config = {
-		.baud_rate = BAUD_RATE,
-		.data_bits = UART_DATA_8_BITS,
-		.parity	   = UART_PARITY_DISABLE,
-		.stop_bits = UART_STOP_BITS_1,
-		.flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
+// Time the DMA takes to fill a conversion frame of count samples at the configured rate
+static uint32_t adc_batch_period_us(size_t count) { return (uint32_t)((uint64_t)count * 1000000u / CONFIG_MIXER_SAMPLE_FREQ_HZ); }
+
+// Start the continuous-mode (DMA) ADC cycling through every potentiometer channel
+static void adc_start(void) {
+	const adc_continuous_handle_cfg_t handle_config = {
+		.max_store_buf_size = 4 * READ_LEN,
+		.conv_frame_size	= READ_LEN,
 	};
-	uart_driver_install(UART_PORT, 256, 0, 0, NULL, 0); // Install UART driver
-	uart_param_config(UART_PORT, &uart_config);			// Configure UART
-#endif
+	ESP_ERROR_CHECK(adc_continuous_new_handle(&handle_config, &adc_handle));
+
+	memset(pot_for_adc_channel, -1, sizeof(pot_for_adc_channel));
+	for(int i = 0; i < NUM_POTS; ++i) {
+		pot_for_adc_channel[pot_adc_channels[i]] = (int8_t)i;
+	}
 
-	// ADC one-shot configuration
-	adc_oneshot_unit_handle_t		  adc2_handle;
-	const adc_oneshot_unit_init_cfg_t init_config = {
-		.unit_id = ADC_UNIT_1,				 // Use ADC2
-		.clk_src = ADC_DIGI_CLK_SRC_DEFAULT, // Default clock source
+	adc_digi_pattern_config_t pattern[NUM_POTS] = {0};
+	for(int i = 0; i < NUM_POTS; ++i) {
+		pattern[i].atten	 = ADC_ATTEN_DB_12; // 12 dB attenuation to read voltages up to ~3.9V
+		pattern[i].channel	 = pot_adc_channels[i] & 0x7;
+		pattern[i].unit		 = ADC_UNIT_1;
+		pattern[i].bit_width = SOC_ADC_DIGI_MAX_BITWIDTH; // 12-bit width (0 to 4095)
+	}
+
+	const adc_continuous_config_t adc_config = {
+		.sample_freq_hz = CONFIG_MIXER_SAMPLE_FREQ_HZ,
+		.conv_mode		= ADC_CONV_SINGLE_UNIT_1,
+		.format			= ADC_DIGI_OUTPUT_FORMAT_TYPE1,
+		.pattern_num	= NUM_POTS,
+		.adc_pattern	= pattern,
 	};
-	adc_oneshot_new_unit(&init_config, &adc2_handle);
+	ESP_ERROR_CHECK(adc_continuous_config(adc_handle, &adc_config));
 
-	// Configure all potentiometer ADC channels
-	const adc_oneshot_chan_cfg_t channel_config = {
-		.atten	  = ADC_ATTEN_DB_12,	 // 12 dB attenuation to read voltages up to ~3.9V
-		.bitwidth = ADC_BITWIDTH_DEFAULT // 12-bit width (0 to 4095)
+	const adc_continuous_evt_cbs_t callbacks = {
+		.on_pool_ovf = adc_on_pool_overflow,
 	};
+	ESP_ERROR_CHECK(adc_continuous_register_event_callbacks(adc_handle, &callbacks, NULL));
+	ESP_ERROR_CHECK(adc_continuous_start(adc_handle));
+}
 
+// Block until the DMA has a conversion frame ready and unpack it into (pot, raw sample) pairs
+static size_t adc_read_samples(uint8_t* pots, uint16_t* samples, size_t max_samples) {
+	uint8_t	 result[READ_LEN];
+	uint32_t bytes_read = 0;
+	if(adc_continuous_read(adc_handle, result, READ_LEN, &bytes_read, portMAX_DELAY) != ESP_OK) return 0;
+
+	size_t count = 0;
+	for(uint32_t i = 0; i + SOC_ADC_DIGI_RESULT_BYTES <= bytes_read && count < max_samples; i += SOC_ADC_DIGI_RESULT_BYTES) {
+		const adc_digi_output_data_t* data = (const adc_digi_output_data_t*)&result[i];
+		if(data->type1.channel >= SOC_ADC_MAX_CHANNEL_NUM || pot_for_adc_channel[data->type1.channel] < 0) continue;
+		pots[count]	   = (uint8_t)pot_for_adc_channel[data->type1.channel];
+		samples[count] = data->type1.data;
+		++count;
+	}
+	return count;
+}
+#endif
+
+// Sampling task: read conversion frames as the DMA completes them, filter them and pass each batch on without waiting
+static void sample_task(void* arg) {
+	pot_filter_channel_t filters[NUM_POTS];
 	for(int i = 0; i < NUM_POTS; ++i) {
-		adc_oneshot_config_channel(adc2_handle, pot_adc_channels[i], &channel_config);
+		pot_filter_init(&filters[i]);
 	}
 
+	adc_start();
+
+	sample_batch_t batch = {0};
+	period_stats_reset(&batch.periods);
+	uint32_t last_sampled_at = 0;
+	bool	 have_sampled	 = false;
+
 	while(1) {
-		int adc_raw[NUM_POTS] = {0};
+		uint8_t		   pots[MAX_SAMPLES];
+		uint16_t	   samples[MAX_SAMPLES];
+		const size_t   count	  = adc_read_samples(pots, samples, MAX_SAMPLES);
+		const uint32_t sampled_at = timestamp_us(); // The DMA frame has just completed, so this is when its newest sample was taken
+		if(count == 0) continue;
 
-		// Read ADC values for each potentiometer
-		for(int i = 0; i < NUM_POTS; ++i) {
-			adc_oneshot_read(adc2_handle, pot_adc_channels[i], &adc_raw[i]);
+		if(have_sampled) period_stats_add(&batch.periods, sampled_at - last_sampled_at, adc_batch_period_us(count));
+		last_sampled_at = sampled_at;
+		have_sampled	= true;
+
+		// Oversample and filter; hysteresis keeps a still pot from reporting a change
+		for(size_t i = 0; i < count; ++i) {
+			pot_filter_push(&filters[pots[i]], &filter_config, samples[i]);
 		}
 
-		// Convert the ADC values to percentages (8-bit values ranging from 0 to 100)
-		uint8_t percentages[NUM_POTS] = {0};
+		// Wait until every channel's average window has filled before the first batch
+		bool ready = true;
 		for(int i = 0; i < NUM_POTS; ++i) {
-			percentages[i] = (uint8_t)ceil((adc_raw[i] / ADC_RESOLUTION) * 100);
+			ready = ready && filters[i].has_output;
 		}
+		if(!ready) continue;
 
-#if(!USE_UART)
-		printf("\nPotentiometer values: ");
+		batch.sampled_at_us = sampled_at;
 		for(int i = 0; i < NUM_POTS; ++i) {
-			printf("%d ", percentages[i]);
+			batch.values[i] = pot_filter_output(&filters[i]);
+		}
+
+		// Never block on the transmit task. A dropped batch only costs a frame: its values and periods go with the next one.
+		if(xMessageBufferSend(sample_ring, &batch, sizeof(batch), 0) != sizeof(batch)) {
+			++batch.ring_overruns;
+			continue;
 		}
+		period_stats_reset(&batch.periods);
+	}
+}
+
+// Function to put a frame on the wire (or nowhere, when the values are printed to the console instead)
+static void send_frame(const uint8_t* frame, size_t frame_size) {
+#if USE_UART
+	// Send the framed packet over UART (which will appear as serial data over USB)
+	uart_write_bytes(UART_PORT, (const char*)frame, frame_size);
+#else
+	(void)frame;
+	(void)frame_size;
 #endif
+}
 
+// Transmit task: turn batches into frames and send them; the only task that writes to the UART or the console
+static void tx_task(void* arg) {
 #if USE_UART
-		// Send binary data over UART (which will appear as serial data over USB)
-		uart_write_bytes(UART_PORT, (const char*)percentages, NUM_POTS);
+	const uart_config_t uart_config = {
+		.baud_rate = BAUD_RATE,
+		.data_bits = UART_DATA_8_BITS,
+		.parity	   = UART_PARITY_DISABLE,
+		.stop_bits = UART_STOP_BITS_1,
+		.flow_ctrl = UART_HW_FLOWCTRL_DISABLE,
+	};
+	uart_driver_install(UART_PORT, 256, 0, 0, NULL, 0); // Install UART driver
+	uart_param_config(UART_PORT, &uart_config);			// Configure UART
+#endif
+
+	tx_policy_t	   policy;
+	uint32_t	   last_stats	 = timestamp_ms();
+	uint8_t		   sequence		 = 0;
+	uint32_t	   ring_overruns = 0;
+	period_stats_t periods; // Sample periods since the last stats frame
+	tx_policy_init(&policy, NUM_POTS);
+	period_stats_reset(&periods);
+
+	while(1) {
+		sample_batch_t batch;
+		if(xMessageBufferReceive(sample_ring, &batch, sizeof(batch), portMAX_DELAY) != sizeof(batch)) continue;
+		period_stats_merge(&periods, &batch.periods);
+		ring_overruns = batch.ring_overruns;
+
+		// The policy picks the frame: fast while a pot moves, only heartbeats once everything has been still for a while
+		const uint32_t	now = timestamp_ms();
+		uint8_t			changed_channels[NUM_POTS];
+		uint16_t		changed_values[NUM_POTS];
+		uint8_t			changed_count = 0;
+		const tx_send_t send		  = tx_policy_update(&policy, &tx_config, now, batch.values, changed_channels, changed_values, &changed_count);
+
+		uint8_t			frame[MIXER_MAX_FRAME_SIZE];
+		size_t			frame_size = 0;
+		switch(send) {
+			case TX_SEND_FULL: frame_size = mixer_encode_full(frame, sequence++, batch.sampled_at_us, changed_values, changed_count); break;
+			case TX_SEND_DELTA: frame_size = mixer_encode_delta(frame, sequence++, batch.sampled_at_us, changed_channels, changed_values, changed_count); break;
+			case TX_SEND_HEARTBEAT: frame_size = mixer_encode_heartbeat(frame, sequence++, batch.sampled_at_us); break;
+			case TX_SEND_NONE: break;
+		}
+		if(frame_size > 0) {
+			send_frame(frame, frame_size);
+#if(!USE_UART)
+			printf("\nPotentiometer values (frame type %d, %s): ", frame[MIXER_OFFSET_TYPE], policy.mode == TX_POLICY_ACTIVE ? "active" : "idle");
+			for(int i = 0; i < NUM_POTS; ++i) {
+				printf("%d ", policy.sent[i]);
+			}
+#endif
+		}
+
+		// Report overruns and how regularly the samples arrived
+		if(now - last_stats >= CONFIG_MIXER_STATS_INTERVAL_MS) {
+			uint32_t stats[MIXER_STAT_COUNT];
+			stats[MIXER_STAT_ADC_OVERRUNS]	= adc_overruns;
+			stats[MIXER_STAT_RING_OVERRUNS] = ring_overruns;
+			period_stats_fill(&periods, stats);
+			frame_size = mixer_encode_stats(frame, sequence++, batch.sampled_at_us, stats, MIXER_STAT_COUNT);
+			send_frame(frame, frame_size);
+			period_stats_reset(&periods);
+			last_stats = now;
+#if(!USE_UART)
+			printf("\nPipeline: %" PRIu32 " ADC overruns, %" PRIu32 " ring overruns, period %" PRIu32 " us (jitter mean %" PRIu32 " us, max %" PRIu32
+				   " us) over %" PRIu32 " batches",
+				   stats[MIXER_STAT_ADC_OVERRUNS], stats[MIXER_STAT_RING_OVERRUNS], stats[MIXER_STAT_PERIOD_MEAN_US], stats[MIXER_STAT_JITTER_MEAN_US],
+				   stats[MIXER_STAT_JITTER_MAX_US], stats[MIXER_STAT_BATCHES]);
 #endif
-		// Wait for 500 ms before reading again
-		vTaskDelay(500 / portTICK_PERIOD_MS);
+		}
 	}
+}
+
+// Function to start a task on the given core (the linux target has no core affinity)
+static void start_task(TaskFunction_t function, const char* name, UBaseType_t priority, BaseType_t core) {
+#if CONFIG_IDF_TARGET_LINUX
+	(void)core;
+	xTaskCreate(function, name, TASK_STACK_SIZE, NULL, priority, NULL);
+#else
+	xTaskCreatePinnedToCore(function, name, TASK_STACK_SIZE, NULL, priority, NULL, core);
+#endif
+}
+
+void app_main(void) {
+	// Each message carries a length word in front of the batch
+	sample_ring = xMessageBufferCreate(RING_BATCHES * (sizeof(sample_batch_t) + sizeof(size_t)));
+	configASSERT(sample_ring != NULL);
 
-	// Clean up ADC after usage
-	adc_oneshot_del_unit(adc2_handle);
+	start_task(tx_task, "mixer_tx", TX_TASK_PRIORITY, TX_TASK_CORE);
+	start_task(sample_task, "mixer_sample", SAMPLE_TASK_PRIORITY, SAMPLE_TASK_CORE);
 }
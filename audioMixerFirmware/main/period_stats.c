@@ -0,0 +1,29 @@
+#include "period_stats.h"
+
+#include "mixer_protocol.h"
+
+#include <string.h>
+
+void period_stats_reset(period_stats_t* stats) { memset(stats, 0, sizeof(*stats)); }
+
+void period_stats_add(period_stats_t* stats, uint32_t period_us, uint32_t nominal_us) {
+	const uint32_t jitter = period_us > nominal_us ? period_us - nominal_us : nominal_us - period_us;
+	++stats->batches;
+	stats->period_sum_us += period_us;
+	stats->jitter_sum_us += jitter;
+	if(jitter > stats->jitter_max_us) stats->jitter_max_us = jitter;
+}
+
+void period_stats_merge(period_stats_t* into, const period_stats_t* from) {
+	into->batches += from->batches;
+	into->period_sum_us += from->period_sum_us;
+	into->jitter_sum_us += from->jitter_sum_us;
+	if(from->jitter_max_us > into->jitter_max_us) into->jitter_max_us = from->jitter_max_us;
+}
+
+void period_stats_fill(const period_stats_t* stats, uint32_t* counters) {
+	counters[MIXER_STAT_BATCHES]		= stats->batches;
+	counters[MIXER_STAT_PERIOD_MEAN_US] = stats->batches ? (uint32_t)(stats->period_sum_us / stats->batches) : 0;
+	counters[MIXER_STAT_JITTER_MEAN_US] = stats->batches ? (uint32_t)(stats->jitter_sum_us / stats->batches) : 0;
+	counters[MIXER_STAT_JITTER_MAX_US]	= stats->jitter_max_us;
+}
@@ -0,0 +1,34 @@
+// Sample-period statistics: how regularly sample batches arrive compared with the nominal rate.
+// Plain C with no ESP-IDF dependencies so it builds for the linux target and on a desktop compiler.
+#ifndef PERIOD_STATS_H
+#define PERIOD_STATS_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+	uint32_t batches;		// Periods measured
+	uint64_t period_sum_us; // Sum of the measured periods
+	uint64_t jitter_sum_us; // Sum of |measured - nominal|
+	uint32_t jitter_max_us;
+} period_stats_t;
+
+void period_stats_reset(period_stats_t* stats);
+
+// Record one period between two batches against the period the configured rate gives for that batch
+void period_stats_add(period_stats_t* stats, uint32_t period_us, uint32_t nominal_us);
+
+// Add the periods recorded in from to into
+void period_stats_merge(period_stats_t* into, const period_stats_t* from);
+
+// Write MIXER_STAT_BATCHES and the period and jitter figures of a stats frame (see mixer_stat_t)
+void period_stats_fill(const period_stats_t* stats, uint32_t* counters);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // PERIOD_STATS_H
@@ -0,0 +1,65 @@
+#include "pot_filter.h"
+#include "mixer_protocol.h"
+
+#include <string.h>
+
+void pot_filter_init(pot_filter_channel_t* channel) { memset(channel, 0, sizeof(*channel)); }
+
+bool pot_filter_push(pot_filter_channel_t* channel, const pot_filter_config_t* config, uint16_t sample) {
+	uint16_t window = config->window;
+	if(window == 0) window = 1;
+	if(window > POT_FILTER_MAX_WINDOW) window = POT_FILTER_MAX_WINDOW;
+
+	// Moving average over the last `window` samples
+	if(channel->count == window) {
+		channel->sum -= channel->ring[channel->head];
+	} else {
+		++channel->count;
+	}
+	channel->ring[channel->head] = sample;
+	channel->sum += sample;
+	channel->head = (uint16_t)((channel->head + 1) % window);
+
+	// Hold off until the ring is full so start-up noise is not reported
+	if(channel->count < window) return false;
+
+	const uint16_t average = (uint16_t)((channel->sum + window / 2) / window);
+
+	// Snap to the rails: the deadband alone would hold a pot turned all the way down or up `hysteresis` counts short of them
+	int rail = -1;
+	if(average <= config->hysteresis) {
+		rail = 0;
+	} else if(average >= MIXER_VALUE_MAX - config->hysteresis) {
+		rail = MIXER_VALUE_MAX;
+	}
+	if(rail >= 0) {
+		if(channel->has_output && channel->output == rail) return false;
+		channel->output		= (uint16_t)rail;
+		channel->has_output = true;
+		return true;
+	}
+
+	if(!channel->has_output) {
+		channel->output		= average;
+		channel->has_output = true;
+		return true;
+	}
+
+	// Deadband: only follow the average once it leaves output +/- hysteresis. On a rail it is measured from the edge of the
+	// snap zone, so noise at that edge cannot flicker between the rail and the value next to it.
+	int reference = channel->output;
+	if(reference == 0) {
+		reference = config->hysteresis;
+	} else if(reference == MIXER_VALUE_MAX) {
+		reference = MIXER_VALUE_MAX - config->hysteresis;
+	}
+	const int delta = (int)average - reference;
+	if(delta > (int)config->hysteresis) {
+		channel->output = (uint16_t)(average - config->hysteresis);
+	} else if(delta < -(int)config->hysteresis) {
+		channel->output = (uint16_t)(average + config->hysteresis);
+	} else {
+		return false;
+	}
+	return true;
+}
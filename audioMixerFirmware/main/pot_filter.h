@@ -0,0 +1,41 @@
+// Oversampling + hysteresis filter for potentiometer readings.
+// Plain C with no ESP-IDF dependencies so it builds for the linux target and on a desktop compiler.
+#ifndef POT_FILTER_H
+#define POT_FILTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define POT_FILTER_MAX_WINDOW 64
+
+typedef struct {
+	uint16_t window;	 // Samples averaged per channel (1 to POT_FILTER_MAX_WINDOW)
+	uint16_t hysteresis; // Raw counts the average must move away from the current output before it changes
+} pot_filter_config_t;
+
+typedef struct {
+	uint16_t ring[POT_FILTER_MAX_WINDOW]; // Last `window` raw samples
+	uint32_t sum;						  // Running sum of the ring
+	uint16_t head;
+	uint16_t count;
+	uint16_t output; // Filtered value reported to the caller
+	bool	 has_output;
+} pot_filter_channel_t;
+
+void pot_filter_init(pot_filter_channel_t* channel);
+
+// Push one raw sample. Returns true when the filtered output moved. An average within hysteresis of 0 or MIXER_VALUE_MAX
+// snaps the output to that end, so a pot turned all the way reports it.
+bool pot_filter_push(pot_filter_channel_t* channel, const pot_filter_config_t* config, uint16_t sample);
+
+static inline uint16_t pot_filter_output(const pot_filter_channel_t* channel) { return channel->output; }
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // POT_FILTER_H
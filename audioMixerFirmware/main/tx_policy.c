@@ -0,0 +1,68 @@
+#include "tx_policy.h"
+
+#include <string.h>
+
+void tx_policy_init(tx_policy_t* policy, uint8_t channel_count) {
+	memset(policy, 0, sizeof(*policy));
+	policy->channel_count = channel_count > MIXER_MAX_CHANNELS ? MIXER_MAX_CHANNELS : channel_count;
+	policy->mode		  = TX_POLICY_IDLE;
+	policy->keyframe_due  = true;
+}
+
+tx_send_t tx_policy_update(tx_policy_t* policy, const tx_policy_config_t* config, uint32_t now_ms, const uint16_t* values, uint8_t* changed_channels,
+						   uint16_t* changed_values, uint8_t* changed_count) {
+	*changed_count = 0;
+
+	// How far the values have moved from what the host has
+	uint8_t	 pending	  = 0;
+	uint16_t largest_move = 0;
+	for(uint8_t i = 0; i < policy->channel_count; ++i) {
+		const uint16_t move = values[i] > policy->sent[i] ? values[i] - policy->sent[i] : policy->sent[i] - values[i];
+		if(move == 0) continue;
+		++pending;
+		if(move > largest_move) largest_move = move;
+	}
+	if(pending > 0) policy->last_change_ms = now_ms;
+
+	// Wake on a move big enough not to be noise, decay once everything has been still for the quiet period
+	if(policy->mode == TX_POLICY_IDLE && pending > 0 && largest_move >= config->motion_threshold) {
+		policy->mode = TX_POLICY_ACTIVE;
+	} else if(policy->mode == TX_POLICY_ACTIVE && now_ms - policy->last_change_ms >= config->quiet_ms) {
+		policy->mode = TX_POLICY_IDLE;
+	}
+
+	// Keyframe periodically; while active, a delta as soon as the rate allows; otherwise whatever is pending (or a bare
+	// heartbeat) once the line has been quiet for the heartbeat interval
+	const uint32_t since_frame = now_ms - policy->last_frame_ms;
+	tx_send_t	   send		   = TX_SEND_NONE;
+	if(policy->keyframe_due || now_ms - policy->last_keyframe_ms >= config->keyframe_interval_ms) {
+		send = TX_SEND_FULL;
+	} else if(pending > 0 && policy->mode == TX_POLICY_ACTIVE && since_frame >= config->active_interval_ms) {
+		send = TX_SEND_DELTA;
+	} else if(since_frame >= config->heartbeat_interval_ms) {
+		send = pending > 0 ? TX_SEND_DELTA : TX_SEND_HEARTBEAT;
+	}
+
+	if(send == TX_SEND_FULL) {
+		memcpy(policy->sent, values, policy->channel_count * sizeof(values[0]));
+		memcpy(changed_values, values, policy->channel_count * sizeof(values[0]));
+		*changed_count			 = policy->channel_count;
+		policy->keyframe_due	 = false;
+		policy->last_keyframe_ms = now_ms;
+	} else if(send == TX_SEND_DELTA) {
+		for(uint8_t i = 0; i < policy->channel_count; ++i) {
+			if(values[i] == policy->sent[i]) continue;
+			changed_channels[*changed_count] = i;
+			changed_values[*changed_count]	 = values[i];
+			policy->sent[i]					 = values[i];
+			++*changed_count;
+		}
+	}
+	if(send == TX_SEND_NONE) return send;
+
+	// Deltas while active are paced on a fixed grid rather than from the batch that carried the last one, so batches
+	// that do not divide the interval still give the configured rate on average
+	const bool on_grid	  = send == TX_SEND_DELTA && policy->mode == TX_POLICY_ACTIVE && since_frame < 2 * config->active_interval_ms;
+	policy->last_frame_ms = on_grid ? policy->last_frame_ms + config->active_interval_ms : now_ms;
+	return send;
+}
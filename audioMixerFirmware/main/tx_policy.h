@@ -0,0 +1,60 @@
+// Transmit policy: decides per sample batch whether to send a full frame, a delta, a heartbeat or nothing.
+// While a pot is moving the link runs at a high frame rate; once every pot has been still for the quiet period it decays
+// to idle, where a pot has to move further to wake it and only the heartbeat (carrying any small change) is sent.
+// Plain C with no ESP-IDF dependencies so it builds for the linux target and on a desktop compiler.
+#ifndef TX_POLICY_H
+#define TX_POLICY_H
+
+#include "mixer_protocol.h"
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+	uint32_t active_interval_ms;	// Minimum time between frames while a pot is moving
+	uint32_t quiet_ms;				// Time without any change after which the link goes idle
+	uint32_t heartbeat_interval_ms; // Time without any frame after which a heartbeat is sent
+	uint32_t keyframe_interval_ms;	// Time between full frames
+	uint16_t motion_threshold;		// Counts a pot has to move from its last sent value to wake an idle link
+} tx_policy_config_t;
+
+typedef enum {
+	TX_POLICY_IDLE	 = 0,
+	TX_POLICY_ACTIVE = 1,
+} tx_policy_mode_t;
+
+typedef enum {
+	TX_SEND_NONE	  = 0,
+	TX_SEND_FULL	  = 1,
+	TX_SEND_DELTA	  = 2,
+	TX_SEND_HEARTBEAT = 3,
+} tx_send_t;
+
+typedef struct {
+	uint16_t		 sent[MIXER_MAX_CHANNELS]; // Values the host has been told about
+	uint8_t			 channel_count;
+	tx_policy_mode_t mode;
+	bool			 keyframe_due;
+	uint32_t		 last_frame_ms;
+	uint32_t		 last_keyframe_ms;
+	uint32_t		 last_change_ms; // When a value last differed from the sent one
+} tx_policy_t;
+
+// The first update always sends a full frame
+void tx_policy_init(tx_policy_t* policy, uint8_t channel_count);
+
+// Offer the latest filtered values at now_ms (a millisecond clock that may wrap). Returns what to send; for a delta the
+// channels that changed are written to changed_channels/changed_values, for a full frame every value to changed_values.
+// The policy then treats the returned values as sent.
+tx_send_t tx_policy_update(tx_policy_t* policy, const tx_policy_config_t* config, uint32_t now_ms, const uint16_t* values, uint8_t* changed_channels,
+						   uint16_t* changed_values, uint8_t* changed_count);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // TX_POLICY_H
@@ -0,0 +1,182 @@
+// Wire format shared by the mixer firmware and the host controller.
+//
+// Every frame on the serial line looks like this:
+//
+//   offset  size  field
+//   0       2     sync marker (0xA5 0x5A)
+//   2       1     protocol version
+//   3       1     length: number of bytes from the sequence number to the end of the payload
+//   4       1     sequence number (increments by one per frame, wraps at 255)
+//   5       1     frame type (mixer_frame_type_t)
+//   6       1     count: channels in a full frame, (channel, value) pairs in a delta frame, 0 for a heartbeat
+//   7       4     device timestamp: microseconds on the board's clock when the frame's samples were taken, little-endian, wraps
+//   11      n     payload
+//   11+n    2     CRC-16/CCITT-FALSE over version..payload, little-endian
+//
+// Channel values are 12-bit ADC readings (0 to MIXER_VALUE_MAX), sent as little-endian uint16.
+//   full:      value[count]                     - every channel, sent periodically so the host can recover its state
+//   delta:     { channel u8, value u16 }[count] - only the channels that moved
+//   heartbeat: no payload                        - sent while idle so the host knows the board is alive
+//   stats:     counter u32[count]               - board health (mixer_stat_t), sent periodically; count may grow
+//                                                 in later firmware, so receivers ignore counters they do not know
+//
+// A receiver that loses bytes looks for the next sync marker and checks the CRC, so it is back in step within one frame.
+#ifndef MIXER_PROTOCOL_H
+#define MIXER_PROTOCOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define MIXER_SYNC_0			  0xA5
+#define MIXER_SYNC_1			  0x5A
+#define MIXER_PROTOCOL_VERSION	  3
+
+#define MIXER_MAX_CHANNELS		  32
+#define MIXER_VALUE_MAX			  4095 // 12-bit channel values
+
+#define MIXER_HEADER_SIZE		  11 // Sync, version, length, sequence, type, count, timestamp
+#define MIXER_CRC_SIZE			  2
+#define MIXER_FULL_ENTRY_SIZE	  2
+#define MIXER_DELTA_ENTRY_SIZE	  3
+#define MIXER_STATS_ENTRY_SIZE	  4
+#define MIXER_MAX_STATS			  16
+#define MIXER_MAX_PAYLOAD_SIZE	  (MIXER_MAX_CHANNELS * MIXER_DELTA_ENTRY_SIZE)
+#define MIXER_MAX_FRAME_SIZE	  (MIXER_HEADER_SIZE + MIXER_MAX_PAYLOAD_SIZE + MIXER_CRC_SIZE)
+
+// Offsets into a frame
+#define MIXER_OFFSET_VERSION	  2
+#define MIXER_OFFSET_LENGTH		  3
+#define MIXER_OFFSET_SEQUENCE	  4
+#define MIXER_OFFSET_TYPE		  5
+#define MIXER_OFFSET_COUNT		  6
+#define MIXER_OFFSET_TIMESTAMP	  7
+#define MIXER_OFFSET_PAYLOAD	  11
+
+// Bytes counted by the length field besides the payload (sequence, type, count, timestamp)
+#define MIXER_LENGTH_HEADER_BYTES 7
+
+typedef enum {
+	MIXER_FRAME_FULL	  = 0,
+	MIXER_FRAME_DELTA	  = 1,
+	MIXER_FRAME_HEARTBEAT = 2,
+	MIXER_FRAME_STATS	  = 3,
+} mixer_frame_type_t;
+
+// Counters of a stats frame, in payload order. Overrun counts are totals since boot; the period figures cover the
+// batches since the previous stats frame.
+typedef enum {
+	MIXER_STAT_ADC_OVERRUNS	  = 0, // DMA conversion frames the ADC driver dropped because the sampling task was late
+	MIXER_STAT_RING_OVERRUNS  = 1, // Sample batches dropped because the transmit task had fallen behind
+	MIXER_STAT_BATCHES		  = 2, // Sample batches measured for the period figures below
+	MIXER_STAT_PERIOD_MEAN_US = 3, // Mean time between sample batches
+	MIXER_STAT_JITTER_MEAN_US = 4, // Mean deviation of that time from the nominal batch period
+	MIXER_STAT_JITTER_MAX_US  = 5, // Largest deviation
+	MIXER_STAT_COUNT		  = 6,
+} mixer_stat_t;
+
+// CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF)
+static inline uint16_t mixer_crc16(const uint8_t* data, size_t size) {
+	uint16_t crc = 0xFFFF;
+	for(size_t i = 0; i < size; ++i) {
+		crc ^= (uint16_t)(data[i] << 8);
+		for(int bit = 0; bit < 8; ++bit) {
+			crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+		}
+	}
+	return crc;
+}
+
+// Payload size a frame of the given type and count must have, or -1 if the combination is invalid
+static inline int mixer_payload_size(uint8_t type, uint8_t count) {
+	if(count > MIXER_MAX_CHANNELS) return -1;
+	switch(type) {
+		case MIXER_FRAME_FULL: return count * MIXER_FULL_ENTRY_SIZE;
+		case MIXER_FRAME_DELTA: return count * MIXER_DELTA_ENTRY_SIZE;
+		case MIXER_FRAME_HEARTBEAT: return count == 0 ? 0 : -1;
+		case MIXER_FRAME_STATS: return count <= MIXER_MAX_STATS ? count * MIXER_STATS_ENTRY_SIZE : -1;
+		default: return -1;
+	}
+}
+
+// Fill in the header and CRC around a payload already written at MIXER_OFFSET_PAYLOAD. Returns the frame size.
+static inline size_t mixer_finish_frame(uint8_t* out, uint8_t sequence, uint8_t type, uint8_t count, uint32_t timestamp_us, size_t payload_size) {
+	out[0]							= MIXER_SYNC_0;
+	out[1]							= MIXER_SYNC_1;
+	out[MIXER_OFFSET_VERSION]		= MIXER_PROTOCOL_VERSION;
+	out[MIXER_OFFSET_LENGTH]		= (uint8_t)(MIXER_LENGTH_HEADER_BYTES + payload_size);
+	out[MIXER_OFFSET_SEQUENCE]		= sequence;
+	out[MIXER_OFFSET_TYPE]			= type;
+	out[MIXER_OFFSET_COUNT]			= count;
+	out[MIXER_OFFSET_TIMESTAMP]		= (uint8_t)(timestamp_us & 0xFF);
+	out[MIXER_OFFSET_TIMESTAMP + 1] = (uint8_t)((timestamp_us >> 8) & 0xFF);
+	out[MIXER_OFFSET_TIMESTAMP + 2] = (uint8_t)((timestamp_us >> 16) & 0xFF);
+	out[MIXER_OFFSET_TIMESTAMP + 3] = (uint8_t)(timestamp_us >> 24);
+
+	const size_t   crc_offset = MIXER_OFFSET_PAYLOAD + payload_size;
+	const uint16_t crc		  = mixer_crc16(out + MIXER_OFFSET_VERSION, crc_offset - MIXER_OFFSET_VERSION);
+	out[crc_offset]			  = (uint8_t)(crc & 0xFF);
+	out[crc_offset + 1]		  = (uint8_t)(crc >> 8);
+	return crc_offset + MIXER_CRC_SIZE;
+}
+
+// Encode a full frame with every channel into out (at least MIXER_MAX_FRAME_SIZE bytes). Returns the frame size, or 0 if
+// channel_count is too large.
+static inline size_t mixer_encode_full(uint8_t* out, uint8_t sequence, uint32_t timestamp_us, const uint16_t* values, uint8_t channel_count) {
+	if(channel_count > MIXER_MAX_CHANNELS) return 0;
+
+	uint8_t* payload = out + MIXER_OFFSET_PAYLOAD;
+	for(uint8_t i = 0; i < channel_count; ++i) {
+		payload[i * MIXER_FULL_ENTRY_SIZE]	   = (uint8_t)(values[i] & 0xFF);
+		payload[i * MIXER_FULL_ENTRY_SIZE + 1] = (uint8_t)(values[i] >> 8);
+	}
+	return mixer_finish_frame(out, sequence, MIXER_FRAME_FULL, channel_count, timestamp_us, (size_t)channel_count * MIXER_FULL_ENTRY_SIZE);
+}
+
+// Encode a delta frame carrying only the given (channel, value) pairs. Returns the frame size, or 0 if count is too large.
+static inline size_t mixer_encode_delta(uint8_t* out, uint8_t sequence, uint32_t timestamp_us, const uint8_t* channels, const uint16_t* values, uint8_t count) {
+	if(count > MIXER_MAX_CHANNELS) return 0;
+
+	uint8_t* payload = out + MIXER_OFFSET_PAYLOAD;
+	for(uint8_t i = 0; i < count; ++i) {
+		payload[i * MIXER_DELTA_ENTRY_SIZE]		= channels[i];
+		payload[i * MIXER_DELTA_ENTRY_SIZE + 1] = (uint8_t)(values[i] & 0xFF);
+		payload[i * MIXER_DELTA_ENTRY_SIZE + 2] = (uint8_t)(values[i] >> 8);
+	}
+	return mixer_finish_frame(out, sequence, MIXER_FRAME_DELTA, count, timestamp_us, (size_t)count * MIXER_DELTA_ENTRY_SIZE);
+}
+
+// Encode an empty heartbeat frame. Returns the frame size.
+static inline size_t mixer_encode_heartbeat(uint8_t* out, uint8_t sequence, uint32_t timestamp_us) {
+	return mixer_finish_frame(out, sequence, MIXER_FRAME_HEARTBEAT, 0, timestamp_us, 0);
+}
+
+// Encode a stats frame carrying count counters (MIXER_STAT_COUNT for this firmware). Returns the frame size, or 0 if
+// count is too large.
+static inline size_t mixer_encode_stats(uint8_t* out, uint8_t sequence, uint32_t timestamp_us, const uint32_t* stats, uint8_t count) {
+	if(count > MIXER_MAX_STATS) return 0;
+
+	uint8_t* payload = out + MIXER_OFFSET_PAYLOAD;
+	for(uint8_t i = 0; i < count; ++i) {
+		payload[i * MIXER_STATS_ENTRY_SIZE]		= (uint8_t)(stats[i] & 0xFF);
+		payload[i * MIXER_STATS_ENTRY_SIZE + 1] = (uint8_t)((stats[i] >> 8) & 0xFF);
+		payload[i * MIXER_STATS_ENTRY_SIZE + 2] = (uint8_t)((stats[i] >> 16) & 0xFF);
+		payload[i * MIXER_STATS_ENTRY_SIZE + 3] = (uint8_t)(stats[i] >> 24);
+	}
+	return mixer_finish_frame(out, sequence, MIXER_FRAME_STATS, count, timestamp_us, (size_t)count * MIXER_STATS_ENTRY_SIZE);
+}
+
+// Read the device timestamp of a frame that has passed the CRC check
+static inline uint32_t mixer_frame_timestamp(const uint8_t* frame) {
+	const uint8_t* p = frame + MIXER_OFFSET_TIMESTAMP;
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // MIXER_PROTOCOL_H